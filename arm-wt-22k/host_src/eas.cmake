@@ -35,6 +35,8 @@
 #ifndef _EAS_H
 #define _EAS_H
 
+#include <stdint.h>
+
 #include "eas_types.h"
 
 /* for C++ linkage */
@@ -42,6 +44,34 @@
 extern "C" {
 #endif
 
+/*----------------------------------------------------------------------------
+ * Threading
+ *----------------------------------------------------------------------------
+ * With the dynamic memory model the only mutable global state is the
+ * cache of DLS collections shared by EAS_LoadDLSCollection, which has its
+ * own lock. Every instance created by EAS_Init, EAS_InitArena or EAS_Clone
+ * owns the rest of its data, so independent instances may be used from
+ * different threads at the same time without locking.
+ *
+ * A single instance is not thread-safe. All calls on one instance, and on
+ * the streams opened on it, must be serialized by the caller. The
+ * exceptions are the EAS_Queue functions, which one control thread may
+ * call while another thread calls EAS_Render, EAS_PrefetchPCMStreams,
+ * which one I/O thread may call at the same time, and EAS_GetPCMUnderruns.
+ *
+ * A DLS collection shared through EAS_Clone or the DLS cache is read-only
+ * while rendering and its reference count is atomic, so instances sharing
+ * it may be shut down from any thread.
+ *
+ * EAS_Config may be called from any thread. The debug reporting settings
+ * in eas_report.h are process-wide and should only be changed while no
+ * other thread is using the library.
+ *
+ * The static memory model has a single set of instance data, so it
+ * supports only one instance per process.
+ *----------------------------------------------------------------------------
+*/
+
 /* library version macro */
 #define MAKE_LIB_VERSION(a,b,c,d) (((((((EAS_U32) a <<8) | (EAS_U32) b) << 8) | (EAS_U32) c) << 8) | (EAS_U32) d)
 #define LIB_VERSION MAKE_LIB_VERSION(@PROJECT_VERSION_MAJOR@,@PROJECT_VERSION_MINOR@,@PROJECT_VERSION_PATCH@,@PROJECT_VERSION_TWEAK@)
@@ -118,6 +148,88 @@ typedef enum
 */
 EAS_PUBLIC EAS_RESULT EAS_Init (EAS_DATA_HANDLE *ppEASData);
 
+/*----------------------------------------------------------------------------
+ * EAS_InitArena()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Initialize the synthesizer library like EAS_Init, but with all of the
+ * instance memory taken from one cache-line aligned arena. The arena is
+ * sized from the library configuration to hold every stream open at
+ * once, with PCM prefetch, every stem bus and output resampling enabled,
+ * and is released in a single call by EAS_Shutdown. Opening and closing
+ * files reuses arena blocks, so once this call returns the instance never
+ * touches the global heap.
+ *
+ * Allocations whose size depends on the content, such as DLS collections
+ * and the buffers behind stream locators, must fit in extraSize. When the
+ * arena is exhausted the call that needed memory fails with
+ * EAS_ERROR_MALLOC_FAILED. An extraSize that would take the arena past
+ * the range of an EAS_I32 is refused with EAS_ERROR_PARAMETER_RANGE.
+ *
+ * Inputs:
+ *  ppEASData       - pointer to data handle variable for this instance
+ *  extraSize       - bytes to reserve beyond the library's own needs
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_InitArena (EAS_DATA_HANDLE *ppEASData, EAS_I32 extraSize);
+
+/*----------------------------------------------------------------------------
+ * EAS_Clone()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Create a new instance that starts out configured like pTemplate: master
+ * volume, reverb and chorus settings, polyphony and the global sound
+ * libraries. The template's instance data is copied block by block and the
+ * pointers between blocks are rebuilt, which is much cheaper than running
+ * EAS_Init and repeating the configuration calls. A clone of an arena
+ * instance gets an arena of the same size.
+ *
+ * The template must not have any streams open. A DLS collection loaded
+ * with EAS_LoadDLSCollection is shared, not copied; if it lives in the
+ * template's arena the template must be shut down after all of its clones.
+ *
+ * Inputs:
+ *  pTemplate       - handle to the instance to copy
+ *  ppEASData       - pointer to data handle variable for the new instance
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_Clone (EAS_DATA_HANDLE pTemplate, EAS_DATA_HANDLE *ppEASData);
+
+/* EAS_Reset flags */
+#define EAS_RESET_KEEP_DLS      0x00000001
+
+/*----------------------------------------------------------------------------
+ * EAS_Reset()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Return an instance to the state it had after EAS_Init so it can be
+ * reused for another job. Open streams are closed, all voices are freed,
+ * the reverb and chorus revert to their default presets with cleared
+ * delay lines, and the master volume, polyphony, sound library and
+ * render time go back to their defaults. Nothing is freed or allocated
+ * except the memory owned by the closed streams, so the stem buses set
+ * with EAS_SetStemBuses are kept, with every channel of a new stream
+ * routed to its default bus.
+ *
+ * The global DLS collection is released unless flags include
+ * EAS_RESET_KEEP_DLS.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  flags           - EAS_RESET_xxx flags
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_Reset (EAS_DATA_HANDLE pEASData, EAS_I32 flags);
+
 /*----------------------------------------------------------------------------
  * EAS_Config()
  *----------------------------------------------------------------------------
@@ -168,6 +280,290 @@ EAS_PUBLIC EAS_RESULT EAS_Shutdown (EAS_DATA_HANDLE pEASData);
 */
 EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated);
 
+/* EAS_RenderEx flags */
+#define EAS_RENDER_SILENT       0x00000001
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderEx()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Same as EAS_Render, and also reports what was rendered. EAS_RENDER_SILENT
+ * is set when the buffer is all zeros because no voice or PCM stream was
+ * sounding and the reverb and chorus tails have died out. A reverb tail
+ * that stays near the noise floor for 100 ms is cleared rather than left
+ * to circulate at a few LSB.
+ * The caller may then skip encoding or mixing the buffer. Silent frames
+ * are produced with a fill, skipping the gain stage and the effects.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pOut            - output buffer pointer
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *  pFlags          - receives the EAS_RENDER flags
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderEx (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated, EAS_U32 *pFlags);
+
+/* EAS_RenderFormat output formats */
+#define EAS_FORMAT_PCM16        0
+#define EAS_FORMAT_INT32        1
+#define EAS_FORMAT_FLOAT32      2
+
+/* EAS_RenderMix only, 32-bit samples with full scale at 2^23 */
+#define EAS_FORMAT_INT32_MIX    3
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderFormat()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Same as EAS_Render, with a choice of output format. EAS_FORMAT_PCM16 is
+ * the EAS_PCM output of EAS_Render. EAS_FORMAT_INT32 writes 32-bit samples
+ * with full scale at 2^31, and EAS_FORMAT_FLOAT32 writes floats with full
+ * scale at 1.0 and no clipping. Both are converted from the internal mix
+ * with the master gain, without going through 16 bits, so they keep the
+ * low order bits and, for floats, the peaks past full scale. The reverb
+ * and chorus are computed at 16 bits and added to the mix.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pOut            - output buffer pointer, interleaved samples in the
+ *                    requested format
+ *  format          - EAS_FORMAT output format
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderFormat (EAS_DATA_HANDLE pEASData, void *pOut, EAS_I32 format, EAS_I32 numRequested, EAS_I32 *pNumGenerated);
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderPlanar()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Same as EAS_RenderFormat, with the left and right channels written to
+ * separate buffers instead of interleaved. The 32-bit formats are written
+ * by the master gain stage directly, there is no interleaved copy to split.
+ * Only available in stereo builds.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pLeft           - left channel output buffer pointer
+ *  pRight          - right channel output buffer pointer
+ *  format          - EAS_FORMAT output format
+ *  nNumRequested   - requested num samples to generate, per channel
+ *  pnNumGenerated  - actual number of samples generated, per channel
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderPlanar (EAS_DATA_HANDLE pEASData, void *pLeft, void *pRight, EAS_I32 format, EAS_I32 numRequested, EAS_I32 *pNumGenerated);
+
+/* EAS_RenderMix gains */
+#define EAS_MIX_UNITY_GAIN      32768
+#define EAS_MIX_MAX_GAIN        (4 * EAS_MIX_UNITY_GAIN)
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderMix()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Renders a buffer like EAS_RenderFormat, scales it by gain and adds it to
+ * an accumulation buffer instead of overwriting it. Several instances, or
+ * other sources, can be summed into one buffer this way, and the caller
+ * clips or converts it once at the end. EAS_FORMAT_FLOAT32 and
+ * EAS_FORMAT_INT32 buffers hold samples at the same scale as the output of
+ * EAS_RenderFormat, 1.0 and 2^31. EAS_FORMAT_INT32_MIX buffers hold
+ * samples with full scale at 2^23, leaving 8 bits of headroom for the sum.
+ * Both integer formats saturate at the 32-bit range. Silent buffers are
+ * not added at all.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pMix            - accumulation buffer pointer, interleaved samples in
+ *                    the requested format
+ *  format          - EAS_FORMAT_INT32, EAS_FORMAT_INT32_MIX or
+ *                    EAS_FORMAT_FLOAT32
+ *  gain            - gain, EAS_MIX_UNITY_GAIN is unity (0 to EAS_MIX_MAX_GAIN)
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderMix (EAS_DATA_HANDLE pEASData, void *pMix, EAS_I32 format, EAS_I32 gain, EAS_I32 numRequested, EAS_I32 *pNumGenerated);
+
+/* number of stem buses, and the bus for channels that only play in the mix */
+#define EAS_MAX_STEM_BUSES      16
+#define EAS_STEM_BUS_NONE       EAS_MAX_STEM_BUSES
+
+/*----------------------------------------------------------------------------
+ * EAS_SetStemBuses()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Enables stem rendering with numBuses stem buses. Each voice is mixed
+ * into the bus its MIDI channel is routed to, see EAS_SetChannelBus, and
+ * the buses are summed into the mix, so the output of EAS_Render does not
+ * change. By default channel n of every stream is routed to bus n.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  numBuses        - number of stem buses, 0 to disable stem rendering
+ *                    (the default)
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * Allocates numBuses mix buffers, after freeing the previous ones. If the
+ * allocation fails stem rendering is disabled.
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetStemBuses (EAS_DATA_HANDLE pEASData, EAS_I32 numBuses);
+
+/*----------------------------------------------------------------------------
+ * EAS_SetChannelBus()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Routes a MIDI channel of a stream to a stem bus. Several channels, of
+ * the same or of different streams, may share a bus. A channel routed to
+ * EAS_STEM_BUS_NONE, or to a bus past the number of buses, only plays in
+ * the mix.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  streamHandle    - handle to a MIDI stream or file
+ *  channel         - MIDI channel (0-15)
+ *  bus             - stem bus (0 to EAS_STEM_BUS_NONE)
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * Notes already playing move to the new bus.
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetChannelBus (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle, EAS_I32 channel, EAS_I32 bus);
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderStems()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Same as EAS_Render, and also writes each stem bus to its own buffer,
+ * with the master gain of the mix. The stems are dry: the reverb and
+ * chorus only process the mix, and so do PCM streams such as WAVE files.
+ * With the effects disabled the stems add up to the mix, within a few LSB
+ * of rounding.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  pOut            - output buffer pointer for the mix
+ *  ppStems         - one output buffer pointer per stem bus, each the size
+ *                    of pOut. A NULL pointer skips that stem.
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderStems (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_PCM * const *ppStems, EAS_I32 numRequested, EAS_I32 *pNumGenerated);
+
+/* highest sample rate for EAS_SetOutputSampleRate */
+#define EAS_MAX_OUTPUT_SAMPLE_RATE      192000
+
+/*----------------------------------------------------------------------------
+ * EAS_SetOutputSampleRate()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sets the sample rate EAS_Render writes, for audio devices that do not
+ * run at the compiled sample rate (see EAS_Config). The synthesizer keeps
+ * rendering at the compiled rate and a polyphase resampler converts its
+ * output, so the host does not need a resampling pass of its own. Each
+ * call to EAS_Render still writes mixBufferSize frames, which now last
+ * less time, and renders a buffer at the compiled rate only when the
+ * resampler needs more input. EAS_RenderFormat, EAS_RenderMix and
+ * EAS_RenderPlanar are resampled too, the 32-bit formats at full
+ * precision; the stems are only available at the compiled rate. Call it
+ * after EAS_Init, before rendering; changing the rate discards the
+ * buffered input.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  sampleRate      - output sample rate in Hz, from the compiled rate to
+ *                    EAS_MAX_OUTPUT_SAMPLE_RATE, such as 48000 or 96000.
+ *                    The compiled rate turns the resampler off.
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * Allocates the resampler.
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetOutputSampleRate (EAS_DATA_HANDLE pEASData, EAS_I32 sampleRate);
+
+/*----------------------------------------------------------------------------
+ * EAS_GetOutputSampleRate()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the sample rate EAS_Render writes.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *
+ * Outputs:
+ *  Output sample rate in Hz
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_I32 EAS_GetOutputSampleRate (EAS_DATA_HANDLE pEASData);
+
+/* EAS_SetOfflineMode tail levels, in dB below full scale */
+#define EAS_OFFLINE_TAIL_LEVEL_MIN      1
+#define EAS_OFFLINE_TAIL_LEVEL_MAX      96
+#define EAS_OFFLINE_TAIL_LEVEL_DEFAULT  60
+
+/*----------------------------------------------------------------------------
+ * EAS_SetOfflineMode()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Enables the offline render mode, meant for rendering files to disk
+ * rather than playing them in real time. The silence before the first
+ * note is skipped: EAS_Render parses on through it without rendering, so
+ * the first buffer returned after EAS_Prepare holds the first note. Once
+ * the parser has reached the end of the file, the release tails are muted
+ * as soon as every voice has faded below tailLevel, and EAS_State reports
+ * EAS_STATE_STOPPED only after the reverb and chorus tails have also
+ * faded below it. The render time includes the skipped frames.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  offline         - EAS_TRUE for offline rendering, EAS_FALSE to play
+ *                    the file as written (the default)
+ *  tailLevel       - level in dB below full scale at which tails end,
+ *                    see EAS_OFFLINE_TAIL_LEVEL_DEFAULT
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * Leading silence is only skipped for streams prepared after the call.
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetOfflineMode (EAS_DATA_HANDLE pEASData, EAS_BOOL offline, EAS_I32 tailLevel);
+
 /*----------------------------------------------------------------------------
  * EAS_SetRepeat()
  *----------------------------------------------------------------------------
@@ -442,6 +838,34 @@ EAS_PUBLIC EAS_I32 EAS_GetVolume (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHan
 */
 EAS_PUBLIC EAS_RESULT EAS_SetMaxLoad (EAS_DATA_HANDLE pEASData, EAS_I32 maxLoad);
 
+/* EAS_SetVoiceCullLevel levels, in dB below full scale */
+#define EAS_VOICE_CULL_LEVEL_OFF        0
+#define EAS_VOICE_CULL_LEVEL_MAX        96
+
+/*----------------------------------------------------------------------------
+ * EAS_SetVoiceCullLevel()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sets the level below which voices are not synthesized. A voice whose
+ * gain stays below cullLevel for a whole update period keeps advancing
+ * its phase, envelopes and LFOs but is neither interpolated, filtered nor
+ * mixed, and resumes full synthesis as soon as its gain rises again.
+ * This saves most of the cost of long release tails and of voices held
+ * at a low volume, at the price of output that is no longer bit-exact.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  cullLevel       - level in dB below full scale, EAS_VOICE_CULL_LEVEL_OFF
+ *                    to synthesize every voice (the default)
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetVoiceCullLevel (EAS_DATA_HANDLE pEASData, EAS_I32 cullLevel);
+
 /*----------------------------------------------------------------------------
  * EAS_SetMaxPCMStreams()
  *----------------------------------------------------------------------------
@@ -456,6 +880,65 @@ EAS_PUBLIC EAS_RESULT EAS_SetMaxLoad (EAS_DATA_HANDLE pEASData, EAS_I32 maxLoad)
 */
 EAS_PUBLIC EAS_RESULT EAS_SetMaxPCMStreams (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, EAS_I32 maxNumStreams);
 
+/*----------------------------------------------------------------------------
+ * EAS_SetPCMPrefetch()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Moves the file reads of linear PCM streams off the thread that calls
+ * EAS_Render. While enabled, each stream keeps two buffers read ahead of
+ * its play position, including the rewind to the loop start, and the
+ * render thread only copies out buffers that are ready. The reads are
+ * done by the host, which calls EAS_PrefetchPCMStreams from an I/O thread.
+ *
+ * When a buffer is not ready in time the stream is silent until it is
+ * and the underrun is counted, see EAS_GetPCMUnderruns. A stream that is
+ * restarted inside EAS_Render, as a repeating file is, may underrun once
+ * at the restart. Streams that a parser continues through a callback
+ * are always read synchronously.
+ *
+ * Must be called while no PCM stream is open and while the I/O thread is
+ * not running. Each prefetched stream uses one extra file handle. Closing
+ * a stream does not wait for a read in progress, its extra handle stays
+ * open until a later EAS_Render finds the read finished.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * enable           - EAS_TRUE to read ahead, EAS_FALSE to read synchronously (the default)
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetPCMPrefetch (EAS_DATA_HANDLE pEASData, EAS_BOOL enable);
+
+/*----------------------------------------------------------------------------
+ * EAS_PrefetchPCMStreams()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reads the buffers the PCM streams have asked for. Call it from a single
+ * I/O thread, for example in a loop that sleeps for a fraction of a
+ * render buffer whenever no buffer was read. It may run concurrently
+ * with the calls of the render thread, so the readAt and size callbacks
+ * of the file locator must be safe to call from two threads at once.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pNumReads        - pointer to variable to receive the number of buffers read
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PrefetchPCMStreams (EAS_DATA_HANDLE pEASData, EAS_I32 *pNumReads);
+
+/*----------------------------------------------------------------------------
+ * EAS_GetPCMUnderruns()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the number of times a prefetched PCM stream ran out of data
+ * during a call to EAS_Render. May be called from any thread.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pUnderruns       - pointer to variable to receive the count
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_GetPCMUnderruns (EAS_DATA_HANDLE pEASData, EAS_U32 *pUnderruns);
+
 /*----------------------------------------------------------------------------
  * EAS_OpenFile()
  *----------------------------------------------------------------------------
@@ -476,6 +959,107 @@ EAS_PUBLIC EAS_RESULT EAS_SetMaxPCMStreams (EAS_DATA_HANDLE pEASData, EAS_HANDLE
 */
 EAS_PUBLIC EAS_RESULT EAS_OpenFile (EAS_DATA_HANDLE pEASData, EAS_FILE_LOCATOR locator, EAS_HANDLE *pStreamHandle);
 
+/*----------------------------------------------------------------------------
+ * EAS_OpenStreamLocator()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Creates a file locator for a sequential, non-seekable source such as a
+ * pipe or a socket, to be passed to EAS_OpenFile. The parsers need random
+ * access, so the source is read only once, on demand, into a growable
+ * buffer that keeps everything received so far. Playback starts as soon as
+ * the data the parser needs has arrived: a type 0 MIDI file starts
+ * rendering while it is still being received, while a type 1 file needs
+ * all of its track headers first.
+ *
+ * The read function returns the number of bytes stored in buf (at most
+ * size), or 0 or a negative value at the end of the source. It is called
+ * from EAS_OpenFile and EAS_Render, and may block until data is available.
+ * EAS_ParseMetaData reads the whole source before returning.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - source handle passed to the read function
+ * read             - read function
+ * pLocator         - pointer to variable to receive the locator
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_OpenStreamLocator (EAS_DATA_HANDLE pEASData, void *handle, int (*read)(void *handle, void *buf, int size), EAS_FILE_LOCATOR *pLocator);
+
+/*----------------------------------------------------------------------------
+ * EAS_CloseStreamLocator()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Frees a locator created by EAS_OpenStreamLocator and the data buffered
+ * for it. Close the stream opened with the locator first.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * locator          - locator to free
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_CloseStreamLocator (EAS_DATA_HANDLE pEASData, EAS_FILE_LOCATOR locator);
+
+/*----------------------------------------------------------------------------
+ * EAS_OpenMemoryLocator()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Creates a file locator for a file held in memory, to be passed to
+ * EAS_OpenFile, EAS_LoadDLSCollection or any other function taking a
+ * locator. The data is not copied: it must stay valid and unchanged until
+ * the file opened with the locator is closed. A file mapped with mmap (or
+ * MapViewOfFile) can be passed directly. Linear PCM samples of WAVE files
+ * are then converted straight from the mapped data instead of being read
+ * through the locator, and such streams are not read ahead by
+ * EAS_PrefetchPCMStreams since there is no I/O to hide.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pData            - file data
+ * size             - size of the file data in bytes
+ * pLocator         - pointer to variable to receive the locator
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_OpenMemoryLocator (EAS_DATA_HANDLE pEASData, const void *pData, EAS_I32 size, EAS_FILE_LOCATOR *pLocator);
+
+/*----------------------------------------------------------------------------
+ * EAS_CloseMemoryLocator()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Frees a locator created by EAS_OpenMemoryLocator. Close the stream
+ * opened with the locator first. The file data belongs to the caller and
+ * may be released or unmapped afterwards.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * locator          - locator to free
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_CloseMemoryLocator (EAS_DATA_HANDLE pEASData, EAS_FILE_LOCATOR locator);
+
 #ifdef MMAPI_SUPPORT
 /*----------------------------------------------------------------------------
  * EAS_MMAPIToneControl()
@@ -685,6 +1269,33 @@ EAS_PUBLIC EAS_RESULT EAS_OpenMIDIStream (EAS_DATA_HANDLE pEASData, EAS_HANDLE *
 */
 EAS_PUBLIC EAS_RESULT EAS_WriteMIDIStream(EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle, EAS_U8 *pBuffer, EAS_I32 count);
 
+/*----------------------------------------------------------------------------
+ * EAS_WriteMIDIMessages()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Send complete channel messages to the MIDI stream device, bypassing the
+ * byte-oriented parser used by EAS_WriteMIDIStream. Each message is packed
+ * in a 32-bit word laid out like a MIDI 1.0 channel voice Universal MIDI
+ * Packet: status byte in bits 16-23, first data byte in bits 8-15 and
+ * second data byte in bits 0-7. Bits 24-31 are ignored, so UMP words can
+ * be passed unchanged. Running status is not used, and system messages
+ * (including SysEx) are ignored; use EAS_WriteMIDIStream for those.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * streamHandle     - stream handle
+ * pMessages        - pointer to packed messages
+ * count            - number of messages to write
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_WriteMIDIMessages (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle, const uint32_t *pMessages, EAS_I32 count);
+
 /*----------------------------------------------------------------------------
  * EAS_CloseMIDIStream()
  *----------------------------------------------------------------------------
@@ -704,6 +1315,35 @@ EAS_PUBLIC EAS_RESULT EAS_WriteMIDIStream(EAS_DATA_HANDLE pEASData, EAS_HANDLE s
 */
 EAS_PUBLIC EAS_RESULT EAS_CloseMIDIStream (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle);
 
+/*----------------------------------------------------------------------------
+ * EAS_QueueMIDIStream()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Queue data for the MIDI stream device. Unlike EAS_WriteMIDIStream, this
+ * function may be called from a control thread while another thread is
+ * inside EAS_Render. The queue is wait-free and has a single producer:
+ * only one thread at a time may call the EAS_Queue functions for a given
+ * EAS instance. Queued data is delivered at the start of the next
+ * EAS_Render call; data queued for a stream that has since been closed
+ * is discarded, even if the handle has been reused for a new stream.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * streamHandle     - stream handle
+ * pBuffer          - pointer to buffer
+ * count            - number of bytes to write
+ *
+ * Outputs:
+ * EAS_ERROR_QUEUE_IS_FULL if the data does not fit in the queue, or
+ * EAS_ERROR_PARAMETER_RANGE if it is larger than the whole queue and never
+ * will; nothing is queued in either case.
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_QueueMIDIStream (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle, EAS_U8 *pBuffer, EAS_I32 count);
+
 /*----------------------------------------------------------------------------
  * EAS_Locate()
  *----------------------------------------------------------------------------
@@ -849,12 +1489,60 @@ EAS_PUBLIC EAS_RESULT EAS_GetParameter (EAS_DATA_HANDLE pEASData, EAS_I32 module
  *
  *
  * Side Effects:
- *
+ * The reverb and chorus allocate their delay lines when their bypass is
+ * first turned off, which fails with EAS_ERROR_MALLOC_FAILED if memory
+ * is short. The delay lines are freed again once the effect has been
+ * bypassed for EAS_PARAM_REVERB_IDLE_TIME or EAS_PARAM_CHORUS_IDLE_TIME
+ * milliseconds.
  *
  *----------------------------------------------------------------------------
 */
 EAS_PUBLIC EAS_RESULT EAS_SetParameter (EAS_DATA_HANDLE pEASData, EAS_I32 module, EAS_I32 param, EAS_I32 value);
 
+/*----------------------------------------------------------------------------
+ * EAS_QueueParameter()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Queued version of EAS_SetParameter. The change is applied at the start
+ * of the next EAS_Render call, so it is safe to call from the thread that
+ * calls EAS_QueueMIDIStream. Queued parameter changes are applied before
+ * queued MIDI data.
+ *
+ * Inputs:
+ * psEASData        - pointer to overall EAS data structure
+ * module           - enumerated module number
+ * param            - enumerated parameter number
+ * value            - new parameter value
+ *
+ * Outputs:
+ * EAS_ERROR_QUEUE_IS_FULL if the parameter queue is full
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_QueueParameter (EAS_DATA_HANDLE pEASData, EAS_I32 module, EAS_I32 param, EAS_I32 value);
+
+/*----------------------------------------------------------------------------
+ * EAS_QueueVolume()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Queued version of EAS_SetVolume, see EAS_QueueParameter.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * streamHandle     - file or stream handle, NULL for master volume
+ * volume           - the desired gain (100 is max)
+ *
+ * Outputs:
+ * EAS_ERROR_QUEUE_IS_FULL if the parameter queue is full
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_QueueVolume (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle, EAS_I32 volume);
+
 #ifdef _METRICS_ENABLED
 /*----------------------------------------------------------------------------
  * EAS_MetricsReport()
@@ -953,6 +1641,13 @@ EAS_PUBLIC EAS_RESULT EAS_SetPlayMode (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStr
  * Purpose:
  * Downloads a DLS collection
  *
+ * Collections are shared by all instances in the process: loading a file
+ * whose size and content match a collection that is already loaded only
+ * adds a reference to it, so the bank is parsed and stored once. The
+ * collection is freed when the last instance using it releases it.
+ * Instances created with EAS_InitArena always parse a private copy into
+ * their arena.
+ *
  * Inputs:
  * pEASData             - instance data handle
  * streamHandle         - file or stream handle
@@ -38,7 +38,8 @@ typedef enum
     EAS_PARAM_CHORUS_PRESET,
     EAS_PARAM_CHORUS_RATE,
     EAS_PARAM_CHORUS_DEPTH,
-    EAS_PARAM_CHORUS_LEVEL
+    EAS_PARAM_CHORUS_LEVEL,
+    EAS_PARAM_CHORUS_IDLE_TIME      /* ms bypassed before the delay lines are freed, 0 keeps them */
 } E_CHORUS_PARAMS;
 
 typedef enum
@@ -46,10 +46,6 @@ extern "C" {
 extern EAS_RESULT EAS_HWInit(EAS_HW_DATA_HANDLE *hwInstData);
 extern EAS_RESULT EAS_HWShutdown(EAS_HW_DATA_HANDLE hwInstData);
 
-/* threading */
-extern void* EAS_HWRegisterSignalHandler();
-extern EAS_RESULT EAS_HWUnRegisterSignalHandler(void *cookie);
-
 /* memory functions */
 extern void *EAS_HWMemSet(void *s, int c, EAS_I32 n);
 extern void *EAS_HWMemCpy(void *s1, const void *s2, EAS_I32 n);
@@ -59,6 +55,12 @@ extern EAS_I32 EAS_HWMemCmp(const void *s1, const void *s2, EAS_I32 n);
 extern void *EAS_HWMalloc(EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size);
 extern void EAS_HWFree(EAS_HW_DATA_HANDLE hwInstData, void *p);
 
+/* per-instance arena, blocks are cache-line aligned and carry a one line header */
+#define EAS_HW_ARENA_ALIGN              64
+#define EAS_HW_ARENA_BLOCK_SIZE(size)   (((((EAS_I32) (size)) + EAS_HW_ARENA_ALIGN - 1) & ~(EAS_HW_ARENA_ALIGN - 1)) + EAS_HW_ARENA_ALIGN)
+extern EAS_RESULT EAS_HWInitArena(EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size);
+extern EAS_I32 EAS_HWArenaSize(EAS_HW_DATA_HANDLE hwInstData);
+
 /* file I/O */
 extern EAS_RESULT EAS_HWOpenFile(EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_LOCATOR locator, EAS_FILE_HANDLE *pFile, EAS_FILE_MODE mode);
 extern EAS_RESULT EAS_HWReadFile(EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file, void *pBuffer, EAS_I32 n, EAS_I32 *pBytesRead);
@@ -72,6 +74,16 @@ extern EAS_RESULT EAS_HWFileLength (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HAND
 extern EAS_RESULT EAS_HWDupHandle (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file, EAS_FILE_HANDLE* pFile);
 extern EAS_RESULT EAS_HWCloseFile (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file);
 
+/* files held in memory, e.g. mapped with mmap, which the library may read in place */
+typedef struct eas_hw_memory_file_tag
+{
+    EAS_FILE locator;
+    const EAS_U8 *pData;
+    EAS_I32 size;
+} EAS_HW_MEMORY_FILE;
+extern void EAS_HWInitMemoryFile (EAS_HW_MEMORY_FILE *pMemFile, const void *pData, EAS_I32 size);
+extern EAS_RESULT EAS_HWMapFile (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file, const EAS_U8 **ppData, EAS_I32 *pSize);
+
 /* vibrate, LED, and backlight functions */
 extern EAS_RESULT EAS_HWVibrate(EAS_HW_DATA_HANDLE hwInstData, EAS_BOOL state);
 extern EAS_RESULT EAS_HWLED(EAS_HW_DATA_HANDLE hwInstData, EAS_BOOL state);
@@ -52,8 +52,6 @@
 #include <fcntl.h>
 #include <limits.h>
 #include <errno.h>
-#include <signal.h>
-#include <pthread.h>
 #include <media/MediaPlayerInterface.h>
 #endif
 
@@ -88,15 +86,31 @@ typedef struct eas_hw_file_tag
     int (*size)(void *handle);
     int filePos;
     void *handle;
+    const EAS_U8 *pData;    /* file contents if held in memory */
 } EAS_HW_FILE;
 
+/*
+ * Optional per-instance arena. When present, EAS_HWMalloc carves
+ * cache-line aligned blocks out of it instead of calling malloc.
+ * Every block is preceded by a header of EAS_HW_ARENA_ALIGN bytes and
+ * blocks are kept in address order, so a freed block can be merged
+ * with its free neighbours and reused by the next allocation.
+ */
+typedef struct eas_hw_arena_block_tag
+{
+    EAS_I32 size;           /* block size, including the header */
+    EAS_I32 prevSize;       /* size of the preceding block, 0 for the first block */
+    EAS_BOOL inUse;
+} EAS_HW_ARENA_BLOCK;
+
 typedef struct eas_hw_inst_data_tag
 {
     EAS_HW_FILE files[EAS_MAX_FILE_HANDLES];
+    void *pArenaAlloc;      /* arena as returned by malloc */
+    EAS_U8 *pArena;         /* first aligned block */
+    EAS_I32 arenaSize;
 } EAS_HW_INST_DATA;
 
-pthread_key_t EAS_sigbuskey;
-
 /*----------------------------------------------------------------------------
  * EAS_HWInit
  *
@@ -137,10 +151,136 @@ EAS_RESULT EAS_HWInit (EAS_HW_DATA_HANDLE *pHWInstData)
 EAS_RESULT EAS_HWShutdown (EAS_HW_DATA_HANDLE hwInstData)
 {
 
+    free(hwInstData->pArenaAlloc);
     free(hwInstData);
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_HWInitArena
+ *
+ * Allocate the arena that serves all later EAS_HWMalloc calls
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_HWInitArena (EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size)
+{
+    EAS_HW_ARENA_BLOCK *pBlock;
+
+    if ((hwInstData->pArena != NULL) || (size < EAS_HW_ARENA_BLOCK_SIZE(1)))
+        return EAS_ERROR_INVALID_PARAMETER;
+
+    /* round down to whole lines and leave room to align the start */
+    size &= ~(EAS_HW_ARENA_ALIGN - 1);
+    hwInstData->pArenaAlloc = malloc((size_t) size + EAS_HW_ARENA_ALIGN - 1);
+    if (hwInstData->pArenaAlloc == NULL)
+        return EAS_ERROR_MALLOC_FAILED;
+    hwInstData->pArena = (EAS_U8*) (((EAS_UINTPTR) hwInstData->pArenaAlloc + EAS_HW_ARENA_ALIGN - 1) & ~(EAS_UINTPTR) (EAS_HW_ARENA_ALIGN - 1));
+    hwInstData->arenaSize = size;
+
+    /* the whole arena starts out as a single free block */
+    pBlock = (EAS_HW_ARENA_BLOCK*) hwInstData->pArena;
+    pBlock->size = size;
+    pBlock->prevSize = 0;
+    pBlock->inUse = EAS_FALSE;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_HWArenaSize
+ *
+ * Returns the size of the arena, 0 if allocations come from the heap
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_I32 EAS_HWArenaSize (EAS_HW_DATA_HANDLE hwInstData)
+{
+    return hwInstData->arenaSize;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_HWArenaMalloc
+ *
+ * First fit allocation from the arena
+ *
+ *----------------------------------------------------------------------------
+*/
+static void *EAS_HWArenaMalloc (EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size)
+{
+    EAS_HW_ARENA_BLOCK *pBlock;
+    EAS_HW_ARENA_BLOCK *pNext;
+    EAS_U8 *pEnd;
+
+    if (size > hwInstData->arenaSize)
+        return NULL;
+    size = EAS_HW_ARENA_BLOCK_SIZE(size);
+
+    pEnd = hwInstData->pArena + hwInstData->arenaSize;
+    for (pBlock = (EAS_HW_ARENA_BLOCK*) hwInstData->pArena; (EAS_U8*) pBlock < pEnd; pBlock = (EAS_HW_ARENA_BLOCK*) ((EAS_U8*) pBlock + pBlock->size))
+    {
+        if (pBlock->inUse || (pBlock->size < size))
+            continue;
+
+        /* split off the remainder if it can hold another block */
+        if (pBlock->size - size >= EAS_HW_ARENA_BLOCK_SIZE(1))
+        {
+            pNext = (EAS_HW_ARENA_BLOCK*) ((EAS_U8*) pBlock + size);
+            pNext->size = pBlock->size - size;
+            pNext->prevSize = size;
+            pNext->inUse = EAS_FALSE;
+            pBlock->size = size;
+
+            /* fix the back link of the block after the remainder */
+            size = pNext->size;
+            pNext = (EAS_HW_ARENA_BLOCK*) ((EAS_U8*) pNext + size);
+            if ((EAS_U8*) pNext < pEnd)
+                pNext->prevSize = size;
+        }
+        pBlock->inUse = EAS_TRUE;
+        return (EAS_U8*) pBlock + EAS_HW_ARENA_ALIGN;
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_HWArenaFree
+ *
+ * Returns a block to the arena, merging it with free neighbours
+ *
+ *----------------------------------------------------------------------------
+*/
+static void EAS_HWArenaFree (EAS_HW_DATA_HANDLE hwInstData, void *p)
+{
+    EAS_HW_ARENA_BLOCK *pBlock;
+    EAS_HW_ARENA_BLOCK *pNext;
+    EAS_U8 *pEnd;
+
+    pEnd = hwInstData->pArena + hwInstData->arenaSize;
+    pBlock = (EAS_HW_ARENA_BLOCK*) ((EAS_U8*) p - EAS_HW_ARENA_ALIGN);
+    pBlock->inUse = EAS_FALSE;
+
+    /* merge with the following block */
+    pNext = (EAS_HW_ARENA_BLOCK*) ((EAS_U8*) pBlock + pBlock->size);
+    if (((EAS_U8*) pNext < pEnd) && !pNext->inUse)
+        pBlock->size += pNext->size;
+
+    /* merge with the preceding block */
+    if (pBlock->prevSize)
+    {
+        EAS_HW_ARENA_BLOCK *pPrev = (EAS_HW_ARENA_BLOCK*) ((EAS_U8*) pBlock - pBlock->prevSize);
+        if (!pPrev->inUse)
+        {
+            pPrev->size += pBlock->size;
+            pBlock = pPrev;
+        }
+    }
+
+    /* fix the back link of the block after the merged one */
+    pNext = (EAS_HW_ARENA_BLOCK*) ((EAS_U8*) pBlock + pBlock->size);
+    if ((EAS_U8*) pNext < pEnd)
+        pNext->prevSize = pBlock->size;
+}
+
 /*----------------------------------------------------------------------------
  *
  * EAS_HWMalloc
@@ -156,6 +296,8 @@ void *EAS_HWMalloc (EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size)
      * negative or 0 values through */
     if (size <= 0)
       return NULL;
+    if (hwInstData && hwInstData->pArena)
+        return EAS_HWArenaMalloc(hwInstData, size);
     return malloc((size_t) size);
 }
 
@@ -170,6 +312,12 @@ void *EAS_HWMalloc (EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size)
 /*lint -esym(715, hwInstData) hwInstData available for customer use */
 void EAS_HWFree (EAS_HW_DATA_HANDLE hwInstData, void *p)
 {
+    /* memory shared with another instance may come from elsewhere */
+    if (hwInstData && hwInstData->pArena && ((EAS_U8*) p >= hwInstData->pArena) && ((EAS_U8*) p < hwInstData->pArena + hwInstData->arenaSize))
+    {
+        EAS_HWArenaFree(hwInstData, p);
+        return;
+    }
     free(p);
 }
 
@@ -224,6 +372,57 @@ EAS_I32 EAS_HWMemCmp (const void *s1, const void *s2, EAS_I32 amount)
     return (EAS_I32) memcmp(s1, s2, (size_t) amount);
 }
 
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWMemoryReadAt
+ *
+ * readAt callback of a file held in memory
+ *
+ *----------------------------------------------------------------------------
+*/
+static int EAS_HWMemoryReadAt (void *handle, void *buf, int offset, int size)
+{
+    EAS_HW_MEMORY_FILE *pMemFile = (EAS_HW_MEMORY_FILE*) handle;
+
+    if ((offset < 0) || (size <= 0) || (offset >= pMemFile->size))
+        return 0;
+    if (size > pMemFile->size - offset)
+        size = (int) (pMemFile->size - offset);
+    EAS_HWMemCpy(buf, pMemFile->pData + offset, size);
+    return size;
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWMemorySize
+ *
+ * size callback of a file held in memory
+ *
+ *----------------------------------------------------------------------------
+*/
+static int EAS_HWMemorySize (void *handle)
+{
+    return (int) ((EAS_HW_MEMORY_FILE*) handle)->size;
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWInitMemoryFile
+ *
+ * Sets up a locator for size bytes of file data at pData. The data must
+ * remain valid and unchanged while the file is open.
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_HWInitMemoryFile (EAS_HW_MEMORY_FILE *pMemFile, const void *pData, EAS_I32 size)
+{
+    pMemFile->pData = (const EAS_U8*) pData;
+    pMemFile->size = size;
+    pMemFile->locator.handle = pMemFile;
+    pMemFile->locator.readAt = EAS_HWMemoryReadAt;
+    pMemFile->locator.size = EAS_HWMemorySize;
+}
+
 /*----------------------------------------------------------------------------
  *
  * EAS_HWOpenFile
@@ -256,6 +455,9 @@ EAS_RESULT EAS_HWOpenFile (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_LOCATOR locat
             file->readAt = locator->readAt;
             file->size = locator->size;
             file->filePos = 0;
+            file->pData = NULL;
+            if (locator->readAt == EAS_HWMemoryReadAt)
+                file->pData = ((EAS_HW_MEMORY_FILE*) locator->handle)->pData;
             *pFile = file;
             return EAS_SUCCESS;
         }
@@ -455,6 +657,51 @@ EAS_RESULT EAS_HWFileSeekOfs (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fil
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWFileLength
+ *
+ * Return the file length
+ *
+ *----------------------------------------------------------------------------
+*/
+/*lint -esym(715, hwInstData) hwInstData available for customer use */
+EAS_RESULT EAS_HWFileLength (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file, EAS_I32 *pLength)
+{
+
+    /* make sure we have a valid handle */
+    if (file->handle == NULL)
+        return EAS_ERROR_INVALID_HANDLE;
+
+    *pLength = file->size(file->handle);
+    return EAS_SUCCESS;
+}
+
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWMapFile
+ *
+ * Returns the contents of a file opened from an EAS_HW_MEMORY_FILE, so the
+ * caller can read it in place. Other files cannot be mapped.
+ *
+ *----------------------------------------------------------------------------
+*/
+/*lint -esym(715, hwInstData) hwInstData available for customer use */
+EAS_RESULT EAS_HWMapFile (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file, const EAS_U8 **ppData, EAS_I32 *pSize)
+{
+
+    /* make sure we have a valid handle */
+    if (file->handle == NULL)
+        return EAS_ERROR_INVALID_HANDLE;
+
+    if (file->pData == NULL)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+
+    *ppData = file->pData;
+    *pSize = file->size(file->handle);
+    return EAS_SUCCESS;
+}
 
 /*----------------------------------------------------------------------------
  *
@@ -485,6 +732,7 @@ EAS_RESULT EAS_HWDupHandle (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file,
             dupFile->filePos = file->filePos;
             dupFile->readAt = file->readAt;
             dupFile->size = file->size;
+            dupFile->pData = file->pData;
 
             *pDupFile = dupFile;
             return EAS_SUCCESS;
@@ -38,16 +38,17 @@
 
 #include "eas_report.h"
 
+/* process-wide settings, change them only while no other thread is using the library */
 static int severityLevel = 9999;
 
 /* debug file */
 static FILE *debugFile = NULL;
-int flush = 0;
+static int flush = 0;
 
 #ifndef _NO_DEBUG_PREPROCESSOR
 
 /* structure should have an #include for each error message header file */
-S_DEBUG_MESSAGES debugMessages[] =
+static const S_DEBUG_MESSAGES debugMessages[] =
 {
 #ifndef UNIFIED_DEBUG_MESSAGES
 #include "eas_config_msgs.h"
@@ -38,7 +38,8 @@ typedef enum
     EAS_PARAM_REVERB_BYPASS,
     EAS_PARAM_REVERB_PRESET,
     EAS_PARAM_REVERB_WET,
-    EAS_PARAM_REVERB_DRY
+    EAS_PARAM_REVERB_DRY,
+    EAS_PARAM_REVERB_IDLE_TIME      /* ms bypassed before the delay line is freed, 0 keeps it */
 } E_REVERB_PARAMS;
 
 
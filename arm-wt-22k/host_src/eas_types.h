@@ -35,6 +35,8 @@
 #ifndef _EAS_TYPES_H
 #define _EAS_TYPES_H
 
+#include <stdint.h>
+
 /* EAS_RESULT return codes */
 typedef long EAS_RESULT;
 #define EAS_SUCCESS                         0
@@ -127,13 +129,12 @@ typedef char EAS_CHAR;
 typedef unsigned short EAS_U16;
 typedef short EAS_I16;
 
-#if defined(_WIN64)
-typedef unsigned long long EAS_U32;
-typedef long long EAS_I32;
-#else
-typedef unsigned long EAS_U32;
-typedef long EAS_I32;
-#endif
+typedef uint32_t EAS_U32;
+typedef int32_t EAS_I32;
+
+/* integers wide enough to carry a pointer */
+typedef intptr_t EAS_INTPTR;
+typedef uintptr_t EAS_UINTPTR;
 
 typedef unsigned EAS_UINT;
 typedef int EAS_INT;
@@ -0,0 +1,60 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_atomic.h
+ *
+ * Contents and purpose:
+ * Atomic operations on EAS_UINT values shared between threads.
+ *
+ * Copyright (c) 2024 Pedro López-Cabanillas
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#ifndef _EAS_ATOMIC_H
+#define _EAS_ATOMIC_H
+
+#include "eas_types.h"
+
+/*
+ * The values are EAS_UINT so the MSVC interlocked intrinsics can operate
+ * on them. Increment and decrement return the new value, exchange returns
+ * the old value, compare-exchange returns non-zero if it stored the value.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define EAS_AtomicLoadAcquire(p)        __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define EAS_AtomicStoreRelease(p, v)    __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define EAS_AtomicIncrement(p)          __atomic_add_fetch((p), 1, __ATOMIC_ACQ_REL)
+#define EAS_AtomicDecrement(p)          __atomic_sub_fetch((p), 1, __ATOMIC_ACQ_REL)
+#define EAS_AtomicExchange(p, v)        __atomic_exchange_n((p), (v), __ATOMIC_ACQUIRE)
+
+/* a function, so the expected value has an address for the builtin to write back to */
+EAS_INLINE EAS_BOOL EAS_AtomicCompareExchange (volatile EAS_UINT *p, EAS_UINT e, EAS_UINT v)
+{
+    return __atomic_compare_exchange_n(p, &e, v, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) ? EAS_TRUE : EAS_FALSE;
+}
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define EAS_AtomicLoadAcquire(p)        ((EAS_UINT) _InterlockedOr((volatile long*) (p), 0))
+#define EAS_AtomicStoreRelease(p, v)    ((void) _InterlockedExchange((volatile long*) (p), (long) (v)))
+#define EAS_AtomicIncrement(p)          ((EAS_UINT) _InterlockedIncrement((volatile long*) (p)))
+#define EAS_AtomicDecrement(p)          ((EAS_UINT) _InterlockedDecrement((volatile long*) (p)))
+#define EAS_AtomicExchange(p, v)        ((EAS_UINT) _InterlockedExchange((volatile long*) (p), (long) (v)))
+#define EAS_AtomicCompareExchange(p, e, v)  (_InterlockedCompareExchange((volatile long*) (p), (long) (v), (long) (e)) == (long) (e))
+#else
+#error "No atomic primitives available for this compiler"
+#endif
+
+#endif /* _EAS_ATOMIC_H */
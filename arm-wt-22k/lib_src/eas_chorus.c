@@ -43,6 +43,13 @@ static void ChorusProcess (EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst,
 static EAS_RESULT ChorusShutdown (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pInstData);
 static EAS_RESULT ChorusGetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue);
 static EAS_RESULT ChorusSetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value);
+static void ChorusReset (EAS_VOID_PTR pInstData);
+static EAS_RESULT ChorusClone (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pSrcData, EAS_VOID_PTR *pInstData);
+static EAS_BOOL ChorusIsSilent (EAS_VOID_PTR pInstData);
+
+#ifdef _STATIC_MEMORY
+extern EAS_PCM eas_ChorusDelayLines[];
+#endif
 
 /* common effects interface for configuration module */
 const S_EFFECTS_INTERFACE EAS_Chorus =
@@ -51,7 +58,12 @@ const S_EFFECTS_INTERFACE EAS_Chorus =
     ChorusProcess,
     ChorusShutdown,
     ChorusGetParam,
-    ChorusSetParam
+    ChorusSetParam,
+    ChorusReset,
+    ChorusClone,
+    ChorusIsSilent,
+    sizeof(S_CHORUS_OBJECT),
+    (CHORUS_L_SIZE + CHORUS_R_SIZE) * sizeof(EAS_PCM)
 };
 
 
@@ -85,7 +97,6 @@ static const EAS_I16 EAS_chorusShape[CHORUS_SHAPE_SIZE] = {
 static EAS_RESULT ChorusInit (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR *pInstData)
 {
     S_CHORUS_OBJECT *pChorusData;
-    EAS_I32 index;
 
     /* check Configuration Module for data allocation */
     if (pEASData->staticMemoryModel)
@@ -101,8 +112,63 @@ static EAS_RESULT ChorusInit (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR *pInstData)
         return EAS_ERROR_MALLOC_FAILED;
     }
 
-    /* clear the structure */
+    /* the delay lines are allocated when the chorus is first enabled */
+    pChorusData->chorusDelayL = NULL;
+    pChorusData->chorusDelayR = NULL;
+    pChorusData->hwInstData = pEASData->hwInstData;
+    pChorusData->staticDelay = EAS_FALSE;
+#ifdef _STATIC_MEMORY
+    if (pEASData->staticMemoryModel)
+    {
+        pChorusData->chorusDelayL = eas_ChorusDelayLines;
+        pChorusData->chorusDelayR = eas_ChorusDelayLines + CHORUS_L_SIZE;
+        pChorusData->staticDelay = EAS_TRUE;
+    }
+#endif
+
+    ChorusReset(pChorusData);
+
+    *pInstData = pChorusData;
+
+    return EAS_SUCCESS;
+} /* end ChorusInit */
+
+/*----------------------------------------------------------------------------
+ * ChorusReset()
+ *----------------------------------------------------------------------------
+ * Purpose: Restores the default preset and clears the delay lines
+ *
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ChorusReset (EAS_VOID_PTR pInstData)
+{
+    S_CHORUS_OBJECT *pChorusData;
+    EAS_I32 index;
+    EAS_PCM *pDelayLines;
+    EAS_HW_DATA_HANDLE hwInstData;
+    EAS_BOOL staticDelay;
+
+    pChorusData = (S_CHORUS_OBJECT*) pInstData;
+
+    /* clear the structure, the delay lines are kept */
+    pDelayLines = pChorusData->chorusDelayL;
+    hwInstData = pChorusData->hwInstData;
+    staticDelay = pChorusData->staticDelay;
     EAS_HWMemSet(pChorusData, 0, sizeof(S_CHORUS_OBJECT));
+    if (pDelayLines != NULL)
+    {
+        pChorusData->chorusDelayL = pDelayLines;
+        pChorusData->chorusDelayR = pDelayLines + CHORUS_L_SIZE;
+    }
+    pChorusData->hwInstData = hwInstData;
+    pChorusData->staticDelay = staticDelay;
+    pChorusData->idleTime = EAS_CHORUS_IDLE_TIME_DEFAULT;
+    pChorusData->silentSamples = CHORUS_L_SIZE;
 
     ChorusReadInPresets(pChorusData);
 
@@ -111,13 +177,16 @@ static EAS_RESULT ChorusInit (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR *pInstData)
     pChorusData->m_nNextChorus = EAS_CHORUS_PRESET_DEFAULT;
 
     //zero delay memory for chorus
-    for (index = CHORUS_L_SIZE - 1; index >= 0; index--)
-    {
-        pChorusData->chorusDelayL[index] = 0;
-    }
-    for (index = CHORUS_R_SIZE - 1; index >= 0; index--)
+    if (pChorusData->chorusDelayL != NULL)
     {
-        pChorusData->chorusDelayR[index] = 0;
+        for (index = CHORUS_L_SIZE - 1; index >= 0; index--)
+        {
+            pChorusData->chorusDelayL[index] = 0;
+        }
+        for (index = CHORUS_R_SIZE - 1; index >= 0; index--)
+        {
+            pChorusData->chorusDelayR[index] = 0;
+        }
     }
 
     //init delay line index, these are used to implement circular delay buffer
@@ -135,11 +204,118 @@ static EAS_RESULT ChorusInit (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR *pInstData)
 
     //now copy from the new preset into Chorus
     ChorusUpdate(pChorusData);
+} /* end ChorusReset */
 
-    *pInstData = pChorusData;
+/*----------------------------------------------------------------------------
+ * ChorusAllocDelay()
+ *----------------------------------------------------------------------------
+ * Purpose: Allocates and clears the delay lines if the chorus has none
+ *
+ *
+ * Inputs:
+ * pChorusData - chorus instance data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT ChorusAllocDelay (S_CHORUS_OBJECT *pChorusData)
+{
+    if (pChorusData->chorusDelayL != NULL)
+        return EAS_SUCCESS;
 
+    pChorusData->chorusDelayL = EAS_HWMalloc(pChorusData->hwInstData, (CHORUS_L_SIZE + CHORUS_R_SIZE) * (EAS_I32) sizeof(EAS_PCM));
+    if (pChorusData->chorusDelayL == NULL)
+    {
+        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_FATAL, "Failed to allocate Chorus delay lines\n"); */ }
+        return EAS_ERROR_MALLOC_FAILED;
+    }
+    EAS_HWMemSet(pChorusData->chorusDelayL, 0, (CHORUS_L_SIZE + CHORUS_R_SIZE) * (EAS_I32) sizeof(EAS_PCM));
+    pChorusData->chorusDelayR = pChorusData->chorusDelayL + CHORUS_L_SIZE;
     return EAS_SUCCESS;
-} /* end ChorusInit */
+} /* end ChorusAllocDelay */
+
+/*----------------------------------------------------------------------------
+ * ChorusIdle()
+ *----------------------------------------------------------------------------
+ * Purpose: Counts the samples processed while bypassed and frees the delay
+ * lines once the idle time has elapsed
+ *
+ *
+ * Inputs:
+ * pChorusData - chorus instance data
+ * numSamples - number of samples processed
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ChorusIdle (S_CHORUS_OBJECT *pChorusData, EAS_I32 numSamples)
+{
+    EAS_I32 idleSamples;
+
+    if ((pChorusData->chorusDelayL == NULL) || pChorusData->staticDelay || (pChorusData->idleTime == 0))
+        return;
+
+    /* split the conversion so long idle times cannot overflow */
+    pChorusData->idleSamples += numSamples;
+    idleSamples = (pChorusData->idleTime / 1000) * _OUTPUT_SAMPLE_RATE +
+        ((pChorusData->idleTime % 1000) * _OUTPUT_SAMPLE_RATE) / 1000;
+    if (pChorusData->idleSamples < idleSamples)
+        return;
+
+    EAS_HWFree(pChorusData->hwInstData, pChorusData->chorusDelayL);
+    pChorusData->chorusDelayL = NULL;
+    pChorusData->chorusDelayR = NULL;
+    pChorusData->idleSamples = 0;
+    pChorusData->silentSamples = CHORUS_L_SIZE;
+} /* end ChorusIdle */
+
+/*----------------------------------------------------------------------------
+ * ChorusIsSilent()
+ *----------------------------------------------------------------------------
+ * Purpose: Returns EAS_TRUE if silent input to the next ChorusProcess()
+ * call produces silent output
+ *
+ *
+ * Inputs:
+ * pInstData - chorus instance data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL ChorusIsSilent (EAS_VOID_PTR pInstData)
+{
+    S_CHORUS_OBJECT *pChorusData;
+
+    pChorusData = (S_CHORUS_OBJECT*) pInstData;
+    return pChorusData->bypass == EAS_TRUE || pChorusData->m_nLevel == 0 || pChorusData->silentSamples >= CHORUS_L_SIZE;
+} /* end ChorusIsSilent */
+
+/*----------------------------------------------------------------------------
+ * ChorusSkip()
+ *----------------------------------------------------------------------------
+ * Purpose: Stands in for the processing loop while the delay lines and the
+ * input are silent. The delay indexes and LFO phases advance exactly as
+ * the loop would advance them.
+ *
+ *
+ * Inputs:
+ * pChorusData - chorus instance data
+ * numSamples - number of samples to skip
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ChorusSkip (S_CHORUS_OBJECT *pChorusData, EAS_I32 numSamples)
+{
+    pChorusData->chorusIndexL = (EAS_I16) ((pChorusData->chorusIndexL + numSamples) % CHORUS_L_SIZE);
+    pChorusData->chorusIndexR = (EAS_I16) ((pChorusData->chorusIndexR + numSamples) % CHORUS_R_SIZE);
+    pChorusData->lfoLPhase = (pChorusData->lfoLPhase + pChorusData->m_nRate * numSamples) % (CHORUS_SHAPE_SIZE << 16);
+    pChorusData->lfoRPhase = (pChorusData->lfoRPhase + pChorusData->m_nRate * numSamples) % (CHORUS_SHAPE_SIZE << 16);
+} /* end ChorusSkip */
 
 /*----------------------------------------------------------------------------
  * WeightedTap()
@@ -238,6 +414,8 @@ static void ChorusProcess (EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst,
     //if the chorus is disabled or turned all the way down
     if (pChorusData->bypass == EAS_TRUE || pChorusData->m_nLevel == 0)
     {
+        if (pChorusData->bypass == EAS_TRUE)
+            ChorusIdle(pChorusData, numSamples);
         if (pSrc != pDst)
             EAS_HWMemCpy(pSrc, pDst, numSamples * NUM_OUTPUT_CHANNELS * (EAS_I32) sizeof(EAS_PCM));
         return;
@@ -248,6 +426,24 @@ static void ChorusProcess (EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst,
         ChorusUpdate(pChorusData);
     }
 
+    //silent input into silent delay lines gives silent output
+    for (ix = 0; ix < numSamples * NUM_OUTPUT_CHANNELS; ix++)
+    {
+        if (pSrc[ix] != 0)
+            break;
+    }
+    if (ix < numSamples * NUM_OUTPUT_CHANNELS)
+        pChorusData->silentSamples = 0;
+    else if (pChorusData->silentSamples >= CHORUS_L_SIZE)
+    {
+        ChorusSkip(pChorusData, numSamples);
+        if (pSrc != pDst)
+            EAS_HWMemSet(pDst, 0, numSamples * NUM_OUTPUT_CHANNELS * (EAS_I32) sizeof(EAS_PCM));
+        return;
+    }
+    else
+        pChorusData->silentSamples += numSamples;
+
     for (nChannelNumber = 0; nChannelNumber < NUM_OUTPUT_CHANNELS; nChannelNumber++)
     {
 
@@ -369,12 +565,64 @@ static void ChorusProcess (EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst,
 */
 static EAS_RESULT ChorusShutdown (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pInstData)
 {
+    S_CHORUS_OBJECT *pChorusData;
+
+    pChorusData = (S_CHORUS_OBJECT*) pInstData;
+
     /* check Configuration Module for static memory allocation */
     if (!pEASData->staticMemoryModel)
+    {
+        if ((pChorusData->chorusDelayL != NULL) && !pChorusData->staticDelay)
+            EAS_HWFree(pEASData->hwInstData, pChorusData->chorusDelayL);
         EAS_HWFree(pEASData->hwInstData, pInstData);
+    }
     return EAS_SUCCESS;
 } /* end ChorusShutdown */
 
+/*----------------------------------------------------------------------------
+ * ChorusClone()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Copy the chorus settings and delay lines of another instance
+ *
+ * Inputs:
+ * pEASData         - instance that receives the copy
+ * pSrcData         - handle to the instance data being copied
+ * pInstData        - receives the handle to the new instance data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT ChorusClone (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pSrcData, EAS_VOID_PTR *pInstData)
+{
+    S_CHORUS_OBJECT *pChorusData;
+    S_CHORUS_OBJECT *pSrc;
+    EAS_RESULT result;
+
+    pSrc = (S_CHORUS_OBJECT*) pSrcData;
+    if ((pChorusData = EAS_HWMalloc(pEASData->hwInstData, sizeof(S_CHORUS_OBJECT))) == NULL)
+        return EAS_ERROR_MALLOC_FAILED;
+    EAS_HWMemCpy(pChorusData, pSrc, sizeof(S_CHORUS_OBJECT));
+    pChorusData->chorusDelayL = NULL;
+    pChorusData->chorusDelayR = NULL;
+    pChorusData->hwInstData = pEASData->hwInstData;
+    pChorusData->staticDelay = EAS_FALSE;
+
+    if (pSrc->chorusDelayL != NULL)
+    {
+        if ((result = ChorusAllocDelay(pChorusData)) != EAS_SUCCESS)
+        {
+            EAS_HWFree(pEASData->hwInstData, pChorusData);
+            return result;
+        }
+        EAS_HWMemCpy(pChorusData->chorusDelayL, pSrc->chorusDelayL, (CHORUS_L_SIZE + CHORUS_R_SIZE) * (EAS_I32) sizeof(EAS_PCM));
+    }
+
+    *pInstData = pChorusData;
+    return EAS_SUCCESS;
+} /* end ChorusClone */
+
 /*----------------------------------------------------------------------------
  * ChorusGetParam()
  *----------------------------------------------------------------------------
@@ -416,6 +664,9 @@ static EAS_RESULT ChorusGetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32
         case EAS_PARAM_CHORUS_LEVEL:
             *pValue = (EAS_I32) p->m_nLevel;
             break;
+        case EAS_PARAM_CHORUS_IDLE_TIME:
+            *pValue = p->idleTime;
+            break;
         default:
             return EAS_ERROR_INVALID_PARAMETER;
     }
@@ -444,13 +695,18 @@ static EAS_RESULT ChorusGetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32
 static EAS_RESULT ChorusSetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value)
 {
     S_CHORUS_OBJECT *p;
+    EAS_RESULT result;
 
     p = (S_CHORUS_OBJECT*) pInstData;
 
     switch (param)
     {
         case EAS_PARAM_CHORUS_BYPASS:
+            /* the delay lines must exist before the chorus runs */
+            if ((value != EAS_TRUE) && ((result = ChorusAllocDelay(p)) != EAS_SUCCESS))
+                return result;
             p->bypass = (EAS_BOOL) value;
+            p->idleSamples = 0;
             break;
         case EAS_PARAM_CHORUS_PRESET:
             if(value!=EAS_PARAM_CHORUS_PRESET1 && value!=EAS_PARAM_CHORUS_PRESET2 &&
@@ -474,6 +730,11 @@ static EAS_RESULT ChorusSetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32
                 return EAS_ERROR_INVALID_PARAMETER;
             p->m_nLevel = (EAS_I16) value;
             break;
+        case EAS_PARAM_CHORUS_IDLE_TIME:
+            if(value<0 || value>EAS_CHORUS_IDLE_TIME_MAX)
+                return EAS_ERROR_INVALID_PARAMETER;
+            p->idleTime = value;
+            break;
 
         default:
             return EAS_ERROR_INVALID_PARAMETER;
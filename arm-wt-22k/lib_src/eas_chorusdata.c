@@ -30,5 +30,8 @@
 
 #include "eas_chorusdata.h"
 
+/* the static memory model allocates its single instance here */
+#ifdef _STATIC_MEMORY
 S_CHORUS_OBJECT eas_ChorusData;
-
+EAS_PCM eas_ChorusDelayLines[CHORUS_L_SIZE + CHORUS_R_SIZE];
+#endif
@@ -48,6 +48,9 @@
 #define EAS_CHORUS_DEPTH_MIN        15
 #define EAS_CHORUS_DEPTH_MAX        60
 
+#define EAS_CHORUS_IDLE_TIME_DEFAULT    1000
+#define EAS_CHORUS_IDLE_TIME_MAX        60000
+
 #define CHORUS_SIZE_MS 20
 #define CHORUS_L_SIZE ((CHORUS_SIZE_MS*_OUTPUT_SAMPLE_RATE)/1000)
 #define CHORUS_R_SIZE CHORUS_L_SIZE
@@ -84,8 +87,17 @@ typedef struct
     EAS_I16 m_nLevel;
 
     //delay lines used by the chorus, longer would sound better
-    EAS_PCM chorusDelayL[CHORUS_L_SIZE];
-    EAS_PCM chorusDelayR[CHORUS_R_SIZE];
+    //both live in one block allocated when the bypass is first turned off
+    EAS_PCM *chorusDelayL;
+    EAS_PCM *chorusDelayR;
+    EAS_HW_DATA_HANDLE hwInstData;
+    EAS_BOOL staticDelay;
+    EAS_I32 idleTime;
+    EAS_I32 idleSamples;
+
+    //silent input since the delay lines were last written, once it
+    //reaches CHORUS_L_SIZE the delay lines hold only zeros
+    EAS_I32 silentSamples;
 
     EAS_BOOL    bypass;
 
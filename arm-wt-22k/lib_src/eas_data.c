@@ -30,8 +30,9 @@
 // includes
 #include "eas_data.h"
 
-// globals
+/* the static memory model allocates its single instance here */
+#ifdef _STATIC_MEMORY
 S_EAS_DATA eas_Data;
 S_VOICE_MGR eas_Synth;
 S_SYNTH eas_MIDI;
-
+#endif
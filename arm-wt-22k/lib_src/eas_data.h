@@ -43,6 +43,8 @@
 #include "eas_synth.h"
 #include "eas_miditypes.h"
 #include "eas_effects.h"
+#include "eas_queue.h"
+#include "eas_resampler.h"
 
 #ifdef AUX_MIXER
 #include "eas_auxmixdata.h"
@@ -76,6 +78,7 @@ typedef struct s_eas_stream_tag
     EAS_VOID_PTR                    handle;
     EAS_U8                          volume;
     EAS_BOOL8                       streamFlags;
+    EAS_U32                         generation;     /* counts the opens of this slot, tags queued events */
 } S_EAS_STREAM;
 
 /* default master volume is -10dB */
@@ -103,6 +106,10 @@ typedef struct s_eas_data_tag
 
     EAS_I32                         *pMixBuffer;
     EAS_PCM                         *pOutputAudioBuffer;
+    EAS_PCM * const                 *ppStemOutput;
+    EAS_VOID_PTR                    pFormatOutput;
+    EAS_VOID_PTR                    pFormatRight;
+    EAS_I32                         formatMixGain;
 
 #ifdef AUX_MIXER
     S_EAS_AUX_MIXER                 auxMixer;
@@ -115,18 +122,34 @@ typedef struct s_eas_data_tag
     S_EAS_STREAM                    streams[MAX_NUMBER_STREAMS];
 
     S_PCM_STATE                     *pPCMStreams;
+    S_PCM_PREFETCH                  *pPCMPrefetch;
+
+#if defined(_IMA_DECODER) && (IMA_CACHE_BLOCKS > 0)
+    S_IMA_CACHE                     *pIMACache;
+#endif
 
     S_VOICE_MGR                     *pVoiceMgr;
+    S_RESAMPLER                     *pResampler;
 
 #ifdef JET_INTERFACE
     JET_DATA_HANDLE                 jetHandle;
 #endif
 
+    S_EAS_QUEUES                    queues;
+
     EAS_U32                         renderTime;
+    volatile EAS_UINT               pcmUnderruns;
     EAS_I16                         masterGain;
+    EAS_I16                         offlineTailGain;
+    EAS_I16                         offlinePeak;
     EAS_U8                          masterVolume;
+    EAS_U8                          outputFormat;
+    EAS_BOOL8                       formatMix;
     EAS_BOOL8                       staticMemoryModel;
     EAS_BOOL8                       searchHeaderFlag;
+    EAS_BOOL8                       silentFrame;
+    EAS_BOOL8                       offlineMode;
+    EAS_BOOL8                       offlineLeading;
 } S_EAS_DATA;
 
 #endif
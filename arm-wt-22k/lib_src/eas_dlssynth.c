@@ -345,7 +345,7 @@ EAS_RESULT DLS_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOIC
     pWTVoice->filter.z2 = 0;
 
     /* initialize the oscillator */
-    pWTVoice->phaseAccum = (EAS_U32) pSynth->pDLS->pDLSSamples + pSynth->pDLS->pDLSSampleOffsets[pDLSRegion->wtRegion.waveIndex];
+    pWTVoice->phaseAccum = (EAS_UINTPTR) pSynth->pDLS->pDLSSamples + pSynth->pDLS->pDLSSampleOffsets[pDLSRegion->wtRegion.waveIndex];
     if (pDLSRegion->wtRegion.region.keyGroupAndFlags & REGION_FLAG_IS_LOOPED)
     {
 #if defined (_8_BIT_SAMPLES)
@@ -440,7 +440,11 @@ EAS_BOOL DLS_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE
     if ((pWTVoice->loopStart != WT_NOISE_GENERATOR) && (pWTVoice->loopStart == pWTVoice->loopEnd))
         done = WT_CheckSampleEnd(pWTVoice, &intFrame, EAS_FALSE);
 
-    WT_ProcessVoice(pWTVoice, &intFrame);
+    /* voices below the cull gain only advance their phase */
+    if (WT_VoiceInaudible(pWTVoice, &intFrame, pVoiceMgr->cullGain))
+        WT_SkipVoice(pWTVoice, &intFrame);
+    else
+        WT_ProcessVoice(pWTVoice, &intFrame);
 
     /* clear flag */
     pVoice->voiceFlags &= ~VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET;
@@ -39,6 +39,11 @@ typedef struct
     EAS_RESULT  (*pfShutdown)(EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pInstData);
     EAS_RESULT  (*pFGetParam)(EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue);
     EAS_RESULT  (*pFSetParam)(EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value);
+    void        (*pfReset)(EAS_VOID_PTR pInstData);
+    EAS_RESULT  (*pfClone)(EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pSrcData, EAS_VOID_PTR *pInstData);
+    EAS_BOOL    (*pfIsSilent)(EAS_VOID_PTR pInstData);  /* silent input gives silent output */
+    EAS_I32     instDataSize;   /* size of the instance data allocated by pfInit */
+    EAS_I32     delayDataSize;  /* size of the delay lines allocated when the bypass is turned off */
 } S_EFFECTS_INTERFACE;
 
 typedef struct
@@ -48,6 +53,11 @@ typedef struct
     EAS_RESULT  (*pfShutdown)(EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pInstData);
     EAS_RESULT  (*pFGetParam)(EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue);
     EAS_RESULT  (*pFSetParam)(EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value);
+    void        (*pfReset)(EAS_VOID_PTR pInstData);
+    EAS_RESULT  (*pfClone)(EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pSrcData, EAS_VOID_PTR *pInstData);
+    EAS_BOOL    (*pfIsSilent)(EAS_VOID_PTR pInstData);  /* silent input gives silent output */
+    EAS_I32     instDataSize;   /* size of the instance data allocated by pfInit */
+    EAS_I32     delayDataSize;  /* size of the delay lines allocated when the bypass is turned off */
 } S_EFFECTS32_INTERFACE;
 
 /* mixer instance data */
@@ -39,17 +39,36 @@
  * externs
  *----------------------------------------------------------------------------
 */
-extern const EAS_I16 imaIndexTable[];
-extern const EAS_I16 imaStepSizeTable[];
+extern const EAS_I32 imaDeltaTable[];
+extern const EAS_U8 imaNextStepTable[];
+
+/* largest single file read when decoding straight into the ring */
+#define IMA_READ_SIZE               256
+
+/* decodes one nibble, the tables take care of the sign and step limits
+ * so only the saturation of the accumulator is left */
+#define IMA_DECODE_NIBBLE(acc, step, nibble) \
+{ \
+    EAS_INT index = ((step) << 4) | (nibble); \
+    (acc) += imaDeltaTable[index]; \
+    (acc) = ((acc) > 32767) ? 32767 : (((acc) < -32768) ? -32768 : (acc)); \
+    (step) = imaNextStepTable[index]; \
+}
 
 /*----------------------------------------------------------------------------
  * prototypes
  *----------------------------------------------------------------------------
 */
 static EAS_RESULT IMADecoderInit (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState);
-static EAS_RESULT IMADecoderSample (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState);
-static void IMADecoderADPCM (S_DECODER_STATE *pState, EAS_U8 nibble);
+static EAS_RESULT IMADecoderBlock (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState);
 static EAS_RESULT IMADecoderLocate (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState, EAS_I32 time);
+static void IMAParseHeader (S_PCM_STATE *pState, const EAS_U8 *pSrc, EAS_PCM *pFrame);
+static void IMADecodeBytes (S_PCM_STATE *pState, const EAS_U8 *pSrc, EAS_I32 numBytes, EAS_PCM *pDst);
+static void IMAPutFrames (S_PCM_STATE *pState, const EAS_PCM *pSrc, EAS_I32 numFrames);
+#if (IMA_CACHE_BLOCKS > 0)
+static EAS_RESULT IMADecodeCached (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState, EAS_BOOL *pCached);
+static void IMACacheRelease (S_PCM_STATE *pState);
+#endif
 
 /*----------------------------------------------------------------------------
  * IMA ADPCM Decoder interface
@@ -58,8 +77,9 @@ static EAS_RESULT IMADecoderLocate (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pStat
 const S_DECODER_INTERFACE IMADecoder =
 {
     IMADecoderInit,
-    IMADecoderSample,
-    IMADecoderLocate
+    NULL,
+    IMADecoderLocate,
+    IMADecoderBlock
 };
 
 /*----------------------------------------------------------------------------
@@ -78,19 +98,31 @@ const S_DECODER_INTERFACE IMADecoder =
  *
  *----------------------------------------------------------------------------
 */
-/*lint -esym(715, pEASData) common decoder interface - pEASData not used */
 static EAS_RESULT IMADecoderInit (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState)
 {
     pState->decoderL.step = 0;
     pState->decoderR.step = 0;
+
+#if (IMA_CACHE_BLOCKS > 0)
+    IMACacheRelease(pState);
+
+    /* the cache is shared by the IMA ADPCM streams of the instance, without it blocks are decoded every time */
+    if ((pEASData->pIMACache == NULL) && !pEASData->staticMemoryModel)
+    {
+        if ((pEASData->pIMACache = EAS_HWMalloc(pEASData->hwInstData, sizeof(S_IMA_CACHE))) != NULL)
+            EAS_HWMemSet(pEASData->pIMACache, 0, sizeof(S_IMA_CACHE));
+    }
+#endif
     return EAS_SUCCESS;
 }
 
 /*----------------------------------------------------------------------------
- * IMADecoderSample()
+ * IMADecoderBlock()
  *----------------------------------------------------------------------------
  * Purpose:
- * Decodes an IMA ADPCM sample
+ * Decodes IMA ADPCM frames into the ring until it is full or the stream
+ * runs out of data. Whole blocks come from the block cache when they can,
+ * anything else is decoded straight from the file.
  *
  * Inputs:
  *
@@ -102,21 +134,62 @@ static EAS_RESULT IMADecoderInit (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState)
  *
  *----------------------------------------------------------------------------
 */
-static EAS_RESULT IMADecoderSample (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState)
+static EAS_RESULT IMADecoderBlock (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState)
 {
+    EAS_U8 buffer[IMA_READ_SIZE];
+    EAS_PCM samples[IMA_READ_SIZE * 2];
     EAS_RESULT result;
-    EAS_I16 sTemp;
+    EAS_I32 numBytes;
+    EAS_I32 count;
+    EAS_I32 space;
+    EAS_I32 headerSize;
+    EAS_BOOL stereo;
+    EAS_BOOL eof;
 
-    /* if high nibble, decode */
-    if (pState->hiNibble)
-    {
-        IMADecoderADPCM(&pState->decoderL, (EAS_U8)(pState->srcByte >> 4));
-        pState->hiNibble = EAS_FALSE;
-    }
+    stereo = (pState->flags & PCM_FLAGS_STEREO) ? EAS_TRUE : EAS_FALSE;
+    headerSize = stereo ? 8 : 4;
 
-    /* low nibble, need to fetch another byte */
-    else
+    while (pState->ringCount < PCM_RING_SIZE)
     {
+        space = PCM_RING_SIZE - pState->ringCount;
+
+#if (IMA_CACHE_BLOCKS > 0)
+        /* copy the rest of a cached block, the bytes are accounted for at its end */
+        if (pState->pCacheEntry)
+        {
+            count = pState->pCacheEntry->numFrames - pState->cacheFrame;
+            if (count > space)
+                count = space;
+            IMAPutFrames(pState, &pState->pCacheEntry->frames[pState->cacheFrame * (stereo ? 2 : 1)], count);
+            pState->cacheFrame = (EAS_U16) (pState->cacheFrame + count);
+            if (pState->cacheFrame == pState->pCacheEntry->numFrames)
+            {
+                pState->bytesLeft -= pState->blockSize;
+                pState->blockCount = 0;
+                IMACacheRelease(pState);
+            }
+            continue;
+        }
+#endif
+
+        /* the high nibble of a mono byte that did not fit */
+        if (pState->hiNibble)
+        {
+            IMA_DECODE_NIBBLE(pState->decoderL.acc, pState->decoderL.step, pState->srcByte >> 4);
+            samples[0] = (EAS_PCM) pState->decoderL.acc;
+            IMAPutFrames(pState, samples, 1);
+            pState->hiNibble = EAS_FALSE;
+            continue;
+        }
+
+        /* give the source a chance to continue the stream */
+        if (!pState->bytesLeft && pState->pCallback && ((pState->flags & PCM_FLAGS_EMPTY) == 0))
+        {
+            pState->flags |= PCM_FLAGS_EMPTY;
+            (*pState->pCallback)(pEASData, pState->cbInstData, pState, EAS_STATE_EMPTY);
+            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "IMADecoderBlock: After empty callback, bytesLeft = %d\n", pState->bytesLeft); */ }
+        }
+
         /* check for loop */
         if ((pState->bytesLeft == 0) && (pState->loopSamples != 0))
         {
@@ -126,148 +199,293 @@ static EAS_RESULT IMADecoderSample (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pStat
             pState->bytesLeft = pState->byteCount = (EAS_I32) pState->bytesLeftLoop;
             pState->blockCount = 0;
             pState->flags &= ~PCM_FLAGS_EMPTY;
-            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "IMADecoderSample: Rewind file to %d, bytesLeft = %d\n", pState->startPos, pState->bytesLeft); */ }
+            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "IMADecoderBlock: Rewind file to %d, bytesLeft = %d\n", pState->startPos, pState->bytesLeft); */ }
         }
 
+        if (pState->bytesLeft <= 0)
+            break;
+
         /* if start of block, fetch new predictor and step index */
-        if ((pState->blockSize != 0) && (pState->blockCount == 0) && (pState->bytesLeft != 0))
+        if ((pState->blockSize != 0) && (pState->blockCount == 0))
         {
-
-            /* get predicted sample for left channel */
-            if ((result = EAS_HWGetWord(pEASData->hwInstData, pState->fileHandle, &sTemp, EAS_FALSE)) != EAS_SUCCESS)
+#if (IMA_CACHE_BLOCKS > 0)
+            EAS_BOOL cached;
+            if ((result = IMADecodeCached(pEASData, pState, &cached)) != EAS_SUCCESS)
                 return result;
-#ifdef _DEBUG_IMA_ADPCM
-            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "Predictor: Was %d, now %d\n", pState->decoderL.acc, sTemp); */ }
+            if (cached)
+                continue;
 #endif
-            pState->decoderL.acc = pState->decoderL.x1 = sTemp;
-
-            /* get step index for left channel - upper 8 bits are reserved */
-            if ((result = EAS_HWGetWord(pEASData->hwInstData, pState->fileHandle, &sTemp, EAS_FALSE)) != EAS_SUCCESS)
+            if ((result = EAS_HWReadFile(pEASData->hwInstData, pState->fileHandle, buffer, headerSize, &count)) != EAS_SUCCESS)
                 return result;
-#ifdef _DEBUG_IMA_ADPCM
-            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "Step: Was %d, now %d\n", pState->decoderL.step, sTemp); */ }
-#endif
-            pState->decoderL.step = sTemp & 0xff;
-
-            if (pState->flags & PCM_FLAGS_STEREO)
-            {
-                /* get predicted sample for right channel */
-                if ((result = EAS_HWGetWord(pEASData->hwInstData, pState->fileHandle, &sTemp, EAS_FALSE)) != EAS_SUCCESS)
-                    return result;
-                pState->decoderR.acc = pState->decoderR.x1 = sTemp;
-
-                /* get step index for right channel - upper 8 bits are reserved */
-                if ((result = EAS_HWGetWord(pEASData->hwInstData, pState->fileHandle, &sTemp, EAS_FALSE)) != EAS_SUCCESS)
-                    return result;
-#ifdef _DEBUG_IMA_ADPCM
-                { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "Step: Was %d, now %d\n", pState->decoderR.step, sTemp); */ }
-#endif
-                pState->decoderR.step = sTemp & 0xff;
+            if (count < headerSize)
+                return EAS_EOF;
+            IMAParseHeader(pState, buffer, samples);
+            IMAPutFrames(pState, samples, 1);
+            pState->blockCount = (EAS_U16) (pState->blockSize - headerSize);
+            pState->bytesLeft -= headerSize;
+            continue;
+        }
 
-                pState->blockCount = pState->blockSize - 8;
-                pState->bytesLeft -= 8;
-            }
-            else
-            {
-                pState->blockCount = pState->blockSize - 4;
-                pState->bytesLeft -= 4;
-            }
+        /* a stereo byte is one frame, a mono byte two */
+        numBytes = stereo ? space : (space + 1) >> 1;
+        if (numBytes > IMA_READ_SIZE)
+            numBytes = IMA_READ_SIZE;
+        if (numBytes > pState->bytesLeft)
+            numBytes = pState->bytesLeft;
+        if ((pState->blockSize != 0) && (numBytes > pState->blockCount))
+            numBytes = pState->blockCount;
+        if ((result = EAS_HWReadFile(pEASData->hwInstData, pState->fileHandle, buffer, numBytes, &count)) != EAS_SUCCESS)
+            return result;
+        pState->bytesLeft -= count;
+        pState->blockCount = (EAS_U16) (pState->blockCount - count);
+
+        /* the file is shorter than the stream, decode what was read */
+        eof = (count < numBytes) ? EAS_TRUE : EAS_FALSE;
+
+        /* a mono frame count that is odd leaves the last high nibble for later */
+        if (!stereo && (count << 1) > space)
+        {
+            count--;
+            pState->srcByte = buffer[count];
+            pState->hiNibble = EAS_TRUE;
         }
-        else
+        IMADecodeBytes(pState, buffer, count, samples);
+        IMAPutFrames(pState, samples, stereo ? count : count << 1);
+        if (pState->hiNibble)
         {
+            IMA_DECODE_NIBBLE(pState->decoderL.acc, pState->decoderL.step, pState->srcByte & 0x0f);
+            samples[0] = (EAS_PCM) pState->decoderL.acc;
+            IMAPutFrames(pState, samples, 1);
+        }
+        if (eof)
+            return EAS_EOF;
+    }
 
-            /* get another ADPCM data pair */
-            if (pState->bytesLeft)
-            {
-
-                if ((result = EAS_HWGetByte(pEASData->hwInstData, pState->fileHandle, &pState->srcByte)) != EAS_SUCCESS)
-                    return result;
+    return EAS_SUCCESS;
+}
 
-                /* decode the low nibble */
-                pState->bytesLeft--;
-                pState->blockCount--;
-                IMADecoderADPCM(&pState->decoderL, (EAS_U8)(pState->srcByte & 0x0f));
+/*----------------------------------------------------------------------------
+ * IMAParseHeader()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Loads the predictor and step index of each channel from a block header.
+ * The predictor is also the first frame of the block.
+ *----------------------------------------------------------------------------
+*/
+static void IMAParseHeader (S_PCM_STATE *pState, const EAS_U8 *pSrc, EAS_PCM *pFrame)
+{
+    /* upper 8 bits of the step index are reserved */
+    pState->decoderL.acc = pFrame[0] = (EAS_PCM) (pSrc[0] | (pSrc[1] << 8));
+    pState->decoderL.step = (pSrc[2] > 88) ? 88 : pSrc[2];
+#ifdef _DEBUG_IMA_ADPCM
+    { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "Predictor: %d, step: %d\n", pState->decoderL.acc, pState->decoderL.step); */ }
+#endif
 
-                if (pState->flags & PCM_FLAGS_STEREO)
-                    IMADecoderADPCM(&pState->decoderR, (EAS_U8)(pState->srcByte >> 4));
-                else
-                    pState->hiNibble = EAS_TRUE;
-            }
+    if (pState->flags & PCM_FLAGS_STEREO)
+    {
+        pState->decoderR.acc = pFrame[1] = (EAS_PCM) (pSrc[4] | (pSrc[5] << 8));
+        pState->decoderR.step = (pSrc[6] > 88) ? 88 : pSrc[6];
+    }
+}
 
-            /* out of ADPCM data, generate enough samples to fill buffer */
-            else
-            {
-                pState->decoderL.x1 = pState->decoderL.x0;
-                pState->decoderR.x1 = pState->decoderR.x0;
-            }
+/*----------------------------------------------------------------------------
+ * IMADecodeBytes()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Decodes whole bytes of ADPCM data. A mono byte holds two samples, low
+ * nibble first, a stereo byte holds the left sample in the low nibble
+ * and the right sample in the high nibble.
+ *----------------------------------------------------------------------------
+*/
+static void IMADecodeBytes (S_PCM_STATE *pState, const EAS_U8 *pSrc, EAS_I32 numBytes, EAS_PCM *pDst)
+{
+    EAS_I32 accL, accR;
+    EAS_INT stepL, stepR;
+    EAS_I32 i;
+
+    /* keep the decoder state in registers */
+    accL = pState->decoderL.acc;
+    stepL = pState->decoderL.step;
+    if (pState->flags & PCM_FLAGS_STEREO)
+    {
+        accR = pState->decoderR.acc;
+        stepR = pState->decoderR.step;
+        for (i = 0; i < numBytes; i++)
+        {
+            IMA_DECODE_NIBBLE(accL, stepL, pSrc[i] & 0x0f);
+            IMA_DECODE_NIBBLE(accR, stepR, pSrc[i] >> 4);
+            pDst[2 * i] = (EAS_PCM) accL;
+            pDst[2 * i + 1] = (EAS_PCM) accR;
         }
+        pState->decoderR.acc = accR;
+        pState->decoderR.step = stepR;
     }
-
-    return EAS_SUCCESS;
+    else
+    {
+        for (i = 0; i < numBytes; i++)
+        {
+            IMA_DECODE_NIBBLE(accL, stepL, pSrc[i] & 0x0f);
+            pDst[2 * i] = (EAS_PCM) accL;
+            IMA_DECODE_NIBBLE(accL, stepL, pSrc[i] >> 4);
+            pDst[2 * i + 1] = (EAS_PCM) accL;
+        }
+    }
+    pState->decoderL.acc = accL;
+    pState->decoderL.step = stepL;
 }
 
 /*----------------------------------------------------------------------------
- * IMADecoderADPCM()
+ * IMAPutFrames()
  *----------------------------------------------------------------------------
  * Purpose:
- * Decodes an IMA ADPCM sample
- *
- * Inputs:
- *
- *
- * Outputs:
- *
- *
- * Side Effects:
- *
+ * Appends decoded frames to the ring, the caller checks there is room
  *----------------------------------------------------------------------------
 */
-static void IMADecoderADPCM (S_DECODER_STATE *pState, EAS_U8 nibble)
+static void IMAPutFrames (S_PCM_STATE *pState, const EAS_PCM *pSrc, EAS_I32 numFrames)
 {
-    EAS_INT delta;
-    EAS_INT stepSize;
-
-    /* get stepsize from table */
-    stepSize = imaStepSizeTable[pState->step];
+    EAS_PCM *pRing;
+    EAS_I32 i;
 
-    /* delta = (abs(delta) + 0.5) * step / 4 */
-    delta = 0;
-    if (nibble & 4)
-        delta += stepSize;
+    for (i = 0; i < numFrames; i++)
+    {
+        pRing = &pState->pRing[((pState->ringRead + pState->ringCount) & PCM_RING_MASK) * 2];
+        if (pState->flags & PCM_FLAGS_STEREO)
+        {
+            pRing[0] = *pSrc++;
+            pRing[1] = *pSrc++;
+        }
+        else
+            pRing[0] = *pSrc++;
+        pState->ringCount++;
+    }
+}
 
-    if (nibble & 2)
-        /*lint -e{702} use shift for performance */
-        delta += stepSize >> 1;
+#if (IMA_CACHE_BLOCKS > 0)
+/*----------------------------------------------------------------------------
+ * IMADecodeCached()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * At the start of a block, finds the block in the cache or decodes it
+ * into the least recently used entry. The stream then copies frames from
+ * the entry and skips the block in the file. Partial blocks, blocks that
+ * are too big and streams that find every entry in use are not cached.
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT IMADecodeCached (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState, EAS_BOOL *pCached)
+{
+    EAS_U8 buffer[IMA_CACHE_MAX_BLOCK_SIZE];
+    S_IMA_CACHE *pCache;
+    S_IMA_CACHE_ENTRY *pEntry;
+    S_IMA_CACHE_ENTRY *pFree;
+    EAS_RESULT result;
+    EAS_I32 filePos;
+    EAS_I32 headerSize;
+    EAS_I32 count;
+    EAS_INT i;
+
+    *pCached = EAS_FALSE;
+    pCache = pEASData->pIMACache;
+    if ((pCache == NULL) || (pState->blockSize > IMA_CACHE_MAX_BLOCK_SIZE) ||
+        (pState->bytesLeft < pState->blockSize) || (pState->flags & PCM_FLAGS_STREAMING))
+        return EAS_SUCCESS;
+
+    if ((result = EAS_HWFilePos(pEASData->hwInstData, pState->fileHandle, &filePos)) != EAS_SUCCESS)
+        return result;
 
-    if (nibble & 1)
-        /*lint -e{702} use shift for performance */
-        delta += stepSize >> 2;
+    /* look for the block, and for the least recently used entry not in use */
+    pFree = NULL;
+    for (i = 0, pEntry = pCache->entries; i < IMA_CACHE_BLOCKS; i++, pEntry++)
+    {
+        if ((pEntry->fileHandle == pState->fileHandle) && (pEntry->filePos == filePos))
+            break;
+        if ((pEntry->numUsers == 0) && ((pFree == NULL) || (pEntry->lastUsed < pFree->lastUsed)))
+            pFree = pEntry;
+    }
 
-    /*lint -e{702} use shift for performance */
-    delta += stepSize >> 3;
+    /* found, skip the block */
+    if (i < IMA_CACHE_BLOCKS)
+    {
+        if ((result = EAS_HWFileSeekOfs(pEASData->hwInstData, pState->fileHandle, pState->blockSize)) != EAS_SUCCESS)
+            return result;
+    }
 
-    /* integrate the delta */
-    if (nibble & 8)
-      pState->acc -= delta;
+    /* decode the whole block in one go */
     else
-      pState->acc += delta;
-
-    /* saturate */
-    if (pState->acc > 32767)
-        pState->acc = 32767;
-    if (pState->acc < -32768)
-        pState->acc = -32768;
-    pState->x1 = (EAS_PCM) pState->acc;
-
-    /* compute new step size */
-    pState->step += imaIndexTable[nibble];
-    if (pState->step < 0)
-        pState->step = 0;
-    if (pState->step > 88)
-        pState->step = 88;
+    {
+        if ((pEntry = pFree) == NULL)
+            return EAS_SUCCESS;
+        if ((result = EAS_HWReadFile(pEASData->hwInstData, pState->fileHandle, buffer, pState->blockSize, &count)) != EAS_SUCCESS)
+            return result;
+        if (count < pState->blockSize)
+            return EAS_EOF;
+
+        headerSize = (pState->flags & PCM_FLAGS_STEREO) ? 8 : 4;
+        IMAParseHeader(pState, buffer, pEntry->frames);
+        if (pState->flags & PCM_FLAGS_STEREO)
+        {
+            IMADecodeBytes(pState, buffer + headerSize, pState->blockSize - headerSize, &pEntry->frames[2]);
+            pEntry->numFrames = (EAS_U16) (pState->blockSize - headerSize + 1);
+        }
+        else
+        {
+            IMADecodeBytes(pState, buffer + headerSize, pState->blockSize - headerSize, &pEntry->frames[1]);
+            pEntry->numFrames = (EAS_U16) (((pState->blockSize - headerSize) << 1) + 1);
+        }
+        pEntry->fileHandle = pState->fileHandle;
+        pEntry->filePos = filePos;
+    }
 
-#ifdef _DEBUG_IMA_ADPCM
-    { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "In=%u, Pred=%d, Step=%d\n", nibble, pState->acc,  imaStepSizeTable[pState->step]); */ }
+    pEntry->numUsers++;
+    pEntry->lastUsed = ++pCache->useCount;
+    pState->pCacheEntry = pEntry;
+    pState->cacheFrame = 0;
+    *pCached = EAS_TRUE;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * IMACacheRelease()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Stops a stream copying from a cached block
+ *----------------------------------------------------------------------------
+*/
+static void IMACacheRelease (S_PCM_STATE *pState)
+{
+    if (pState->pCacheEntry)
+    {
+        pState->pCacheEntry->numUsers--;
+        pState->pCacheEntry = NULL;
+    }
+}
+#endif
+
+/*----------------------------------------------------------------------------
+ * IMACacheFlush()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Drops the cached blocks of a stream when its file is closed, the file
+ * handle may be reused for another file
+ *----------------------------------------------------------------------------
+*/
+/*lint -esym(715, pEASData) used only with the block cache */
+void IMACacheFlush (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState)
+{
+#if (IMA_CACHE_BLOCKS > 0)
+    S_IMA_CACHE_ENTRY *pEntry;
+    EAS_INT i;
+
+    IMACacheRelease(pState);
+    if (pEASData->pIMACache == NULL)
+        return;
+    for (i = 0, pEntry = pEASData->pIMACache->entries; i < IMA_CACHE_BLOCKS; i++, pEntry++)
+    {
+        if (pEntry->fileHandle == pState->fileHandle)
+        {
+            pEntry->fileHandle = NULL;
+            pEntry->lastUsed = 0;
+        }
+    }
 #endif
 }
 
@@ -349,6 +567,10 @@ static EAS_RESULT IMADecoderLocate (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pStat
 
     }
 
+#if (IMA_CACHE_BLOCKS > 0)
+    IMACacheRelease(pState);
+#endif
+
     /* seek to new location */
     if ((result = EAS_PESeek(pEASData, pState, &temp)) != EAS_SUCCESS)
         return result;
@@ -119,6 +119,7 @@
 #include "eas_data.h"
 #include "eas_host.h"
 #include "eas_mdls.h"
+#include "eas_atomic.h"
 #include "eas_math.h"
 #include "dls.h"
 #include "dls2.h"
@@ -403,6 +404,21 @@ static const EAS_U32 outputSampleRate = _OUTPUT_SAMPLE_RATE;
 static const EAS_I32 dlsRateConvert = DLS_RATE_CONVERT;
 static const EAS_I32 dlsLFOFrequencyConvert = DLS_LFO_FREQUENCY_CONVERT;
 
+/* process-wide cache of collections loaded by EAS_LoadDLSCollection, keyed by file size and content */
+#ifndef DLS_CACHE_SIZE
+#define DLS_CACHE_SIZE 8
+#endif
+
+typedef struct
+{
+    S_DLS       *pDLS;
+    EAS_I32     size;
+    uint64_t    hash;
+} S_DLS_CACHE_ENTRY;
+
+static S_DLS_CACHE_ENTRY dlsCache[DLS_CACHE_SIZE];
+static EAS_UINT dlsCacheLock;
+
 /*------------------------------------
  * inline functions
  *------------------------------------
@@ -439,6 +455,8 @@ static EAS_I16 ConvertSustain (EAS_I32 sustain);
 static EAS_I16 ConvertLFOPhaseIncrement (EAS_I32 pitchCents);
 static EAS_I8 ConvertPan (EAS_I32 pan);
 static EAS_U8 ConvertQ (EAS_I32 q);
+static void BuildProgramHash (S_DLS *pDLS);
+static void DLSCacheRelease (EAS_HW_DATA_HANDLE hwInstData, S_DLS *pDLS);
 
 #ifdef _DEBUG_DLS
 static void DumpDLS (S_EAS *pEAS);
@@ -641,7 +659,7 @@ EAS_RESULT DLSParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle,
         waveLenSize = (EAS_I32) (dls.waveCount * sizeof(EAS_U32));
 
         /* calculate final memory size */
-        size = (EAS_I32) sizeof(S_EAS) + instSize + rgnPoolSize + artPoolSize + (2 * waveLenSize) + (EAS_I32) dls.wavePoolSize;
+        size = (EAS_I32) sizeof(S_DLS) + instSize + rgnPoolSize + artPoolSize + (2 * waveLenSize) + (EAS_I32) dls.wavePoolSize;
         if (size <= 0) {
             EAS_HWFree(dls.hwInstData, dls.wsmpData);
             return EAS_ERROR_FILE_FORMAT;
@@ -657,7 +675,7 @@ EAS_RESULT DLSParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle,
         }
         EAS_HWMemSet(dls.pDLS, 0, size);
         dls.pDLS->refCount = 1;
-        p = PtrOfs(dls.pDLS, sizeof(S_EAS));
+        p = PtrOfs(dls.pDLS, sizeof(S_DLS));
 
         /* setup pointer to programs */
         dls.pDLS->numDLSPrograms = (EAS_U16) dls.instCount;
@@ -711,6 +729,7 @@ EAS_RESULT DLSParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle,
     /* if successful, return a pointer to the EAS collection */
     if (result == EAS_SUCCESS)
     {
+        BuildProgramHash(dls.pDLS);
         *ppDLS = dls.pDLS;
 #ifdef _DEBUG_DLS
         DumpDLS(dls.pDLS);
@@ -744,9 +763,11 @@ EAS_RESULT DLSCleanup (EAS_HW_DATA_HANDLE hwInstData, S_DLS *pDLS)
     /* free the allocated memory */
     if (pDLS)
     {
-        if (pDLS->refCount)
+        if (pDLS->cached)
+            DLSCacheRelease(hwInstData, pDLS);
+        else if (EAS_AtomicLoadAcquire(&pDLS->refCount))
         {
-            if (--pDLS->refCount == 0)
+            if (EAS_AtomicDecrement(&pDLS->refCount) == 0)
                 EAS_HWFree(hwInstData, pDLS);
         }
     }
@@ -762,7 +783,231 @@ EAS_RESULT DLSCleanup (EAS_HW_DATA_HANDLE hwInstData, S_DLS *pDLS)
 void DLSAddRef (S_DLS *pDLS)
 {
     if (pDLS)
-        pDLS->refCount++;
+        (void) EAS_AtomicIncrement(&pDLS->refCount);
+}
+
+/*----------------------------------------------------------------------------
+ * DLSCacheLock ()
+ *----------------------------------------------------------------------------
+ * The cache lock is only held to search or change the cache table, so
+ * a spin lock is good enough
+ *----------------------------------------------------------------------------
+*/
+static void DLSCacheLock (void)
+{
+    while (EAS_AtomicExchange(&dlsCacheLock, 1) != 0)
+    {
+        while (EAS_AtomicLoadAcquire(&dlsCacheLock) != 0)
+        {
+        }
+    }
+}
+
+static void DLSCacheUnlock (void)
+{
+    EAS_AtomicStoreRelease(&dlsCacheLock, 0);
+}
+
+/*----------------------------------------------------------------------------
+ * DLSCacheFind ()
+ *----------------------------------------------------------------------------
+ * Looks up a collection by size and content hash and adds a reference to
+ * it. Must be called with the cache locked.
+ *----------------------------------------------------------------------------
+*/
+static S_DLS *DLSCacheFind (EAS_I32 size, uint64_t hash)
+{
+    EAS_INT i;
+
+    for (i = 0; i < DLS_CACHE_SIZE; i++)
+    {
+        if (dlsCache[i].pDLS && (dlsCache[i].size == size) && (dlsCache[i].hash == hash))
+        {
+            DLSAddRef(dlsCache[i].pDLS);
+            return dlsCache[i].pDLS;
+        }
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * DLSCacheRelease ()
+ *----------------------------------------------------------------------------
+ * Drops a reference to a cached collection. The last reference removes
+ * the collection from the cache, under the lock so that a concurrent
+ * DLSCacheLoad cannot pick it up again.
+ *----------------------------------------------------------------------------
+*/
+static void DLSCacheRelease (EAS_HW_DATA_HANDLE hwInstData, S_DLS *pDLS)
+{
+    EAS_INT i;
+
+    DLSCacheLock();
+    if (EAS_AtomicDecrement(&pDLS->refCount) != 0)
+    {
+        DLSCacheUnlock();
+        return;
+    }
+    for (i = 0; i < DLS_CACHE_SIZE; i++)
+    {
+        if (dlsCache[i].pDLS == pDLS)
+            dlsCache[i].pDLS = NULL;
+    }
+    DLSCacheUnlock();
+    EAS_HWFree(hwInstData, pDLS);
+}
+
+/*----------------------------------------------------------------------------
+ * DLSCacheHash ()
+ *----------------------------------------------------------------------------
+ * FNV-1a hash of the whole file, which is the cache key along with the
+ * file size
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT DLSCacheHash (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle, EAS_I32 size, uint64_t *pHash)
+{
+    EAS_U8 buffer[1024];
+    EAS_RESULT result;
+    EAS_I32 count;
+    EAS_I32 i;
+    uint64_t hash;
+
+    if ((result = EAS_HWFileSeek(hwInstData, fileHandle, 0)) != EAS_SUCCESS)
+        return result;
+    hash = 0xcbf29ce484222325ULL;
+    while (size > 0)
+    {
+        count = size < (EAS_I32) sizeof(buffer) ? size : (EAS_I32) sizeof(buffer);
+        if ((result = EAS_HWReadFile(hwInstData, fileHandle, buffer, count, &count)) != EAS_SUCCESS)
+            return result;
+        for (i = 0; i < count; i++)
+            hash = (hash ^ buffer[i]) * 0x00000100000001b3ULL;
+        size -= count;
+    }
+    *pHash = hash;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * DLSCacheLoad ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns a reference to a collection with the same content from the
+ * process-wide cache, or parses the file and adds the collection to the
+ * cache. Parsing is done without holding the lock; if two threads load
+ * the same file at once, the collection that is listed first wins and
+ * the other one is freed.
+ *
+ * The collection is allocated through hwInstData and may be freed
+ * through any other instance, so the instance must allocate from the
+ * heap.
+ *
+ * Inputs:
+ * hwInstData - host instance data
+ * fileHandle - DLS file, read from offset 0
+ *
+ * Outputs:
+ * EAS_RESULT
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT DLSCacheLoad (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle, S_DLS **ppDLS)
+{
+    EAS_RESULT result;
+    EAS_I32 size;
+    uint64_t hash;
+    S_DLS *pDLS;
+    S_DLS *pCached;
+    EAS_INT i;
+
+    *ppDLS = NULL;
+    if ((result = EAS_HWFileLength(hwInstData, fileHandle, &size)) != EAS_SUCCESS)
+        return result;
+    if ((result = DLSCacheHash(hwInstData, fileHandle, size, &hash)) != EAS_SUCCESS)
+        return result;
+
+    /* already loaded by another instance */
+    DLSCacheLock();
+    pCached = DLSCacheFind(size, hash);
+    DLSCacheUnlock();
+    if (pCached)
+    {
+        *ppDLS = pCached;
+        return EAS_SUCCESS;
+    }
+
+    if ((result = DLSParser(hwInstData, fileHandle, 0, &pDLS)) != EAS_SUCCESS)
+        return result;
+
+    /* list it, unless another thread got there first */
+    DLSCacheLock();
+    if ((pCached = DLSCacheFind(size, hash)) == NULL)
+    {
+        for (i = 0; i < DLS_CACHE_SIZE; i++)
+        {
+            if (dlsCache[i].pDLS == NULL)
+            {
+                dlsCache[i].size = size;
+                dlsCache[i].hash = hash;
+                dlsCache[i].pDLS = pDLS;
+                pDLS->cached = EAS_TRUE;
+                break;
+            }
+        }
+    }
+    DLSCacheUnlock();
+
+    /* a full cache just leaves the collection private */
+    if (pCached)
+    {
+        DLSCleanup(hwInstData, pDLS);
+        pDLS = pCached;
+    }
+    *ppDLS = pDLS;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * BuildProgramHash ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Builds the open-addressed hash of program indices used by the voice
+ * manager to look up programs by locale. If the collection has several
+ * programs with the same locale, only the first one is entered, which
+ * matches the result of a linear search.
+ *
+ * Inputs:
+ * pDLS - pointer to DLS collection
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void BuildProgramHash (S_DLS *pDLS)
+{
+    EAS_U16 i;
+    EAS_U16 slot;
+    EAS_U16 index;
+
+    for (i = 0; i < DLS_PROGRAM_HASH_SIZE; i++)
+        pDLS->programHash[i] = DLS_PROGRAM_HASH_EMPTY;
+
+    for (i = 0; i < pDLS->numDLSPrograms; i++)
+    {
+        slot = DLS_PROGRAM_HASH(pDLS->pDLSPrograms[i].locale);
+        for (;;)
+        {
+            index = pDLS->programHash[slot];
+            if (index == DLS_PROGRAM_HASH_EMPTY)
+            {
+                pDLS->programHash[slot] = i;
+                break;
+            }
+            if (pDLS->pDLSPrograms[index].locale == pDLS->pDLSPrograms[i].locale)
+                break;
+            slot = (slot + 1) & (DLS_PROGRAM_HASH_SIZE - 1);
+        }
+    }
 }
 
 /*----------------------------------------------------------------------------
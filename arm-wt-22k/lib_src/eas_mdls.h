@@ -283,6 +283,7 @@ typedef struct s_dls_params
 EAS_RESULT DLSParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle, EAS_I32 offset, S_DLS **pDLS);
 EAS_RESULT DLSCleanup (EAS_HW_DATA_HANDLE hwInstData, S_DLS *pDLS);
 void DLSAddRef (S_DLS *pDLS);
+EAS_RESULT DLSCacheLoad (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle, S_DLS **ppDLS);
 EAS_I16 ConvertDelay (EAS_I32 timeCents);
 EAS_I16 ConvertRate (EAS_I32 timeCents);
 
@@ -69,7 +69,7 @@ typedef enum
 } E_SYSEX_STATES;
 
 /* local prototypes */
-static EAS_RESULT ProcessMIDIMessage (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, EAS_INT parserMode);
+static EAS_RESULT ProcessMIDIMessage (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, EAS_U8 status, EAS_U8 d1, EAS_U8 d2, EAS_INT parserMode);
 static EAS_RESULT ProcessSysExMessage (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, EAS_U8 c, EAS_INT parserMode);
 
 /*----------------------------------------------------------------------------
@@ -149,7 +149,7 @@ EAS_RESULT EAS_ParseMIDIStream (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_ST
         pMIDIStream->pending = EAS_FALSE;
         if (parserMode == eParserModeMetaData)
             return EAS_SUCCESS;
-        return ProcessMIDIMessage(pEASData, pSynth, pMIDIStream, parserMode);
+        return ProcessMIDIMessage(pEASData, pSynth, pMIDIStream, pMIDIStream->status, pMIDIStream->d1, pMIDIStream->d2, parserMode);
     }
 
     /* check for status received */
@@ -175,7 +175,7 @@ EAS_RESULT EAS_ParseMIDIStream (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_ST
             pMIDIStream->pending = EAS_FALSE;
             if (parserMode == eParserModeMetaData)
                 return EAS_SUCCESS;
-            return ProcessMIDIMessage(pEASData, pSynth, pMIDIStream, parserMode);
+            return ProcessMIDIMessage(pEASData, pSynth, pMIDIStream, pMIDIStream->status, pMIDIStream->d1, pMIDIStream->d2, parserMode);
         }
 
         /* check for more 3-bytes message */
@@ -212,6 +212,46 @@ EAS_RESULT EAS_ParseMIDIStream (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_ST
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_ParseMIDIMessages()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Processes a buffer of complete channel messages, packed one per 32-bit
+ * word as in a MIDI 1.0 channel voice Universal MIDI Packet: status in
+ * bits 16-23, first data byte in bits 8-15 and second data byte in bits
+ * 0-7. The upper byte is ignored. Messages skip the byte parser, so they
+ * neither use nor change the stream running status. System messages are
+ * ignored.
+ *
+ * Inputs:
+ * pMessages    - pointer to packed messages
+ * count        - number of messages
+ *
+ * Outputs:
+ * returns EAS_RESULT (EAS_SUCCESS is OK)
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_ParseMIDIMessages (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, const uint32_t *pMessages, EAS_I32 count, EAS_INT parserMode)
+{
+    EAS_RESULT result;
+    EAS_U8 status;
+    uint32_t msg;
+
+    while (count--)
+    {
+        msg = *pMessages++;
+        status = (EAS_U8) (msg >> 16);
+        if ((status < 0x80) || (status >= 0xf0))
+            continue;
+        if ((result = ProcessMIDIMessage(pEASData, pSynth, pMIDIStream, status, (EAS_U8) ((msg >> 8) & 0x7f), (EAS_U8) (msg & 0x7f), parserMode)) != EAS_SUCCESS)
+            return result;
+    }
+    return EAS_SUCCESS;
+}
+
 /*----------------------------------------------------------------------------
  * ProcessMIDIMessage()
  *----------------------------------------------------------------------------
@@ -229,81 +269,81 @@ EAS_RESULT EAS_ParseMIDIStream (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_ST
  *
  *----------------------------------------------------------------------------
 */
-static EAS_RESULT ProcessMIDIMessage (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, EAS_INT parserMode)
+static EAS_RESULT ProcessMIDIMessage (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, EAS_U8 status, EAS_U8 d1, EAS_U8 d2, EAS_INT parserMode)
 {
     EAS_U8 channel;
 
-    channel = pMIDIStream->status & 0x0f;
-    switch (pMIDIStream->status & 0xf0)
+    channel = status & 0x0f;
+    switch (status & 0xf0)
     {
     case 0x80:
         { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL,"NoteOff: %02x %02x %02x\n",
-            pMIDIStream->status, pMIDIStream->d1, pMIDIStream->d2); */ }
+            status, d1, d2); */ }
         if (parserMode <= eParserModeMute)
-            VMStopNote(pEASData->pVoiceMgr, pSynth, channel, pMIDIStream->d1, pMIDIStream->d2);
+            VMStopNote(pEASData->pVoiceMgr, pSynth, channel, d1, d2);
         break;
 
     case 0x90:
-        if (pMIDIStream->d2)
+        if (d2)
         {
             { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL,"NoteOn: %02x %02x %02x\n",
-                pMIDIStream->status, pMIDIStream->d1, pMIDIStream->d2); */ }
+                status, d1, d2); */ }
             pMIDIStream->flags |= MIDI_FLAG_FIRST_NOTE;
             if (parserMode == eParserModePlay)
-                VMStartNote(pEASData->pVoiceMgr, pSynth, channel, pMIDIStream->d1, pMIDIStream->d2);
+                VMStartNote(pEASData->pVoiceMgr, pSynth, channel, d1, d2);
         }
         else
         {
             { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL,"NoteOff: %02x %02x %02x\n",
-                pMIDIStream->status, pMIDIStream->d1, pMIDIStream->d2); */ }
+                status, d1, d2); */ }
             if (parserMode <= eParserModeMute)
-                VMStopNote(pEASData->pVoiceMgr, pSynth, channel, pMIDIStream->d1, pMIDIStream->d2);
+                VMStopNote(pEASData->pVoiceMgr, pSynth, channel, d1, d2);
         }
         break;
 
     case 0xa0:
         { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL,"PolyPres: %02x %02x %02x\n",
-            pMIDIStream->status, pMIDIStream->d1, pMIDIStream->d2); */ }
+            status, d1, d2); */ }
         break;
 
     case 0xb0:
         { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL,"Control: %02x %02x %02x\n",
-            pMIDIStream->status, pMIDIStream->d1, pMIDIStream->d2); */ }
+            status, d1, d2); */ }
         if (parserMode <= eParserModeMute)
-            VMControlChange(pEASData->pVoiceMgr, pSynth, channel, pMIDIStream->d1, pMIDIStream->d2);
+            VMControlChange(pEASData->pVoiceMgr, pSynth, channel, d1, d2);
 #ifdef JET_INTERFACE
         if (pMIDIStream->jetData & MIDI_FLAGS_JET_CB)
         {
             JET_Event(pEASData, pMIDIStream->jetData & (JET_EVENT_SEG_MASK | JET_EVENT_TRACK_MASK),
-                channel, pMIDIStream->d1, pMIDIStream->d2);
+                channel, d1, d2);
         }
 #endif
         break;
 
     case 0xc0:
         { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL,"Program: %02x %02x\n",
-            pMIDIStream->status, pMIDIStream->d1); */ }
+            status, d1); */ }
         if (parserMode <= eParserModeMute)
-            VMProgramChange(pEASData->pVoiceMgr, pSynth, channel, pMIDIStream->d1);
+            VMProgramChange(pEASData->pVoiceMgr, pSynth, channel, d1);
         break;
 
     case 0xd0:
         { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL,"ChanPres: %02x %02x\n",
-            pMIDIStream->status, pMIDIStream->d1); */ }
+            status, d1); */ }
         if (parserMode <= eParserModeMute)
-            VMChannelPressure(pSynth, channel, pMIDIStream->d1);
+            VMChannelPressure(pSynth, channel, d1);
         break;
 
     case 0xe0:
         { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL,"PBend: %02x %02x %02x\n",
-            pMIDIStream->status, pMIDIStream->d1, pMIDIStream->d2); */ }
+            status, d1, d2); */ }
         if (parserMode <= eParserModeMute)
-            VMPitchBend(pSynth, channel, pMIDIStream->d1, pMIDIStream->d2);
+            VMPitchBend(pSynth, channel, d1, d2);
         break;
 
     default:
         { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL,"Unknown: %02x %02x %02x\n",
-            pMIDIStream->status, pMIDIStream->d1, pMIDIStream->d2); */ }
+            status, d1, d2); */ }
     }
     return EAS_SUCCESS;
 }
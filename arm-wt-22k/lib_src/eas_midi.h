@@ -67,5 +67,25 @@ void EAS_InitMIDIStream (S_MIDI_STREAM *pMIDIStream);
 */
 EAS_RESULT EAS_ParseMIDIStream (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, EAS_U8 c, EAS_INT parserMode);
 
+/*----------------------------------------------------------------------------
+ * EAS_ParseMIDIMessages()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Processes a buffer of complete channel messages packed in 32-bit words,
+ * bypassing the byte-oriented parser.
+ *
+ * Inputs:
+ * pMessages    - pointer to packed messages (see EAS_WriteMIDIMessages)
+ * count        - number of messages
+ *
+ * Outputs:
+ * returns EAS_RESULT (EAS_SUCCESS is OK)
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_ParseMIDIMessages (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, const uint32_t *pMessages, EAS_I32 count, EAS_INT parserMode);
+
 #endif /* #define _EAS_MIDI_H */
 
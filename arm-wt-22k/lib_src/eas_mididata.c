@@ -30,5 +30,7 @@
 
 #include "eas_miditypes.h"
 
+/* the static memory model allocates its single instance here */
+#ifdef _STATIC_MEMORY
 S_INTERACTIVE_MIDI eas_MIDIData;
-
+#endif
@@ -31,6 +31,7 @@
 #include "eas_data.h"
 #include "eas_mixer.h"
 
-// globals
+/* the static memory model allocates its single instance here */
+#ifdef _STATIC_MEMORY
 EAS_I32 eas_MixBuffer[BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS];
-
+#endif
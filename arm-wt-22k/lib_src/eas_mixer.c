@@ -41,6 +41,7 @@
 #include "eas_mixer.h"
 #include "eas_config.h"
 #include "eas_report.h"
+#include "eas_vm_protos.h"
 
 #ifdef _MAXIMIZER_ENABLED
 EAS_I32 MaximizerProcess (EAS_VOID_PTR pInstData, EAS_I32 *pSrc, EAS_I32 *pDst, EAS_I32 numSamples);
@@ -117,6 +118,291 @@ void EAS_MixEnginePrep (S_EAS_DATA *pEASData, EAS_I32 numSamples)
     /* need to clear other side-chain effect buffers (chorus & reverb) */
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_MixBufferSilent
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns EAS_TRUE if the mix buffer holds only zeros. Stops at the first
+ * non-zero sample, so it costs next to nothing while audio is playing.
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL EAS_MixBufferSilent (const EAS_I32 *pMixBuffer, EAS_I32 numSamples)
+{
+    while (numSamples--)
+        if (*pMixBuffer++ != 0)
+            return EAS_FALSE;
+    return EAS_TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_MixEngineStems
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Converts the stem buses to the stem output buffers with the gain used for
+ * the mix. The stems are dry, the effects only process the mix.
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void EAS_MixEngineStems (S_EAS_DATA *pEASData, EAS_U16 gain, EAS_I32 numSamples)
+{
+    EAS_I32 *pBus;
+    EAS_INT bus;
+
+    for (bus = 0; bus < pEASData->pVoiceMgr->numStemBuses; bus++)
+    {
+        /* the host may not want every stem */
+        if (pEASData->ppStemOutput[bus] == NULL)
+            continue;
+
+        /* a bus no voice was mixed into is silent */
+        if ((pBus = VMGetStemBus(pEASData->pVoiceMgr, bus)) == NULL)
+            EAS_HWMemSet(pEASData->ppStemOutput[bus], 0, numSamples * NUM_OUTPUT_CHANNELS * (EAS_I32) sizeof(EAS_PCM));
+        else
+            SynthMasterGain(pBus, pEASData->ppStemOutput[bus], gain, (EAS_U16) (numSamples * NUM_OUTPUT_CHANNELS));
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_MixEngineFormat
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Converts the mix buffer to the 32-bit output format, applying the master
+ * gain in the same pass. The effects run on the 16-bit output buffer, what
+ * they changed there is added to the full precision mix. For EAS_RenderMix
+ * the result is scaled by the mix gain and added to the output buffer.
+ * Planar output is written one channel at a time, 16-bit planar output is
+ * the 16-bit output buffer split into channels.
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void EAS_MixEngineFormat (S_EAS_DATA *pEASData, EAS_U16 gain, EAS_I32 numSamples)
+{
+    const EAS_I32 *pMix;
+    const EAS_PCM *pFx;
+    EAS_VOID_PTR pOut;
+    EAS_BOOL mix;
+    EAS_I32 sampleSize;
+    EAS_I32 step;
+    EAS_I32 s;
+    EAS_I32 fx;
+    EAS_I32 i;
+    EAS_INT ch;
+
+    mix = pEASData->formatMix;
+    sampleSize = (pEASData->outputFormat == EAS_FORMAT_PCM16) ? (EAS_I32) sizeof(EAS_PCM) : (EAS_I32) sizeof(EAS_I32);
+    step = pEASData->pFormatRight ? 1 : NUM_OUTPUT_CHANNELS;
+
+    for (ch = 0; ch < NUM_OUTPUT_CHANNELS; ch++)
+    {
+        /* interleaved channels start one sample apart, planar ones in their own buffers */
+        if (pEASData->pFormatRight)
+            pOut = ch ? pEASData->pFormatRight : pEASData->pFormatOutput;
+        else
+            pOut = (EAS_U8*) pEASData->pFormatOutput + ch * sampleSize;
+
+        /* nothing in the mix and no effect tail */
+        if (pEASData->silentFrame)
+        {
+            if (mix)
+                return;
+            if (step == 1)
+                EAS_HWMemSet(pOut, 0, numSamples * sampleSize);
+            else if (ch == 0)
+                EAS_HWMemSet(pOut, 0, numSamples * NUM_OUTPUT_CHANNELS * sampleSize);
+            continue;
+        }
+
+        pMix = pEASData->pMixBuffer + ch;
+        pFx = pEASData->pOutputAudioBuffer + ch;
+        if (pEASData->outputFormat == EAS_FORMAT_PCM16)
+        {
+            EAS_PCM *pDst = (EAS_PCM*) pOut;
+
+            /* the effects output is final */
+            for (i = 0; i < numSamples; i++)
+            {
+                *pDst = *pFx;
+                pFx += NUM_OUTPUT_CHANNELS;
+                pDst += step;
+            }
+        }
+        else if (pEASData->outputFormat == EAS_FORMAT_FLOAT32)
+        {
+            float *pDst = (float*) pOut;
+            float scale = (float) gain * (1.0f / 2147483648.0f);
+            float fxScale = 1.0f / 32768.0f;
+            float v;
+
+            if (mix)
+            {
+                scale *= (float) pEASData->formatMixGain * (1.0f / EAS_MIX_UNITY_GAIN);
+                fxScale *= (float) pEASData->formatMixGain * (1.0f / EAS_MIX_UNITY_GAIN);
+            }
+
+            /* full scale is 1.0, the mix is not clipped */
+            for (i = 0; i < numSamples; i++)
+            {
+                s = *pMix;
+                pMix += NUM_OUTPUT_CHANNELS;
+                /*lint -e{704} <same rounding as SynthMasterGain>*/
+                fx = (EAS_I32) *pFx - SATURATE(((s >> 7) * (EAS_I32) gain) >> 9);
+                pFx += NUM_OUTPUT_CHANNELS;
+                v = (float) s * scale + (float) fx * fxScale;
+                if (mix)
+                    v += *pDst;
+                *pDst = v;
+                pDst += step;
+            }
+        }
+        else
+        {
+            EAS_I32 *pDst = (EAS_I32*) pOut;
+            EAS_INT shift = (pEASData->outputFormat == EAS_FORMAT_INT32_MIX) ? 23 : 15;
+            long long v;
+
+            /* full scale is 2^31, or 2^23 in an EAS_FORMAT_INT32_MIX buffer */
+            for (i = 0; i < numSamples; i++)
+            {
+                s = *pMix;
+                pMix += NUM_OUTPUT_CHANNELS;
+                /*lint -e{704} <same rounding as SynthMasterGain>*/
+                fx = (EAS_I32) *pFx - SATURATE(((s >> 7) * (EAS_I32) gain) >> 9);
+                pFx += NUM_OUTPUT_CHANNELS;
+                v = (long long) s * gain + (long long) fx * 65536;
+                if (mix)
+                    v = ((v * pEASData->formatMixGain) >> shift) + *pDst;
+                if (v > 0x7fffffffLL)
+                    v = 0x7fffffffLL;
+                else if (v < -0x80000000LL)
+                    v = -0x80000000LL;
+                *pDst = (EAS_I32) v;
+                pDst += step;
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_MixEngineResampled
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Writes the resampler output to the 32-bit output format or the planar
+ * buffers, as EAS_MixEngineFormat does at the compiled sample rate. The
+ * 32-bit formats are converted from the float output of the resampler,
+ * which already holds the master gain and the effects, 16-bit planar
+ * output is its 16-bit output split into channels.
+ *
+ * Inputs:
+ * pEASData         - instance data
+ * pPCM             - 16-bit resampler output
+ * pFloat           - float resampler output, full scale 1.0
+ * numSamples       - number of output frames
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_MixEngineResampled (S_EAS_DATA *pEASData, const EAS_PCM *pPCM, const float *pFloat, EAS_I32 numSamples)
+{
+    EAS_VOID_PTR pOut;
+    EAS_BOOL mix;
+    EAS_I32 sampleSize;
+    EAS_I32 step;
+    EAS_I32 i;
+    EAS_INT ch;
+    float gain;
+
+    mix = pEASData->formatMix;
+    sampleSize = (pEASData->outputFormat == EAS_FORMAT_PCM16) ? (EAS_I32) sizeof(EAS_PCM) : (EAS_I32) sizeof(EAS_I32);
+    step = pEASData->pFormatRight ? 1 : NUM_OUTPUT_CHANNELS;
+    gain = mix ? (float) pEASData->formatMixGain * (1.0f / EAS_MIX_UNITY_GAIN) : 1.0f;
+
+    for (ch = 0; ch < NUM_OUTPUT_CHANNELS; ch++)
+    {
+        /* interleaved channels start one sample apart, planar ones in their own buffers */
+        if (pEASData->pFormatRight)
+            pOut = ch ? pEASData->pFormatRight : pEASData->pFormatOutput;
+        else
+            pOut = (EAS_U8*) pEASData->pFormatOutput + ch * sampleSize;
+
+        /* nothing in the resampler output */
+        if (pEASData->silentFrame)
+        {
+            if (mix)
+                return;
+            if (step == 1)
+                EAS_HWMemSet(pOut, 0, numSamples * sampleSize);
+            else if (ch == 0)
+                EAS_HWMemSet(pOut, 0, numSamples * NUM_OUTPUT_CHANNELS * sampleSize);
+            continue;
+        }
+
+        if (pEASData->outputFormat == EAS_FORMAT_PCM16)
+        {
+            const EAS_PCM *pSrc = pPCM + ch;
+            EAS_PCM *pDst = (EAS_PCM*) pOut;
+
+            for (i = 0; i < numSamples; i++)
+            {
+                *pDst = *pSrc;
+                pSrc += NUM_OUTPUT_CHANNELS;
+                pDst += step;
+            }
+        }
+        else if (pEASData->outputFormat == EAS_FORMAT_FLOAT32)
+        {
+            const float *pSrc = pFloat + ch;
+            float *pDst = (float*) pOut;
+            float v;
+
+            for (i = 0; i < numSamples; i++)
+            {
+                v = *pSrc * gain;
+                pSrc += NUM_OUTPUT_CHANNELS;
+                if (mix)
+                    v += *pDst;
+                *pDst = v;
+                pDst += step;
+            }
+        }
+        else
+        {
+            const float *pSrc = pFloat + ch;
+            EAS_I32 *pDst = (EAS_I32*) pOut;
+            float scale = gain * ((pEASData->outputFormat == EAS_FORMAT_INT32_MIX) ? 8388608.0f : 2147483648.0f);
+            long long v;
+
+            /* full scale is 2^31, or 2^23 in an EAS_FORMAT_INT32_MIX buffer */
+            for (i = 0; i < numSamples; i++)
+            {
+                v = (long long) (*pSrc * scale);
+                pSrc += NUM_OUTPUT_CHANNELS;
+                if (mix)
+                    v += *pDst;
+                if (v > 0x7fffffffLL)
+                    v = 0x7fffffffLL;
+                else if (v < -0x80000000LL)
+                    v = -0x80000000LL;
+                *pDst = (EAS_I32) v;
+                pDst += step;
+            }
+        }
+    }
+}
+
 /*----------------------------------------------------------------------------
  * EAS_MixEnginePost
  *----------------------------------------------------------------------------
@@ -130,11 +416,15 @@ void EAS_MixEnginePrep (S_EAS_DATA *pEASData, EAS_I32 numSamples)
  * Outputs:
  *
  * Notes:
+ * pEASData->silentFrame is set if the output is all zeros because the mix
+ * was silent and no effect is holding a tail.
  *----------------------------------------------------------------------------
 */
 void EAS_MixEnginePost (S_EAS_DATA *pEASData, EAS_I32 numSamples)
 {
     EAS_U16 gain;
+    EAS_BOOL silent;
+    EAS_INT i;
 
 //3 dls: Need to restore the mix engine metrics
 
@@ -168,12 +458,35 @@ void EAS_MixEnginePost (S_EAS_DATA *pEASData, EAS_I32 numSamples)
     gain = gain >> 4;
 #endif
 
-    /* convert 32-bit mix buffer to 16-bit output format */
+    /* a silent mix is a fill, the gain stage would only produce zeros */
+    silent = EAS_MixBufferSilent(pEASData->pMixBuffer, numSamples * NUM_OUTPUT_CHANNELS);
+    if (silent)
+        EAS_HWMemSet(pEASData->pOutputAudioBuffer, 0, numSamples * NUM_OUTPUT_CHANNELS * (EAS_I32) sizeof(EAS_PCM));
+    else
+    {
+        /* convert 32-bit mix buffer to 16-bit output format */
 #if (NUM_OUTPUT_CHANNELS == 2)
-    SynthMasterGain(pEASData->pMixBuffer, pEASData->pOutputAudioBuffer, gain, (EAS_U16) ((EAS_U16) numSamples * 2));
+        SynthMasterGain(pEASData->pMixBuffer, pEASData->pOutputAudioBuffer, gain, (EAS_U16) ((EAS_U16) numSamples * 2));
 #else
-    SynthMasterGain(pEASData->pMixBuffer, pEASData->pOutputAudioBuffer, gain, (EAS_U16) numSamples);
+        SynthMasterGain(pEASData->pMixBuffer, pEASData->pOutputAudioBuffer, gain, (EAS_U16) numSamples);
 #endif
+    }
+
+    /* the stems are converted with the same gain */
+    if (pEASData->ppStemOutput)
+        EAS_MixEngineStems(pEASData, gain, numSamples);
+
+    /* the effects keep the frame silent only if none of them holds a tail,
+     * those that do not report it are assumed to */
+    for (i = 0; silent && (i < NUM_EFFECTS_MODULES); i++)
+    {
+        if (pEASData->effectsModules[i].effectData == NULL)
+            continue;
+        if ((pEASData->effectsModules[i].effect->pfIsSilent == NULL) ||
+            !(*pEASData->effectsModules[i].effect->pfIsSilent)(pEASData->effectsModules[i].effectData))
+            silent = EAS_FALSE;
+    }
+    pEASData->silentFrame = (EAS_BOOL8) silent;
 
 #ifdef _ENHANCER_ENABLED
     /* enhancer effect */
@@ -248,6 +561,9 @@ void EAS_MixEnginePost (S_EAS_DATA *pEASData, EAS_I32 numSamples)
             numSamples);
 #endif
 
+    /* the 32-bit formats and planar output are written from the mix buffer */
+    if (pEASData->pFormatOutput)
+        EAS_MixEngineFormat(pEASData, gain, numSamples);
 }
 
 #ifndef NATIVE_EAS_KERNEL
@@ -98,6 +98,26 @@ void EAS_MixEnginePrep (EAS_DATA_HANDLE pEASData, EAS_I32 nNumSamplesToAdd);
 */
 void EAS_MixEnginePost (EAS_DATA_HANDLE pEASData, EAS_I32 nNumSamplesToAdd);
 
+/*----------------------------------------------------------------------------
+ * EAS_MixEngineResampled
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Writes the output of the resampler to the 32-bit output format or the
+ * planar buffers.
+ *
+ * Inputs:
+ * pEASData         - instance data
+ * pPCM             - 16-bit resampler output
+ * pFloat           - float resampler output
+ * numSamples       - number of output frames
+ *
+ * Outputs:
+ *
+ * Notes:
+ *----------------------------------------------------------------------------
+*/
+void EAS_MixEngineResampled (EAS_DATA_HANDLE pEASData, const EAS_PCM *pPCM, const float *pFloat, EAS_I32 numSamples);
+
 /*----------------------------------------------------------------------------
  * EAS_MixEngineShutdown()
  *----------------------------------------------------------------------------
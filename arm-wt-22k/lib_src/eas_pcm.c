@@ -35,6 +35,7 @@
 #include "eas_pcm.h"
 #include "eas_math.h"
 #include "eas_mixer.h"
+#include "eas_atomic.h"
 
 #define PCM_MIXER_GUARD_BITS (NUM_MIXER_GUARD_BITS + 1)
 
@@ -43,14 +44,15 @@
  *----------------------------------------------------------------------------
 */
 
-static EAS_RESULT LinearPCMDecode (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState);
+static EAS_RESULT LinearPCMDecodeBlock (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState);
 static EAS_RESULT LinearPCMLocate (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState, EAS_I32 time);
 
 static const S_DECODER_INTERFACE PCMDecoder =
 {
     NULL,
-    LinearPCMDecode,
+    NULL,
     LinearPCMLocate,
+    LinearPCMDecodeBlock,
 };
 
 /* SMAF ADPCM decoder */
@@ -80,6 +82,10 @@ static const S_DECODER_INTERFACE * const decoders[] =
     SMAF_7BIT_DECODER
 };
 
+#ifdef _STATIC_MEMORY
+extern EAS_PCM eas_PCMRing[MAX_PCM_STREAMS][PCM_RING_SIZE * 2];
+#endif
+
 /*----------------------------------------------------------------------------
  * Sample rate conversion
  *----------------------------------------------------------------------------
@@ -111,6 +117,14 @@ static EAS_RESULT RenderPCMStream (S_EAS_DATA *pEASData, S_PCM_STATE *pState, EA
 /* local prototypes */
 static S_PCM_STATE *FindSlot (S_EAS_DATA *pEASData, EAS_FILE_HANDLE fileHandle, EAS_PCM_CALLBACK pCallbackFunc, EAS_VOID_PTR cbInstData);
 static EAS_RESULT InitPCMStream (S_EAS_DATA *pEASData, S_PCM_STATE *pState);
+static void PCMRingFree (S_EAS_DATA *pEASData, S_PCM_STATE *pState);
+static S_PCM_PREFETCH *PCMPrefetchSlot (S_EAS_DATA *pEASData, S_PCM_STATE *pState);
+static void PCMPrefetchStart (S_EAS_DATA *pEASData, S_PCM_STATE *pState);
+static void PCMPrefetchRequest (S_PCM_STATE *pState, S_PCM_PREFETCH *pPrefetch);
+static void PCMPrefetchCancel (S_PCM_PREFETCH *pPrefetch);
+static EAS_BOOL PCMPrefetchRelease (S_EAS_DATA *pEASData, S_PCM_PREFETCH *pPrefetch);
+static void PCMPrefetchReleaseClosed (S_EAS_DATA *pEASData);
+static EAS_RESULT PCMReadFile (S_EAS_DATA *pEASData, S_PCM_STATE *pState, EAS_U8 *pBuffer, EAS_I32 n, EAS_I32 *pCount);
 
 /*----------------------------------------------------------------------------
  * EAS_PEInit()
@@ -130,8 +144,6 @@ static EAS_RESULT InitPCMStream (S_EAS_DATA *pEASData, S_PCM_STATE *pState);
 */
 EAS_RESULT EAS_PEInit (S_EAS_DATA *pEASData)
 {
-    S_PCM_STATE *pState;
-    EAS_INT i;
 
     /* check for static memory allocation */
     if (pEASData->staticMemoryModel)
@@ -146,6 +158,38 @@ EAS_RESULT EAS_PEInit (S_EAS_DATA *pEASData)
         return EAS_ERROR_MALLOC_FAILED;
     }
 
+    /* no slot holds a ring yet */
+    EAS_HWMemSet(pEASData->pPCMStreams, 0, sizeof(S_PCM_STATE) * MAX_PCM_STREAMS);
+    EAS_PEClear(pEASData);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_PEClear()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns all of the PCM streams to the free state. The streams must
+ * have been closed by their owners.
+ *
+ * Inputs:
+ *
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_PEClear (S_EAS_DATA *pEASData)
+{
+    S_PCM_STATE *pState;
+    EAS_INT i;
+
+    /* the rings are allocated again when the slots are reused */
+    for (i = 0, pState = pEASData->pPCMStreams; i < MAX_PCM_STREAMS; i++, pState++)
+        PCMRingFree(pEASData, pState);
+
     //zero the memory to insure complete initialization
     EAS_HWMemSet((void *)(pEASData->pPCMStreams),0, sizeof(S_PCM_STATE) * MAX_PCM_STREAMS);
 
@@ -153,7 +197,14 @@ EAS_RESULT EAS_PEInit (S_EAS_DATA *pEASData)
     for (i = 0, pState = pEASData->pPCMStreams; i < MAX_PCM_STREAMS; i++, pState++)
         pState->fileHandle = NULL;
 
-    return EAS_SUCCESS;
+    /* the streams have been closed, the I/O thread may still be reading for some */
+    PCMPrefetchReleaseClosed(pEASData);
+
+#if defined(_IMA_DECODER) && (IMA_CACHE_BLOCKS > 0)
+    /* nor do they hold cached blocks */
+    if (pEASData->pIMACache)
+        EAS_HWMemSet(pEASData->pIMACache, 0, sizeof(S_IMA_CACHE));
+#endif
 }
 
 /*----------------------------------------------------------------------------
@@ -175,14 +226,130 @@ EAS_RESULT EAS_PEInit (S_EAS_DATA *pEASData)
 EAS_RESULT EAS_PEShutdown (S_EAS_DATA *pEASData)
 {
 
+    /* the I/O thread has stopped, so every closed stream can be released */
+    PCMPrefetchReleaseClosed(pEASData);
+
     /* free any dynamic memory */
     if (!pEASData->staticMemoryModel)
     {
         if (pEASData->pPCMStreams)
         {
+            EAS_INT i;
+
+            for (i = 0; i < MAX_PCM_STREAMS; i++)
+                PCMRingFree(pEASData, &pEASData->pPCMStreams[i]);
             EAS_HWFree(pEASData->hwInstData, pEASData->pPCMStreams);
             pEASData->pPCMStreams = NULL;
         }
+        if (pEASData->pPCMPrefetch)
+        {
+            EAS_HWFree(pEASData->hwInstData, pEASData->pPCMPrefetch);
+            pEASData->pPCMPrefetch = NULL;
+        }
+#if defined(_IMA_DECODER) && (IMA_CACHE_BLOCKS > 0)
+        if (pEASData->pIMACache)
+        {
+            EAS_HWFree(pEASData->hwInstData, pEASData->pIMACache);
+            pEASData->pIMACache = NULL;
+        }
+#endif
+    }
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_PESetPrefetch()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Enables or disables read-ahead of linear PCM streams by EAS_PEPrefetch.
+ * Streams opened while it is enabled are read by the I/O thread.
+ *
+ * Inputs:
+ * pEASData         - pointer to EAS library instance data
+ * enable           - EAS_TRUE to allocate the prefetch buffers
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_PESetPrefetch (S_EAS_DATA *pEASData, EAS_BOOL enable)
+{
+    EAS_INT i;
+
+    /* the buffers belong to the stream slots, so no stream may be open */
+    for (i = 0; i < MAX_PCM_STREAMS; i++)
+        if (pEASData->pPCMStreams[i].fileHandle != NULL)
+            return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
+
+    if (!enable)
+    {
+        PCMPrefetchReleaseClosed(pEASData);
+        if (pEASData->pPCMPrefetch)
+        {
+            EAS_HWFree(pEASData->hwInstData, pEASData->pPCMPrefetch);
+            pEASData->pPCMPrefetch = NULL;
+        }
+        return EAS_SUCCESS;
+    }
+
+    if (pEASData->pPCMPrefetch)
+        return EAS_SUCCESS;
+    if (pEASData->staticMemoryModel)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+
+    if ((pEASData->pPCMPrefetch = EAS_HWMalloc(pEASData->hwInstData, sizeof(S_PCM_PREFETCH) * MAX_PCM_STREAMS)) == NULL)
+        return EAS_ERROR_MALLOC_FAILED;
+    EAS_HWMemSet(pEASData->pPCMPrefetch, 0, sizeof(S_PCM_PREFETCH) * MAX_PCM_STREAMS);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_PEPrefetch()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reads the buffers requested by the streams. This is the only function
+ * of the PCM engine that runs on the I/O thread.
+ *
+ * Inputs:
+ * pEASData         - pointer to EAS library instance data
+ * pNumReads        - pointer to variable to receive the number of buffers read
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_PEPrefetch (S_EAS_DATA *pEASData, EAS_I32 *pNumReads)
+{
+    S_PCM_PREFETCH *pPrefetch;
+    S_PCM_PREFETCH_BUFFER *pBuffer;
+    EAS_INT i, j;
+
+    *pNumReads = 0;
+    if (pEASData->pPCMPrefetch == NULL)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+
+    for (i = 0, pPrefetch = pEASData->pPCMPrefetch; i < MAX_PCM_STREAMS; i++, pPrefetch++)
+    {
+        for (j = 0; j < 2; j++)
+        {
+            pBuffer = &pPrefetch->buffers[j];
+
+            /* claiming the buffer stops the render thread from cancelling it */
+            if (!EAS_AtomicCompareExchange(&pBuffer->state, PCM_PREFETCH_PENDING, PCM_PREFETCH_BUSY))
+                continue;
+
+            pBuffer->count = 0;
+            if ((pBuffer->result = EAS_HWFileSeek(pEASData->hwInstData, pPrefetch->fileHandle, pBuffer->filePos)) == EAS_SUCCESS)
+                pBuffer->result = EAS_HWReadFile(pEASData->hwInstData, pPrefetch->fileHandle, pBuffer->data, pBuffer->size, &pBuffer->count);
+            EAS_AtomicStoreRelease(&pBuffer->state, PCM_PREFETCH_READY);
+            (*pNumReads)++;
+        }
     }
     return EAS_SUCCESS;
 }
@@ -209,6 +376,9 @@ EAS_RESULT EAS_PERender (S_EAS_DATA* pEASData, EAS_I32 numSamples)
     EAS_RESULT result;
     EAS_INT i;
 
+    /* close the handles of streams whose last read has finished */
+    PCMPrefetchReleaseClosed(pEASData);
+
     /* render all the active streams */
     for (i = 0, pState = pEASData->pPCMStreams; i < MAX_PCM_STREAMS; i++, pState++)
     {
@@ -267,11 +437,27 @@ EAS_RESULT EAS_PEState (S_EAS_DATA *pEASData, EAS_PCM_HANDLE pInstData, EAS_STAT
 */
 EAS_RESULT EAS_PEClose (S_EAS_DATA *pEASData, EAS_PCM_HANDLE pState)
 {
+    S_PCM_PREFETCH *pPrefetch;
     EAS_RESULT result;
 
+    /* a read in progress keeps its handle open until it finishes */
+    if ((pPrefetch = PCMPrefetchSlot(pEASData, pState)) != NULL)
+    {
+        PCMPrefetchCancel(pPrefetch);
+        pPrefetch->closed = EAS_TRUE;
+        (void) PCMPrefetchRelease(pEASData, pPrefetch);
+    }
+
+#ifdef _IMA_DECODER
+    /* the handle may be reused for another file */
+    if (pState->pDecoder == &IMADecoder)
+        IMACacheFlush(pEASData, pState);
+#endif
+
     if ((result = EAS_HWCloseFile(pEASData->hwInstData, pState->fileHandle)) != EAS_SUCCESS)
         return result;
 
+    PCMRingFree(pEASData, pState);
     pState->fileHandle = NULL;
     return EAS_SUCCESS;
 }
@@ -358,6 +544,46 @@ EAS_RESULT EAS_PEOpenStream (S_EAS_DATA *pEASData, S_PCM_OPEN_PARAMS *pParams, E
     }
 
     pState->pDecoder = decoders[pParams->decoder];
+
+    /* only the open streams of a block decoder hold a ring */
+    if (pState->pDecoder->pfDecodeBlock && (pState->pRing == NULL))
+    {
+#ifdef _STATIC_MEMORY
+        if (pEASData->staticMemoryModel)
+            pState->pRing = eas_PCMRing[pState - pEASData->pPCMStreams];
+        else
+#endif
+            pState->pRing = EAS_HWMalloc(pEASData->hwInstData, PCM_RING_BYTES);
+        if (pState->pRing == NULL)
+        {
+            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "Failed to allocate memory for PCM ring\n"); */ }
+            pState->fileHandle = NULL;
+            return EAS_ERROR_MALLOC_FAILED;
+        }
+    }
+
+    /* linear PCM held in memory is converted in place */
+    if (EAS_HWMapFile(pEASData->hwInstData, pState->fileHandle, &pState->pFileData, &pState->fileSize) != EAS_SUCCESS)
+        pState->pFileData = NULL;
+
+    /* other linear PCM streams without a callback can be read ahead, the
+     * callback of a streaming source may move the data at any time and
+     * the IMA ADPCM decoder reads through its block cache instead */
+    if (pEASData->pPCMPrefetch && (pState->pDecoder == &PCMDecoder) && (pState->pFileData == NULL) && (pState->pCallback == NULL))
+    {
+        S_PCM_PREFETCH *pPrefetch = &pEASData->pPCMPrefetch[pState - pEASData->pPCMStreams];
+
+        /* the slot is still waiting for a read of the previous stream, read synchronously */
+        if (!pPrefetch->closed || PCMPrefetchRelease(pEASData, pPrefetch))
+        {
+            EAS_HWMemSet(pPrefetch, 0, sizeof(S_PCM_PREFETCH));
+
+            /* out of file handles, read synchronously */
+            if (EAS_HWDupHandle(pEASData->hwInstData, pState->fileHandle, &pPrefetch->fileHandle) != EAS_SUCCESS)
+                pPrefetch->fileHandle = NULL;
+        }
+    }
+
     pState->startPos = filePos;
     pState->bytesLeftLoop = pState->byteCount = pParams->size;
     pState->loopStart = pParams->loopStart;
@@ -935,6 +1161,8 @@ static EAS_RESULT InitPCMStream (S_EAS_DATA *pEASData, S_PCM_STATE *pState)
     pState->decoderR.x0 = pState->decoderR.x1 = 0;
     pState->decoderR.step = 0;
     pState->hiNibble = EAS_FALSE;
+    pState->ringRead = 0;
+    pState->ringCount = 0;
     pState->pitch = 0;
     pState->blockCount = 0;
     pState->gainLeft = PCM_DEFAULT_GAIN_SETTING;
@@ -948,12 +1176,267 @@ static EAS_RESULT InitPCMStream (S_EAS_DATA *pEASData, S_PCM_STATE *pState)
 #endif
     pState->state = EAS_STATE_READY;
 
+    /* start reading ahead so the I/O thread can fill the first buffers before the first render */
+    PCMPrefetchStart(pEASData, pState);
+
     /* initialize the decoder */
     if (pState->pDecoder->pfInit)
         return (*pState->pDecoder->pfInit)(pEASData, pState);
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * PCMRingFree()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Frees the ring of a stream slot, the static ones stay with their slots
+ *----------------------------------------------------------------------------
+*/
+static void PCMRingFree (S_EAS_DATA *pEASData, S_PCM_STATE *pState)
+{
+    if (pState->pRing == NULL)
+        return;
+    if (!pEASData->staticMemoryModel)
+        EAS_HWFree(pEASData->hwInstData, pState->pRing);
+    pState->pRing = NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * PCMPrefetchSlot()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the prefetch state of a stream, or NULL if it is read synchronously
+ *----------------------------------------------------------------------------
+*/
+static S_PCM_PREFETCH *PCMPrefetchSlot (S_EAS_DATA *pEASData, S_PCM_STATE *pState)
+{
+    S_PCM_PREFETCH *pPrefetch;
+
+    if (pEASData->pPCMPrefetch == NULL)
+        return NULL;
+    pPrefetch = &pEASData->pPCMPrefetch[pState - pEASData->pPCMStreams];
+    return (pPrefetch->fileHandle && !pPrefetch->closed) ? pPrefetch : NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * PCMPrefetchStart()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Drops the buffers read ahead and starts again at the file position of
+ * the stream. Called whenever the stream is repositioned.
+ *----------------------------------------------------------------------------
+*/
+static void PCMPrefetchStart (S_EAS_DATA *pEASData, S_PCM_STATE *pState)
+{
+    S_PCM_PREFETCH *pPrefetch;
+
+    if ((pPrefetch = PCMPrefetchSlot(pEASData, pState)) == NULL)
+        return;
+
+    PCMPrefetchCancel(pPrefetch);
+    if (EAS_HWFilePos(pEASData->hwInstData, pState->fileHandle, &pPrefetch->nextPos) != EAS_SUCCESS)
+        return;
+    pPrefetch->nextLeft = pState->bytesLeft;
+    PCMPrefetchRequest(pState, pPrefetch);
+}
+
+/*----------------------------------------------------------------------------
+ * PCMPrefetchRequest()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Requests the next buffers in play order. A request never spans the end
+ * of the data, a looped stream continues at the loop start.
+ *----------------------------------------------------------------------------
+*/
+static void PCMPrefetchRequest (S_PCM_STATE *pState, S_PCM_PREFETCH *pPrefetch)
+{
+    S_PCM_PREFETCH_BUFFER *pBuffer;
+
+    while (pPrefetch->numQueued < 2)
+    {
+        /* the decoder rewinds to the loop start when it reaches the end */
+        if ((pPrefetch->nextLeft == 0) && (pState->loopSamples != 0))
+        {
+            pPrefetch->nextPos = pState->startPos + pState->loopLocation;
+            pPrefetch->nextLeft = pState->bytesLeftLoop;
+        }
+        if (pPrefetch->nextLeft <= 0)
+            break;
+
+        /* a cancelled buffer is reused once the I/O thread has finished with it */
+        pBuffer = &pPrefetch->buffers[(pPrefetch->head + pPrefetch->numQueued) & 1];
+        if (pBuffer->stale)
+        {
+            if (EAS_AtomicLoadAcquire(&pBuffer->state) != PCM_PREFETCH_READY)
+                break;
+            pBuffer->stale = EAS_FALSE;
+        }
+
+        /* split the last two buffers of a run evenly, a short last buffer
+         * could be used up in the same render that requests the next one */
+        pBuffer->filePos = pPrefetch->nextPos;
+        if (pPrefetch->nextLeft <= PCM_PREFETCH_SIZE)
+            pBuffer->size = pPrefetch->nextLeft;
+        else if (pPrefetch->nextLeft < 2 * PCM_PREFETCH_SIZE)
+            pBuffer->size = (pPrefetch->nextLeft >> 1) & ~3;
+        else
+            pBuffer->size = PCM_PREFETCH_SIZE;
+        pBuffer->readPos = 0;
+        pPrefetch->nextPos += pBuffer->size;
+        pPrefetch->nextLeft -= pBuffer->size;
+        EAS_AtomicStoreRelease(&pBuffer->state, PCM_PREFETCH_PENDING);
+        pPrefetch->numQueued++;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * PCMPrefetchCancel()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Cancels all requests. A buffer the I/O thread is reading is marked
+ * stale and dropped once it is ready, the render thread never waits.
+ *----------------------------------------------------------------------------
+*/
+static void PCMPrefetchCancel (S_PCM_PREFETCH *pPrefetch)
+{
+    S_PCM_PREFETCH_BUFFER *pBuffer;
+    EAS_INT i;
+
+    for (i = 0; i < 2; i++)
+    {
+        pBuffer = &pPrefetch->buffers[i];
+        if (EAS_AtomicCompareExchange(&pBuffer->state, PCM_PREFETCH_PENDING, PCM_PREFETCH_FREE))
+            continue;
+
+        if (EAS_AtomicLoadAcquire(&pBuffer->state) == PCM_PREFETCH_BUSY)
+        {
+            pBuffer->stale = EAS_TRUE;
+            continue;
+        }
+        pBuffer->stale = EAS_FALSE;
+        EAS_AtomicStoreRelease(&pBuffer->state, PCM_PREFETCH_FREE);
+    }
+
+    /* new requests start with a buffer that is not in use */
+    pPrefetch->head = pPrefetch->buffers[0].stale ? 1 : 0;
+    pPrefetch->numQueued = 0;
+    pPrefetch->nextLeft = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * PCMPrefetchRelease()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Closes the duplicate handle of a closed stream once the I/O thread has
+ * no buffer of the slot left to read. Returns EAS_TRUE if the slot is free.
+ * The handle is closed on the render thread, as the host file table is
+ * not shared with the I/O thread.
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL PCMPrefetchRelease (S_EAS_DATA *pEASData, S_PCM_PREFETCH *pPrefetch)
+{
+    EAS_INT i;
+
+    /* after a cancel a buffer is free, ready or still being read */
+    for (i = 0; i < 2; i++)
+        if (EAS_AtomicLoadAcquire(&pPrefetch->buffers[i].state) == PCM_PREFETCH_BUSY)
+            return EAS_FALSE;
+
+    (void) EAS_HWCloseFile(pEASData->hwInstData, pPrefetch->fileHandle);
+    pPrefetch->fileHandle = NULL;
+    pPrefetch->closed = EAS_FALSE;
+    return EAS_TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * PCMPrefetchReleaseClosed()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Releases the slots of all closed streams whose last read has finished.
+ *----------------------------------------------------------------------------
+*/
+static void PCMPrefetchReleaseClosed (S_EAS_DATA *pEASData)
+{
+    EAS_INT i;
+
+    if (pEASData->pPCMPrefetch == NULL)
+        return;
+    for (i = 0; i < MAX_PCM_STREAMS; i++)
+        if (pEASData->pPCMPrefetch[i].closed)
+            (void) PCMPrefetchRelease(pEASData, &pEASData->pPCMPrefetch[i]);
+}
+
+/*----------------------------------------------------------------------------
+ * PCMReadFile()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reads stream data at the file position of the stream, either from the
+ * file or from the buffers read ahead. Fewer bytes than requested with
+ * EAS_SUCCESS means the next buffer is not ready yet, the stream is then
+ * flagged with PCM_FLAGS_UNDERRUN.
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT PCMReadFile (S_EAS_DATA *pEASData, S_PCM_STATE *pState, EAS_U8 *pBuffer, EAS_I32 n, EAS_I32 *pCount)
+{
+    S_PCM_PREFETCH *pPrefetch;
+    S_PCM_PREFETCH_BUFFER *pHead;
+    EAS_RESULT result;
+    EAS_I32 filePos;
+    EAS_I32 count;
+
+    if ((pPrefetch = PCMPrefetchSlot(pEASData, pState)) == NULL)
+        return EAS_HWReadFile(pEASData->hwInstData, pState->fileHandle, pBuffer, n, pCount);
+
+    *pCount = 0;
+    if ((result = EAS_HWFilePos(pEASData->hwInstData, pState->fileHandle, &filePos)) != EAS_SUCCESS)
+        return result;
+
+    while (n > 0)
+    {
+        PCMPrefetchRequest(pState, pPrefetch);
+        pHead = &pPrefetch->buffers[pPrefetch->head];
+        if ((pPrefetch->numQueued == 0) || (EAS_AtomicLoadAcquire(&pHead->state) != PCM_PREFETCH_READY))
+        {
+            pState->flags |= PCM_FLAGS_UNDERRUN;
+            break;
+        }
+
+        /* the stream was moved behind our back, start over from here */
+        if (pHead->filePos + pHead->readPos != filePos)
+        {
+            PCMPrefetchStart(pEASData, pState);
+            pState->flags |= PCM_FLAGS_UNDERRUN;
+            break;
+        }
+
+        count = pHead->count - pHead->readPos;
+        if (count > n)
+            count = n;
+        EAS_HWMemCpy(pBuffer, &pHead->data[pHead->readPos], count);
+        pHead->readPos += count;
+        pBuffer += count;
+        filePos += count;
+        *pCount += count;
+        n -= count;
+
+        /* the buffer is used up, an error is reported once its data has been used */
+        if (pHead->readPos == pHead->count)
+        {
+            result = pHead->result;
+            EAS_AtomicStoreRelease(&pHead->state, PCM_PREFETCH_FREE);
+            pPrefetch->head ^= 1;
+            pPrefetch->numQueued--;
+            if (result != EAS_SUCCESS)
+                break;
+        }
+    }
+
+    /* keep the file position where a synchronous read would have left it */
+    if ((result == EAS_SUCCESS) && (*pCount > 0))
+        result = EAS_HWFileSeek(pEASData->hwInstData, pState->fileHandle, filePos);
+    return result;
+}
+
 /*----------------------------------------------------------------------------
  * RenderPCMStream()
  *----------------------------------------------------------------------------
@@ -978,6 +1461,14 @@ static EAS_RESULT RenderPCMStream (S_EAS_DATA *pEASData, S_PCM_STATE *pState, EA
     EAS_I32 *pOut;
     EAS_I32 temp;
     EAS_U32 utemp;
+    EAS_I32 i;
+    EAS_I32 frac[BUFFER_SIZE_IN_MONO_SAMPLES];
+    EAS_I32 bufferL[2][BUFFER_SIZE_IN_MONO_SAMPLES];
+    EAS_I32 bufferR[2][BUFFER_SIZE_IN_MONO_SAMPLES];
+    EAS_I32 *x0L = bufferL[0];
+    EAS_I32 *x1L = bufferL[1];
+    EAS_I32 *x0R = bufferR[0];
+    EAS_I32 *x1R = bufferR[1];
 
 #if (NUM_OUTPUT_CHANNELS == 2)
     EAS_I32 gainRight, gainIncRight;
@@ -1128,79 +1619,145 @@ static EAS_RESULT RenderPCMStream (S_EAS_DATA *pEASData, S_PCM_STATE *pState, EA
     }
     phaseInc = phaseInc << pState->rateShift;
 
-    /* pointer to mix buffer */
-    pOut = pEASData->pMixBuffer;
+    if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES)
+        numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
+
+    /* gather the sample pairs and phase for each output sample, the decoder
+     * only runs when the integer part of the phase accumulator is non-zero */
+    for (i = 0; i < numSamples; i++)
+    {
+        x0L[i] = pState->decoderL.x0;
+        x1L[i] = pState->decoderL.x1;
+        x0R[i] = pState->decoderR.x0;
+        x1R[i] = pState->decoderR.x1;
+        frac[i] = (EAS_I32) (pState->phase & PHASE_FRAC_MASK);
+
+        /* advance phase accumulator */
+        pState->phase += phaseInc;
+
+        /* if integer part of phase accumulator is non-zero, advance to next sample */
+        while (pState->phase & ~PHASE_FRAC_MASK)
+        {
+            pState->decoderL.x0 = pState->decoderL.x1;
+            pState->decoderR.x0 = pState->decoderR.x1;
+
+            /* block decoders, take the next frame from the ring */
+            if (pState->pDecoder->pfDecodeBlock)
+            {
+                if ((pState->ringCount == 0) && ((pState->flags & PCM_FLAGS_UNDERRUN) == 0))
+                {
+                    if ((result = (*pState->pDecoder->pfDecodeBlock)(pEASData, pState)) != EAS_SUCCESS)
+                        return result;
+                }
+
+                /* no more data, force zero samples, IMA ADPCM holds the last frame */
+                if (pState->ringCount == 0)
+                {
+#ifdef _IMA_DECODER
+                    if (pState->pDecoder != &IMADecoder)
+#endif
+                        pState->decoderL.x1 = pState->decoderR.x1 = 0;
+                }
+                else
+                {
+                    pState->decoderL.x1 = pState->pRing[pState->ringRead * 2];
+                    if (pState->flags & PCM_FLAGS_STEREO)
+                        pState->decoderR.x1 = pState->pRing[pState->ringRead * 2 + 1];
+                    pState->ringRead = (pState->ringRead + 1) & PCM_RING_MASK;
+                    pState->ringCount--;
+                }
+            }
+
+            /* sample decoders */
+            else
+            {
+                /* give the source a chance to continue the stream */
+                if (!pState->bytesLeft && pState->pCallback && ((pState->flags & PCM_FLAGS_EMPTY) == 0))
+                {
+                    pState->flags |= PCM_FLAGS_EMPTY;
+                    (*pState->pCallback)(pEASData, pState->cbInstData, pState, EAS_STATE_EMPTY);
+                    { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "RenderPCMStream: After empty callback, bytesLeft = %d\n", pState->bytesLeft); */ }
+                }
+
+                /* decode the next sample */
+                if ((result = (*pState->pDecoder->pfDecodeSample)(pEASData, pState)) != EAS_SUCCESS)
+                    return result;
+            }
+
+            /* adjust phase by one sample */
+            pState->phase -= (1L << NUM_PHASE_FRAC_BITS);
+        }
+    }
 
-    /* render a buffer of samples */
-    while (numSamples--)
+    /* count the frames the stream ran dry in, it stalls until the data is ready */
+    if (pState->flags & PCM_FLAGS_UNDERRUN)
     {
+        pState->flags &= ~PCM_FLAGS_UNDERRUN;
+        (void) EAS_AtomicIncrement(&pEASData->pcmUnderruns);
+    }
 
-        /* interpolate an output sample */
-        pState->decoderL.output = pState->decoderL.x0 + FMUL_15x15((pState->decoderL.x1 - pState->decoderL.x0), pState->phase & PHASE_FRAC_MASK);
+    /* the loops below have no dependencies between samples so the compiler
+     * can vectorize the interpolation, gain and mix */
+    pOut = pEASData->pMixBuffer;
 
-        /* stereo output */
 #if (NUM_OUTPUT_CHANNELS == 2)
 
-        /* stereo stream? */
-        if (pState->flags & PCM_FLAGS_STEREO)
-            pState->decoderR.output = pState->decoderR.x0 + FMUL_15x15((pState->decoderR.x1 - pState->decoderR.x0), pState->phase & PHASE_FRAC_MASK);
+    /* mono streams feed both outputs from the left decoder */
+    if ((pState->flags & PCM_FLAGS_STEREO) == 0)
+    {
+        x0R = x0L;
+        x1R = x1L;
+    }
+
+    for (i = 0; i < numSamples; i++)
+    {
+        EAS_I32 outputL = x0L[i] + FMUL_15x15((x1L[i] - x0L[i]), frac[i]);
+        EAS_I32 outputR = x0R[i] + FMUL_15x15((x1R[i] - x0R[i]), frac[i]);
 
         /* gain scale and mix */
         /*lint -e{704} use shift instead of division */
-        *pOut++ += (pState->decoderL.output * (gainLeft >> SYNTH_UPDATE_PERIOD_IN_BITS)) >> PCM_MIXER_GUARD_BITS;
-        gainLeft += gainIncLeft;
-
+        pOut[2 * i] += (outputL * ((gainLeft + i * gainIncLeft) >> SYNTH_UPDATE_PERIOD_IN_BITS)) >> PCM_MIXER_GUARD_BITS;
         /*lint -e{704} use shift instead of division */
-        if (pState->flags & PCM_FLAGS_STEREO)
-            *pOut++ += (pState->decoderR.output * (gainRight >> SYNTH_UPDATE_PERIOD_IN_BITS)) >> PCM_MIXER_GUARD_BITS;
-        else
-            *pOut++ += (pState->decoderL.output * (gainRight >> SYNTH_UPDATE_PERIOD_IN_BITS)) >> PCM_MIXER_GUARD_BITS;
-
-        gainRight += gainIncRight;
+        pOut[2 * i + 1] += (outputR * ((gainRight + i * gainIncRight) >> SYNTH_UPDATE_PERIOD_IN_BITS)) >> PCM_MIXER_GUARD_BITS;
+    }
+    gainLeft += numSamples * gainIncLeft;
+    gainRight += numSamples * gainIncRight;
 
-        /* mono output */
+    /* mono output */
 #else
-        /* if stereo stream, decode right channel and mix to mono */
-        if (pState->flags & PCM_FLAGS_STEREO)
+    /* if stereo stream, mix to mono */
+    if (pState->flags & PCM_FLAGS_STEREO)
+    {
+        for (i = 0; i < numSamples; i++)
         {
-            pState->decoderR.output= pState->decoderR.x0 + FMUL_15x15((pState->decoderR.x1 - pState->decoderR.x0), pState->phase & PHASE_FRAC_MASK);
+            EAS_I32 outputL = x0L[i] + FMUL_15x15((x1L[i] - x0L[i]), frac[i]);
+            EAS_I32 outputR = x0R[i] + FMUL_15x15((x1R[i] - x0R[i]), frac[i]);
 
             /* for mono, sum stereo ADPCM to mono */
             /*lint -e{704} use shift instead of division */
-            *pOut++ += ((pState->decoderL.output + pState->decoderR.output) * (gainLeft >> SYNTH_UPDATE_PERIOD_IN_BITS)) >> PCM_MIXER_GUARD_BITS;
+            pOut[i] += ((outputL + outputR) * ((gainLeft + i * gainIncLeft) >> SYNTH_UPDATE_PERIOD_IN_BITS)) >> PCM_MIXER_GUARD_BITS;
         }
-        else
-            /*lint -e{704} use shift instead of division */
-            *pOut++ += (pState->decoderL.output * (gainLeft >> SYNTH_UPDATE_PERIOD_IN_BITS)) >> PCM_MIXER_GUARD_BITS;
-
-        gainLeft += gainIncLeft;
-#endif
-
-        /* advance phase accumulator */
-        pState->phase += phaseInc;
-
-        /* if integer part of phase accumulator is non-zero, advance to next sample */
-        while (pState->phase & ~PHASE_FRAC_MASK)
+    }
+    else
+    {
+        for (i = 0; i < numSamples; i++)
         {
-            pState->decoderL.x0 = pState->decoderL.x1;
-            pState->decoderR.x0 = pState->decoderR.x1;
+            EAS_I32 outputL = x0L[i] + FMUL_15x15((x1L[i] - x0L[i]), frac[i]);
 
-            /* give the source a chance to continue the stream */
-            if (!pState->bytesLeft && pState->pCallback && ((pState->flags & PCM_FLAGS_EMPTY) == 0))
-            {
-                pState->flags |= PCM_FLAGS_EMPTY;
-                (*pState->pCallback)(pEASData, pState->cbInstData, pState, EAS_STATE_EMPTY);
-                { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "RenderPCMStream: After empty callback, bytesLeft = %d\n", pState->bytesLeft); */ }
-            }
-
-            /* decode the next sample */
-            if ((result = (*pState->pDecoder->pfDecodeSample)(pEASData, pState)) != EAS_SUCCESS)
-                return result;
-
-            /* adjust phase by one sample */
-            pState->phase -= (1L << NUM_PHASE_FRAC_BITS);
+            /*lint -e{704} use shift instead of division */
+            pOut[i] += (outputL * ((gainLeft + i * gainIncLeft) >> SYNTH_UPDATE_PERIOD_IN_BITS)) >> PCM_MIXER_GUARD_BITS;
         }
+    }
+    gainLeft += numSamples * gainIncLeft;
+#endif
 
+    /* keep the last interpolated sample, as the per-sample loop used to */
+    if (numSamples > 0)
+    {
+        i = numSamples - 1;
+        pState->decoderL.output = x0L[i] + FMUL_15x15((x1L[i] - x0L[i]), frac[i]);
+        if (pState->flags & PCM_FLAGS_STEREO)
+            pState->decoderR.output = x0R[i] + FMUL_15x15((x1R[i] - x0R[i]), frac[i]);
     }
 
     /* save new gain */
@@ -1221,7 +1778,7 @@ static EAS_RESULT RenderPCMStream (S_EAS_DATA *pEASData, S_PCM_STATE *pState, EA
     }
 
     /* if out of data, set stopped state and notify */
-    if (pState->bytesLeft == 0 || pState->state == EAS_STATE_STOPPING)
+    if ((pState->bytesLeft == 0 && pState->ringCount == 0) || pState->state == EAS_STATE_STOPPING)
     {
         pState->state = EAS_STATE_STOPPED;
 
@@ -1237,10 +1794,14 @@ static EAS_RESULT RenderPCMStream (S_EAS_DATA *pEASData, S_PCM_STATE *pState, EA
 }
 
 /*----------------------------------------------------------------------------
- * LinearPCMDecode()
+ * LinearPCMDecodeBlock()
  *----------------------------------------------------------------------------
  * Purpose:
- * Decodes a PCM sample
+ * Decodes PCM frames into the ring until it is full or the stream runs
+ * out of data. The file is read in blocks of up to PCM_READ_SIZE bytes
+ * but never beyond bytesLeft, so the file position is where the parser
+ * expects it whenever the stream empties. Files held in memory are not
+ * read at all, the frames are converted from the file data.
  *
  * Inputs:
  *
@@ -1252,95 +1813,120 @@ static EAS_RESULT RenderPCMStream (S_EAS_DATA *pEASData, S_PCM_STATE *pState, EA
  *
  *----------------------------------------------------------------------------
 */
-static EAS_RESULT LinearPCMDecode (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState)
+static EAS_RESULT LinearPCMDecodeBlock (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState)
 {
+    EAS_U8 buffer[PCM_READ_SIZE];
     EAS_RESULT result;
     EAS_HW_DATA_HANDLE hwInstData;
+    EAS_PCM *pRing;
+    const EAS_U8 *pSrc;
+    EAS_I32 filePos;
+    EAS_I32 frameSize;
+    EAS_I32 numBytes;
+    EAS_I32 numFrames;
+    EAS_I32 count;
+    EAS_INT channel;
+    EAS_INT numChannels;
 
     hwInstData = ((S_EAS_DATA*) pEASData)->hwInstData;
 
-    /* if out of data, check for loop */
-    if ((pState->bytesLeft == 0) && (pState->loopSamples != 0))
-    {
-        if ((result = EAS_HWFileSeek(pEASData->hwInstData, pState->fileHandle, (EAS_I32) (pState->startPos + pState->loopLocation))) != EAS_SUCCESS)
-            return result;
-        pState->bytesLeft = pState->byteCount = (EAS_I32) pState->bytesLeftLoop;
-        pState->flags &= ~PCM_FLAGS_EMPTY;
-        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "LinearPCMDecode: Rewind file to %d, bytesLeft = %d\n", pState->startPos, pState->bytesLeft); */ }
-    }
+    //unsigned 16 bit currently not supported
+    if ((pState->flags & (PCM_FLAGS_8_BIT | PCM_FLAGS_UNSIGNED)) == PCM_FLAGS_UNSIGNED)
+        return EAS_ERROR_INVALID_PCM_TYPE;
 
-    if (pState->bytesLeft)
+    numChannels = (pState->flags & PCM_FLAGS_STEREO) ? 2 : 1;
+    frameSize = (pState->flags & PCM_FLAGS_8_BIT) ? numChannels : numChannels * 2;
+
+    while (pState->ringCount < PCM_RING_SIZE)
     {
+        /* give the source a chance to continue the stream */
+        if (!pState->bytesLeft && pState->pCallback && ((pState->flags & PCM_FLAGS_EMPTY) == 0))
+        {
+            pState->flags |= PCM_FLAGS_EMPTY;
+            (*pState->pCallback)(pEASData, pState->cbInstData, pState, EAS_STATE_EMPTY);
+            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "LinearPCMDecodeBlock: After empty callback, bytesLeft = %d\n", pState->bytesLeft); */ }
+        }
 
-        /* check format byte for 8-bit samples */
-        if (pState->flags & PCM_FLAGS_8_BIT)
+        /* if out of data, check for loop */
+        if ((pState->bytesLeft == 0) && (pState->loopSamples != 0))
         {
-            /* fetch left or mono sample */
-            if ((result = EAS_HWGetByte(hwInstData, pState->fileHandle, &pState->srcByte)) != EAS_SUCCESS)
+            if ((result = EAS_HWFileSeek(hwInstData, pState->fileHandle, (EAS_I32) (pState->startPos + pState->loopLocation))) != EAS_SUCCESS)
                 return result;
+            pState->bytesLeft = pState->byteCount = (EAS_I32) pState->bytesLeftLoop;
+            pState->flags &= ~PCM_FLAGS_EMPTY;
+            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "LinearPCMDecodeBlock: Rewind file to %d, bytesLeft = %d\n", pState->startPos, pState->bytesLeft); */ }
+        }
 
-            /* if unsigned */
-            if (pState->flags & PCM_FLAGS_UNSIGNED)
-            {
-                /*lint -e{734} converting unsigned 8-bit to signed 16-bit */
-                pState->decoderL.x1 = (EAS_PCM)(((EAS_PCM) pState->srcByte << 8) ^ 0x8000);
-            }
-            else
-            {
-                /*lint -e{734} converting signed 8-bit to signed 16-bit */
-                pState->decoderL.x1 = (EAS_PCM)((EAS_PCM) pState->srcByte << 8);
-            }
-            pState->bytesLeft--;
+        if (pState->bytesLeft <= 0)
+            break;
 
-            /* fetch right sample */
-            if(pState->flags & PCM_FLAGS_STEREO)
-            {
-                if ((result = EAS_HWGetByte(hwInstData, pState->fileHandle, &pState->srcByte)) != EAS_SUCCESS)
-                    return result;
+        /* read as many whole frames as fit in the ring */
+        numBytes = (PCM_RING_SIZE - pState->ringCount) * frameSize;
+        if (numBytes > PCM_READ_SIZE)
+            numBytes = PCM_READ_SIZE;
+        if (numBytes > pState->bytesLeft)
+            numBytes = pState->bytesLeft;
+
+        /* data held in memory is converted where it is */
+        if (pState->pFileData)
+        {
+            if ((result = EAS_HWFilePos(hwInstData, pState->fileHandle, &filePos)) != EAS_SUCCESS)
+                return result;
+            count = pState->fileSize - filePos;
+            if (count > numBytes)
+                count = numBytes;
+            if ((result = EAS_HWFileSeekOfs(hwInstData, pState->fileHandle, count)) != EAS_SUCCESS)
+                return result;
+            pSrc = pState->pFileData + filePos;
+        }
+        else
+        {
+            if ((result = PCMReadFile(pEASData, pState, buffer, numBytes, &count)) != EAS_SUCCESS)
+                return result;
+            pSrc = buffer;
+        }
+        pState->bytesLeft -= count;
 
-                /* if unsigned */
-                if (pState->flags & PCM_FLAGS_UNSIGNED)
+        /* convert to 16-bit frames, a partial frame at the end is dropped */
+        for (numFrames = count / frameSize; numFrames > 0; numFrames--)
+        {
+            pRing = &pState->pRing[((pState->ringRead + pState->ringCount) & PCM_RING_MASK) * 2];
+            for (channel = 0; channel < numChannels; channel++)
+            {
+                if (pState->flags & PCM_FLAGS_8_BIT)
                 {
-                    /*lint -e{734} converting unsigned 8-bit to signed 16-bit */
-                    pState->decoderR.x1 = (EAS_PCM)(((EAS_PCM) pState->srcByte << 8) ^ 0x8000);
+                    /* if unsigned */
+                    if (pState->flags & PCM_FLAGS_UNSIGNED)
+                    {
+                        /*lint -e{734} converting unsigned 8-bit to signed 16-bit */
+                        *pRing++ = (EAS_PCM)(((EAS_PCM) *pSrc++ << 8) ^ 0x8000);
+                    }
+                    else
+                    {
+                        /*lint -e{734} converting signed 8-bit to signed 16-bit */
+                        *pRing++ = (EAS_PCM)((EAS_PCM) *pSrc++ << 8);
+                    }
                 }
+
+                /* 16-bit samples are little-endian */
                 else
                 {
-                    /*lint -e{734} converting signed 8-bit to signed 16-bit */
-                    pState->decoderR.x1 = (EAS_PCM)((EAS_PCM) pState->srcByte << 8);
+                    *pRing++ = (EAS_PCM) (pSrc[0] | (pSrc[1] << 8));
+                    pSrc += 2;
                 }
-                pState->bytesLeft--;
             }
+            pState->ringCount++;
         }
 
-        /* must be 16-bit samples */
-        else
+        /* the prefetched data is late, or the file is shorter than the stream */
+        if (count < numBytes)
         {
-            //unsigned 16 bit currently not supported
-            if (pState->flags & PCM_FLAGS_UNSIGNED)
-            {
-                return EAS_ERROR_INVALID_PCM_TYPE;
-            }
-
-            /* fetch left or mono sample */
-            if ((result = EAS_HWGetWord(hwInstData, pState->fileHandle, &pState->decoderL.x1, EAS_FALSE)) != EAS_SUCCESS)
-                return result;
-            pState->bytesLeft -= 2;
-
-            /* fetch right sample */
-            if(pState->flags & PCM_FLAGS_STEREO)
-            {
-                if ((result = EAS_HWGetWord(hwInstData, pState->fileHandle, &pState->decoderR.x1, EAS_FALSE)) != EAS_SUCCESS)
-                    return result;
-                pState->bytesLeft -= 2;
-            }
+            if (pState->flags & PCM_FLAGS_UNDERRUN)
+                break;
+            return EAS_EOF;
         }
     }
 
-    /* no more data, force zero samples */
-    else
-        pState->decoderL.x1 = pState->decoderR.x1 = 0;
-
     return EAS_SUCCESS;
 }
 
@@ -1388,6 +1974,7 @@ static EAS_RESULT LinearPCMLocate (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState
         if (pState->loopSamples == 0)
         {
             pState->bytesLeft = 0;
+            pState->ringCount = 0;
             pState->flags |= PCM_FLAGS_EMPTY;
             return EAS_ERROR_LOCATE_BEYOND_END;
         }
@@ -1436,6 +2023,9 @@ EAS_RESULT EAS_PESeek (S_EAS_DATA *pEASData, S_PCM_STATE *pState, EAS_I32 *pLoca
     }
     pState->bytesLeft = pState->bytesLeftLoop;
 
+    /* discard the frames decoded ahead of the old position */
+    pState->ringCount = 0;
+
     /* skip through chunks until we find the right chunk */
     while (*pLocation > (EAS_I32) pState->bytesLeft)
     {
@@ -1477,6 +2067,8 @@ EAS_RESULT EAS_PESeek (S_EAS_DATA *pEASData, S_PCM_STATE *pState, EAS_I32 *pLoca
         else
             pState->bytesLeft -= *pLocation;
     }
+
+    PCMPrefetchStart(pEASData, pState);
     return EAS_SUCCESS;
 }
 
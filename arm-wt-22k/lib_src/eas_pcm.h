@@ -72,6 +72,24 @@ typedef struct s_pcm_open_params_tag
 */
 EAS_RESULT EAS_PEInit (EAS_DATA_HANDLE pEASData);
 
+/*----------------------------------------------------------------------------
+ * EAS_PEClear()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns all of the PCM streams to the free state
+ *
+ * Inputs:
+ *
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_PEClear (EAS_DATA_HANDLE pEASData);
+
 /*----------------------------------------------------------------------------
  * EAS_PEShutdown()
  *----------------------------------------------------------------------------
@@ -90,6 +108,44 @@ EAS_RESULT EAS_PEInit (EAS_DATA_HANDLE pEASData);
 */
 EAS_RESULT EAS_PEShutdown (EAS_DATA_HANDLE pEASData);
 
+/*----------------------------------------------------------------------------
+ * EAS_PESetPrefetch()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Enables or disables read-ahead of linear PCM streams
+ *
+ * Inputs:
+ * pEASData         - pointer to EAS library instance data
+ * enable           - EAS_TRUE to enable read-ahead
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_PESetPrefetch (EAS_DATA_HANDLE pEASData, EAS_BOOL enable);
+
+/*----------------------------------------------------------------------------
+ * EAS_PEPrefetch()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reads the requested buffers, called from the I/O thread
+ *
+ * Inputs:
+ * pEASData         - pointer to EAS library instance data
+ * pNumReads        - pointer to variable to receive the number of buffers read
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_PEPrefetch (EAS_DATA_HANDLE pEASData, EAS_I32 *pNumReads);
+
 /*----------------------------------------------------------------------------
  * EAS_PEOpenStream()
  *----------------------------------------------------------------------------
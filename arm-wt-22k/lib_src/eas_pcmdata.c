@@ -29,7 +29,9 @@
 
 #include "eas_data.h"
 
+/* the static memory model allocates its single instance here */
+#ifdef _STATIC_MEMORY
 /* static data allocation */
 S_PCM_STATE eas_PCMData[MAX_PCM_STREAMS];
-
-
+EAS_PCM eas_PCMRing[MAX_PCM_STREAMS][PCM_RING_SIZE * 2];
+#endif
@@ -37,11 +37,62 @@
 #define PCM_STREAM_THRESHOLD        (MAX_PCM_STREAMS - 4)
 #endif
 
+/* decoded frames buffered ahead of the interpolator, must be a power of 2 */
+#ifndef PCM_RING_SIZE
+#define PCM_RING_SIZE               256
+#endif
+#define PCM_RING_MASK               (PCM_RING_SIZE - 1)
+#define PCM_RING_BYTES              (PCM_RING_SIZE * 2 * (EAS_I32) sizeof(EAS_PCM))
+
+/* largest single file read when refilling the ring, a multiple of the frame size */
+#define PCM_READ_SIZE               1024
+
+/* size of each of the two prefetch buffers of a stream, a multiple of 4 so
+ * the buffers always end on a frame boundary */
+#ifndef PCM_PREFETCH_SIZE
+#define PCM_PREFETCH_SIZE           8192
+#endif
+
+/* IMA ADPCM blocks of up to IMA_CACHE_MAX_BLOCK_SIZE bytes are decoded
+ * whole into a per-instance LRU cache of IMA_CACHE_BLOCKS entries, so
+ * looped and repeated sounds are decoded once, 0 disables the cache */
+#ifndef IMA_CACHE_BLOCKS
+#define IMA_CACHE_BLOCKS            8
+#endif
+#define IMA_CACHE_MAX_BLOCK_SIZE    1024
+
 /* coefficents for high-pass filter in ADPCM */
 #define INTEGRATOR_COEFFICIENT      100     /* coefficient for leaky integrator */
 
 /* additional flags in S_PCM_STATE.flags used internal to module */
 #define PCM_FLAGS_EMPTY             0x01000000  /* unsigned format */
+#define PCM_FLAGS_UNDERRUN          0x02000000  /* prefetched data was not ready */
+
+/*----------------------------------------------------------------------------
+ * S_IMA_CACHE
+ *
+ * Decoded IMA ADPCM blocks. An entry is identified by the file handle and
+ * the file offset of the block header, entries are flushed when a stream
+ * closes its file. An entry is not reused while a stream copies from it.
+ *----------------------------------------------------------------------------
+*/
+typedef struct s_ima_cache_entry_tag
+{
+    EAS_FILE_HANDLE     fileHandle;         /* NULL if the entry is empty */
+    EAS_I32             filePos;            /* file offset of the block */
+    EAS_U32             lastUsed;           /* for least recently used replacement */
+    EAS_U16             numFrames;          /* frames in the block */
+    EAS_U8              numUsers;           /* streams copying from the entry */
+    EAS_PCM             frames[IMA_CACHE_MAX_BLOCK_SIZE * 2];   /* mono, or left and right interleaved */
+} S_IMA_CACHE_ENTRY;
+
+#if (IMA_CACHE_BLOCKS > 0)
+typedef struct s_ima_cache_tag
+{
+    EAS_U32             useCount;           /* time stamp for lastUsed */
+    S_IMA_CACHE_ENTRY   entries[IMA_CACHE_BLOCKS];
+} S_IMA_CACHE;
+#endif
 
 /*----------------------------------------------------------------------------
  * S_PCM_STATE
@@ -74,6 +125,8 @@ typedef struct s_pcm_state_tag
     EAS_U32             handleCheck;        /* signature check for checked build */
 #endif
     EAS_FILE_HANDLE     fileHandle;         /* pointer to input file */
+    const EAS_U8        *pFileData;         /* file contents if the file is held in memory */
+    EAS_I32             fileSize;           /* size of the file held in memory */
     EAS_PCM_CALLBACK    pCallback;          /* pointer to callback function */
     EAS_VOID_PTR        cbInstData;         /* instance data for callback function */
     struct s_decoder_interface_tag EAS_CONST * pDecoder;    /* pointer to decoder interface */
@@ -121,12 +174,19 @@ typedef struct s_pcm_state_tag
     EAS_BOOL8           hiNibble;           /* indicates high/low nibble is next */
     EAS_BOOL8           hiNibbleLoop;       /* indicates high/low nibble is next, value loop start */
     EAS_U8              rateShift;          /* for playback rate greater than 1.0 */
+    S_IMA_CACHE_ENTRY   *pCacheEntry;       /* cached block being copied to the ring */
+    EAS_U16             cacheFrame;         /* next frame to copy from the cached block */
+    EAS_U16             ringRead;           /* next frame in the ring for the interpolator */
+    EAS_U16             ringCount;          /* count of decoded frames in the ring */
+    EAS_PCM             *pRing;             /* decoded frames, left and right interleaved, allocated when a block decoder opens */
 } S_PCM_STATE;
 
 /*----------------------------------------------------------------------------
  * S_DECODER_INTERFACE
  *
- * Generic interface for audio decoders
+ * Generic interface for audio decoders. A decoder either decodes one
+ * sample per call into decoderL.x1 and decoderR.x1 (pfDecodeSample), or
+ * fills the ring with as many frames as it can (pfDecodeBlock).
  *----------------------------------------------------------------------------
 */
 typedef struct s_decoder_interface_tag
@@ -134,8 +194,46 @@ typedef struct s_decoder_interface_tag
     EAS_RESULT (* EAS_CONST pfInit)(EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState);
     EAS_RESULT (* EAS_CONST pfDecodeSample)(EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState);
     EAS_RESULT (* EAS_CONST pfLocate)(EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState, EAS_I32 time);
+    EAS_RESULT (* EAS_CONST pfDecodeBlock)(EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState);
 } S_DECODER_INTERFACE;
 
+/*----------------------------------------------------------------------------
+ * S_PCM_PREFETCH
+ *
+ * Read-ahead state for one PCM stream slot. The render thread requests
+ * buffers in file order and consumes them, the I/O thread running
+ * EAS_PEPrefetch reads them through a duplicate file handle. Ownership
+ * of a buffer passes between the threads through its state, everything
+ * else is only touched by the thread that owns the buffer at the time.
+ *----------------------------------------------------------------------------
+*/
+#define PCM_PREFETCH_FREE           0   /* owned by the render thread */
+#define PCM_PREFETCH_PENDING        1   /* requested, waiting for the I/O thread */
+#define PCM_PREFETCH_BUSY           2   /* being read by the I/O thread */
+#define PCM_PREFETCH_READY          3   /* read, owned by the render thread */
+
+typedef struct s_pcm_prefetch_buffer_tag
+{
+    volatile EAS_UINT   state;              /* one of the PCM_PREFETCH states */
+    EAS_I32             filePos;            /* file offset of the first byte */
+    EAS_I32             size;               /* number of bytes requested */
+    EAS_I32             count;              /* number of bytes read */
+    EAS_RESULT          result;             /* result of the read */
+    EAS_I32             readPos;            /* bytes already passed to the decoder */
+    EAS_BOOL            stale;              /* cancelled while busy, drop when ready */
+    EAS_U8              data[PCM_PREFETCH_SIZE];
+} S_PCM_PREFETCH_BUFFER;
+
+typedef struct s_pcm_prefetch_tag
+{
+    EAS_FILE_HANDLE     fileHandle;         /* duplicate handle for the I/O thread, NULL if not prefetched */
+    EAS_I32             nextPos;            /* file offset of the next request */
+    EAS_I32             nextLeft;           /* bytes of the current run not yet requested */
+    EAS_INT             head;               /* buffer the decoder reads next */
+    EAS_INT             numQueued;          /* buffers requested and not yet consumed */
+    EAS_BOOL            closed;             /* stream closed, the handle waits for a busy buffer */
+    S_PCM_PREFETCH_BUFFER buffers[2];
+} S_PCM_PREFETCH;
 
 /* header chunk for SMAF ADPCM */
 #define TAG_YAMAHA_ADPCM    0x4d776100
@@ -153,5 +251,16 @@ typedef struct s_decoder_interface_tag
 */
 EAS_RESULT EAS_PESeek (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState, EAS_I32 *pLocation);
 
+#ifdef _IMA_DECODER
+/*----------------------------------------------------------------------------
+ * IMACacheFlush
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Drops the cached blocks of a stream when its file is closed
+ *----------------------------------------------------------------------------
+*/
+void IMACacheFlush (EAS_DATA_HANDLE pEASData, S_PCM_STATE *pState);
+#endif
+
 #endif /* _EAS_PCMDATA_H */
 
@@ -43,6 +43,8 @@
 #include "eas_build.h"
 #include "eas_vm_protos.h"
 #include "eas_math.h"
+#include "eas_atomic.h"
+#include "eas_smfdata.h"
 
 #ifdef JET_INTERFACE
 #include "jet_data.h"
@@ -52,9 +54,56 @@
 #include "eas_mdls.h"
 #endif
 
+#ifdef MMAPI_SUPPORT
+#include "eas_tcdata.h"
+#endif
+
+#ifdef _XMF_PARSER
+#include "eas_xmfdata.h"
+#endif
+
+#ifdef _WAVE_PARSER
+#include "eas_wavefile.h"
+#endif
+
+#ifdef _OTA_PARSER
+#include "eas_otadata.h"
+#endif
+
+#ifdef _IMELODY_PARSER
+#include "eas_imelodydata.h"
+#endif
+
+#ifdef _RTTTL_PARSER
+#include "eas_rtttldata.h"
+#endif
+
 /* number of events to parse before calling EAS_HWYield function */
 #define YIELD_EVENT_COUNT       10
 
+/* initial size of the buffer behind a stream locator */
+#define STREAM_BUFFER_MIN_SIZE  4096
+
+/* size reported for a stream locator until the end of the stream is found */
+#define STREAM_BUFFER_SIZE_UNKNOWN  0x7fffffff
+
+#ifndef EAS_I32_MAX
+#define EAS_I32_MAX             (2147483647)
+#endif
+
+/* growable buffer giving random access to a sequential source */
+typedef struct s_eas_stream_buffer_tag
+{
+    EAS_FILE                        locator;
+    EAS_HW_DATA_HANDLE              hwInstData;
+    int                             (*read)(void *handle, void *buf, int size);
+    void                            *handle;
+    EAS_U8                          *pData;
+    EAS_I32                         length;
+    EAS_I32                         capacity;
+    EAS_BOOL                        eof;
+} S_EAS_STREAM_BUFFER;
+
 /*----------------------------------------------------------------------------
  * easLibConfig
  *
@@ -98,7 +147,7 @@ static EAS_RESULT EAS_ParseEvents (S_EAS_DATA *pEASData, S_EAS_STREAM *pStream,
  * value            - new value
  *----------------------------------------------------------------------------
 */
-EAS_RESULT EAS_SetStreamParameter (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_I32 param, EAS_I32 value)
+EAS_RESULT EAS_SetStreamParameter (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_I32 param, EAS_INTPTR value)
 {
     S_FILE_PARSER_INTERFACE *pParserModule;
 
@@ -120,7 +169,7 @@ EAS_RESULT EAS_SetStreamParameter (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS
  * pValue           - pointer to variable to receive current setting
  *----------------------------------------------------------------------------
 */
-EAS_RESULT EAS_GetStreamParameter (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_I32 param, EAS_I32 *pValue)
+EAS_RESULT EAS_GetStreamParameter (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_I32 param, EAS_INTPTR *pValue)
 {
     S_FILE_PARSER_INTERFACE *pParserModule;
 
@@ -161,18 +210,19 @@ EAS_BOOL EAS_StreamReady (S_EAS_DATA *pEASData, EAS_HANDLE pStream)
  * code in the parser.
  *----------------------------------------------------------------------------
 */
-EAS_RESULT EAS_IntSetStrmParam (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_INT param, EAS_I32 value)
+EAS_RESULT EAS_IntSetStrmParam (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_INT param, EAS_INTPTR value)
 {
     S_SYNTH *pSynth;
+    EAS_INTPTR synthHandle;
 
     /* try to set the parameter using stream interface */
     if (EAS_SetStreamParameter(pEASData, pStream, param, value) == EAS_SUCCESS)
         return EAS_SUCCESS;
 
     /* get a pointer to the synth object and set it directly */
-    /*lint -e{740} we are cheating by passing a pointer through this interface */
-    if (EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_SYNTH_HANDLE, (EAS_I32*) &pSynth) != EAS_SUCCESS)
+    if (EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_SYNTH_HANDLE, &synthHandle) != EAS_SUCCESS)
         return EAS_ERROR_INVALID_PARAMETER;
+    pSynth = (S_SYNTH*) synthHandle;
 
     if (pSynth == NULL)
         return EAS_ERROR_INVALID_PARAMETER;
@@ -197,13 +247,13 @@ EAS_RESULT EAS_IntSetStrmParam (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_IN
             return VMSetEASLib(pSynth, (EAS_SNDLIB_HANDLE) value);
 
         case PARSER_DATA_POLYPHONY:
-            return VMSetPolyphony(pEASData->pVoiceMgr, pSynth, value);
+            return VMSetPolyphony(pEASData->pVoiceMgr, pSynth, (EAS_I32) value);
 
         case PARSER_DATA_PRIORITY:
-            return VMSetPriority(pEASData->pVoiceMgr, pSynth, value);
+            return VMSetPriority(pEASData->pVoiceMgr, pSynth, (EAS_I32) value);
 
         case PARSER_DATA_TRANSPOSITION:
-            VMSetTranposition(pSynth, value);
+            VMSetTranposition(pSynth, (EAS_I32) value);
             break;
 
         case PARSER_DATA_VOLUME:
@@ -230,15 +280,19 @@ EAS_RESULT EAS_IntSetStrmParam (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_IN
 EAS_RESULT EAS_IntGetStrmParam (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_INT param, EAS_I32 *pValue)
 {
     S_SYNTH *pSynth;
+    EAS_INTPTR value;
 
-    /* try to set the parameter */
-    if (EAS_GetStreamParameter(pEASData, pStream, param, pValue) == EAS_SUCCESS)
+    /* try to get the parameter */
+    if (EAS_GetStreamParameter(pEASData, pStream, param, &value) == EAS_SUCCESS)
+    {
+        *pValue = (EAS_I32) value;
         return EAS_SUCCESS;
+    }
 
     /* get a pointer to the synth object and retrieve data directly */
-    /*lint -e{740} we are cheating by passing a pointer through this interface */
-    if (EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_SYNTH_HANDLE, (EAS_I32*) &pSynth) != EAS_SUCCESS)
+    if (EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_SYNTH_HANDLE, &value) != EAS_SUCCESS)
         return EAS_ERROR_INVALID_PARAMETER;
+    pSynth = (S_SYNTH*) value;
 
     if (pSynth == NULL)
         return EAS_ERROR_INVALID_PARAMETER;
@@ -327,6 +381,9 @@ static void EAS_InitStream (S_EAS_STREAM *pStream, EAS_VOID_PTR pParserModule, E
     pStream->repeatCount = 0;
     pStream->volume = DEFAULT_STREAM_VOLUME;
     pStream->streamFlags = 0;
+
+    /* events queued for the stream that used the slot before are dropped */
+    pStream->generation++;
 }
 
 /*----------------------------------------------------------------------------
@@ -348,19 +405,91 @@ EAS_PUBLIC const S_EAS_LIB_CONFIG *EAS_Config (void)
 }
 
 /*----------------------------------------------------------------------------
- * EAS_Init()
+ * EAS_ArenaSize()
  *----------------------------------------------------------------------------
- * Purpose:
- * Initialize the synthesizer library
- *
- * Inputs:
- *  ppEASData       - pointer to data handle variable for this instance
- *
- * Outputs:
- *
+ * Returns the arena size needed for an instance with all streams open,
+ * each using the largest parser in this build, without the extra size
+ * requested by the host.
  *----------------------------------------------------------------------------
 */
-EAS_PUBLIC EAS_RESULT EAS_Init (EAS_DATA_HANDLE *ppEASData)
+static EAS_I32 EAS_ArenaSize (void)
+{
+    EAS_I32 size;
+    EAS_I32 streamSize;
+    EAS_I32 parserSize;
+    EAS_INT module;
+    const S_EFFECTS_INTERFACE *pEffect;
+
+    /* allocations made by EAS_Init */
+    size = EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_EAS_DATA));
+    size += EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_VOICE_MGR));
+    size += EAS_HW_ARENA_BLOCK_SIZE(BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS * sizeof(EAS_I32));
+    size += EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_PCM_STATE) * MAX_PCM_STREAMS);
+
+    /* allocated as PCM streams open */
+    size += EAS_HW_ARENA_BLOCK_SIZE(PCM_RING_BYTES) * MAX_PCM_STREAMS;
+#if defined(_IMA_DECODER) && (IMA_CACHE_BLOCKS > 0)
+    size += EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_IMA_CACHE));
+#endif
+
+    /* optional features, allocated when the host enables them */
+    size += EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_PCM_PREFETCH) * MAX_PCM_STREAMS);
+    size += EAS_HW_ARENA_BLOCK_SIZE(EAS_MAX_STEM_BUSES * STEM_BUS_SIZE * sizeof(EAS_I32));
+    size += EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_RESAMPLER));
+    for (module = 0; module < NUM_EFFECTS_MODULES; module++)
+    {
+        pEffect = EAS_CMEnumFXModules(module);
+        if ((pEffect != NULL) && (pEffect->instDataSize > 0))
+            size += EAS_HW_ARENA_BLOCK_SIZE(pEffect->instDataSize);
+        if ((pEffect != NULL) && (pEffect->delayDataSize > 0))
+            size += EAS_HW_ARENA_BLOCK_SIZE(pEffect->delayDataSize);
+    }
+
+    /* SMF is the largest parser, with a stream for every track */
+    streamSize = EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_SMF_DATA)) + EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_SMF_STREAM) * MAX_SMF_STREAMS);
+#ifdef _XMF_PARSER
+    streamSize += EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_XMF_DATA));
+#endif
+
+    /* in case another parser outgrows it */
+    parserSize = EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_INTERACTIVE_MIDI));
+#ifdef MMAPI_SUPPORT
+    if (parserSize < EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_TC_DATA)))
+        parserSize = EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_TC_DATA));
+#endif
+#ifdef _WAVE_PARSER
+    if (parserSize < EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_WAVE_STATE)))
+        parserSize = EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_WAVE_STATE));
+#endif
+#ifdef _OTA_PARSER
+    if (parserSize < EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_OTA_DATA)))
+        parserSize = EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_OTA_DATA));
+#endif
+#ifdef _IMELODY_PARSER
+    if (parserSize < EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_IMELODY_DATA)))
+        parserSize = EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_IMELODY_DATA));
+#endif
+#ifdef _RTTTL_PARSER
+    if (parserSize < EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_RTTTL_DATA)))
+        parserSize = EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_RTTTL_DATA));
+#endif
+    if (streamSize < parserSize)
+        streamSize = parserSize;
+
+    /* each stream may also own a synthesizer */
+    streamSize += EAS_HW_ARENA_BLOCK_SIZE(sizeof(S_SYNTH));
+    size += streamSize * MAX_NUMBER_STREAMS;
+    return size;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_InitInstance()
+ *----------------------------------------------------------------------------
+ * Common code for EAS_Init and EAS_InitArena. An arena size of zero
+ * selects the heap.
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT EAS_InitInstance (EAS_DATA_HANDLE *ppEASData, EAS_I32 arenaSize)
 {
     EAS_HW_DATA_HANDLE pHWInstData;
     EAS_RESULT result;
@@ -376,6 +505,13 @@ EAS_PUBLIC EAS_RESULT EAS_Init (EAS_DATA_HANDLE *ppEASData)
     if ((result = EAS_HWInit(&pHWInstData)) != EAS_SUCCESS)
         return result;
 
+    /* all further allocations come from the arena */
+    if (arenaSize && ((result = EAS_HWInitArena(pHWInstData, arenaSize)) != EAS_SUCCESS))
+    {
+        EAS_HWShutdown(pHWInstData);
+        return result;
+    }
+
     /* check Configuration Module for S_EAS_DATA allocation */
     if (staticMemoryModel)
         pEASData = EAS_CMEnumData(EAS_CM_EAS_DATA);
@@ -452,6 +588,293 @@ EAS_PUBLIC EAS_RESULT EAS_Init (EAS_DATA_HANDLE *ppEASData)
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_Init()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Initialize the synthesizer library
+ *
+ * Inputs:
+ *  ppEASData       - pointer to data handle variable for this instance
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_Init (EAS_DATA_HANDLE *ppEASData)
+{
+    return EAS_InitInstance(ppEASData, 0);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_InitArena()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Initialize the synthesizer library with a private memory arena
+ *
+ * Inputs:
+ *  ppEASData       - pointer to data handle variable for this instance
+ *  extraSize       - bytes to reserve beyond the library's own needs
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_InitArena (EAS_DATA_HANDLE *ppEASData, EAS_I32 extraSize)
+{
+    EAS_I32 arenaSize;
+
+    *ppEASData = NULL;
+    if (EAS_CMStaticMemoryModel() || (extraSize < 0))
+        return EAS_ERROR_INVALID_PARAMETER;
+
+    /* DLS collections, stream locators, etc. go in one more block, which
+    rounds extraSize up by at most two alignments */
+    arenaSize = EAS_ArenaSize();
+    if (extraSize > EAS_I32_MAX - arenaSize - 2 * EAS_HW_ARENA_ALIGN)
+        return EAS_ERROR_PARAMETER_RANGE;
+    if (extraSize > 0)
+        arenaSize += EAS_HW_ARENA_BLOCK_SIZE(extraSize);
+    return EAS_InitInstance(ppEASData, arenaSize);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_CloneData()
+ *----------------------------------------------------------------------------
+ * Allocates a block in the new instance and copies the template's block
+ * into it, NULL if the allocation fails
+ *----------------------------------------------------------------------------
+*/
+static void *EAS_CloneData (EAS_HW_DATA_HANDLE hwInstData, const void *pSrc, EAS_I32 size)
+{
+    void *pDst;
+
+    if ((pDst = EAS_HWMalloc(hwInstData, size)) != NULL)
+        EAS_HWMemCpy(pDst, pSrc, size);
+    return pDst;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_Clone()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Create a new instance with the configuration of an existing one
+ *
+ * Inputs:
+ *  pTemplate       - handle to an initialized instance with no open streams
+ *  ppEASData       - pointer to data handle variable for the new instance
+ *
+ * Outputs:
+ *
+ * Notes:
+ * The master volume, effects settings, polyphony and sound libraries are
+ * copied. A global DLS collection is shared by reference, so a template
+ * created with EAS_InitArena must be shut down after its clones.
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_Clone (EAS_DATA_HANDLE pTemplate, EAS_DATA_HANDLE *ppEASData)
+{
+    EAS_HW_DATA_HANDLE pHWInstData;
+    EAS_RESULT result;
+    S_EAS_DATA *pEASData;
+    EAS_I32 arenaSize;
+    EAS_INT i;
+
+    *ppEASData = NULL;
+    if (!pTemplate)
+        return EAS_ERROR_HANDLE_INTEGRITY;
+    if (pTemplate->staticMemoryModel)
+        return EAS_ERROR_INVALID_PARAMETER;
+
+    /* stream state belongs to the template */
+    for (i = 0; i < MAX_NUMBER_STREAMS; i++)
+        if (pTemplate->streams[i].handle != NULL)
+            return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
+
+    /* the clone gets an arena of its own if the template has one */
+    if ((result = EAS_HWInit(&pHWInstData)) != EAS_SUCCESS)
+        return result;
+    arenaSize = EAS_HWArenaSize(pTemplate->hwInstData);
+    if (arenaSize && ((result = EAS_HWInitArena(pHWInstData, arenaSize)) != EAS_SUCCESS))
+    {
+        EAS_HWShutdown(pHWInstData);
+        return result;
+    }
+
+    /* allocate in the same order as EAS_Init so an arena has the same layout */
+    if ((pEASData = EAS_CloneData(pHWInstData, pTemplate, sizeof(S_EAS_DATA))) == NULL)
+    {
+        EAS_HWShutdown(pHWInstData);
+        return EAS_ERROR_MALLOC_FAILED;
+    }
+
+    /* nothing is owned until it has been copied */
+    pEASData->hwInstData = pHWInstData;
+    pEASData->pVoiceMgr = NULL;
+    pEASData->pMixBuffer = NULL;
+    pEASData->pResampler = NULL;
+    pEASData->pPCMStreams = NULL;
+    pEASData->pPCMPrefetch = NULL;
+    pEASData->pcmUnderruns = 0;
+#if defined(_IMA_DECODER) && (IMA_CACHE_BLOCKS > 0)
+    pEASData->pIMACache = NULL;
+#endif
+    pEASData->pOutputAudioBuffer = NULL;
+    pEASData->ppStemOutput = NULL;
+    pEASData->pFormatOutput = NULL;
+    pEASData->pFormatRight = NULL;
+    for (i = 0; i < NUM_EFFECTS_MODULES; i++)
+        pEASData->effectsModules[i].effect = NULL;
+    EAS_HWMemSet(&pEASData->queues, 0, sizeof(pEASData->queues));
+#ifdef JET_INTERFACE
+    pEASData->jetHandle = NULL;
+#endif
+#ifdef _METRICS_ENABLED
+    pEASData->pMetricsModule = NULL;
+#endif
+
+    /* the voice manager carries the polyphony and sound libraries */
+    if ((pEASData->pVoiceMgr = EAS_CloneData(pHWInstData, pTemplate->pVoiceMgr, sizeof(S_VOICE_MGR))) == NULL)
+    {
+        result = EAS_ERROR_MALLOC_FAILED;
+        goto Fail;
+    }
+    pEASData->pVoiceMgr->pStemBuffer = NULL;
+    pEASData->pVoiceMgr->numStemBuses = 0;
+#ifdef DLS_SYNTHESIZER
+    if (pEASData->pVoiceMgr->pGlobalDLS)
+        DLSAddRef(pEASData->pVoiceMgr->pGlobalDLS);
+#endif
+
+    /* the mix buffer is scratch space */
+    if ((pEASData->pMixBuffer = EAS_HWMalloc(pHWInstData, BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS * sizeof(EAS_I32))) == NULL)
+    {
+        result = EAS_ERROR_MALLOC_FAILED;
+        goto Fail;
+    }
+    EAS_HWMemSet(pEASData->pMixBuffer, 0, BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS * sizeof(EAS_I32));
+
+    /* effects copy their presets and any delay lines they have allocated */
+    for (i = 0; i < NUM_EFFECTS_MODULES; i++)
+    {
+        S_EFFECTS_INTERFACE *pEffect = pTemplate->effectsModules[i].effect;
+        if ((pEffect == NULL) || (pTemplate->effectsModules[i].effectData == NULL))
+            continue;
+        if (pEffect->pfClone == NULL)
+        {
+            result = EAS_ERROR_FEATURE_NOT_AVAILABLE;
+            goto Fail;
+        }
+        if ((result = (*pEffect->pfClone)(pEASData, pTemplate->effectsModules[i].effectData, &pEASData->effectsModules[i].effectData)) != EAS_SUCCESS)
+            goto Fail;
+        pEASData->effectsModules[i].effect = pEffect;
+    }
+
+    if ((pEASData->pPCMStreams = EAS_CloneData(pHWInstData, pTemplate->pPCMStreams, sizeof(S_PCM_STATE) * MAX_PCM_STREAMS)) == NULL)
+    {
+        result = EAS_ERROR_MALLOC_FAILED;
+        goto Fail;
+    }
+    for (i = 0; i < MAX_PCM_STREAMS; i++)
+        pEASData->pPCMStreams[i].pRing = NULL;
+
+    /* the clone reads ahead with buffers of its own */
+    if (pTemplate->pPCMPrefetch && ((result = EAS_PESetPrefetch(pEASData, EAS_TRUE)) != EAS_SUCCESS))
+        goto Fail;
+
+    /* and resamples with a filter of its own */
+    if (pTemplate->pResampler &&
+        ((result = EAS_SetOutputSampleRate(pEASData, pTemplate->pResampler->outputRate)) != EAS_SUCCESS))
+        goto Fail;
+
+    /* and mixes into stem buses of its own */
+    if (pTemplate->pVoiceMgr->numStemBuses &&
+        ((result = VMSetStemBuses(pEASData, pTemplate->pVoiceMgr->numStemBuses)) != EAS_SUCCESS))
+        goto Fail;
+
+#ifdef _METRICS_ENABLED
+    /* metrics are collected per instance */
+    pEASData->pMetricsModule = pTemplate->pMetricsModule;
+    if (pEASData->pMetricsModule != NULL)
+    {
+        if ((result = (*pEASData->pMetricsModule->pfInit)(pEASData, &pEASData->pMetricsData)) != EAS_SUCCESS)
+        {
+            pEASData->pMetricsModule = NULL;
+            goto Fail;
+        }
+    }
+#endif
+
+    *ppEASData = pEASData;
+    return EAS_SUCCESS;
+
+Fail:
+    EAS_Shutdown(pEASData);
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_Reset()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns an instance to the state left by EAS_Init without freeing or
+ * allocating the instance data
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  flags           - EAS_RESET_KEEP_DLS to keep the global DLS collection
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_Reset (EAS_DATA_HANDLE pEASData, EAS_I32 flags)
+{
+    EAS_RESULT reportResult;
+    EAS_RESULT result;
+    EAS_INT i;
+
+    /* check for NULL handle */
+    if (!pEASData)
+        return EAS_ERROR_HANDLE_INTEGRITY;
+
+    /* close any open streams, this also releases their synthesizers */
+    reportResult = EAS_SUCCESS;
+    for (i = 0; i < MAX_NUMBER_STREAMS; i++)
+    {
+        if (pEASData->streams[i].pParserModule && pEASData->streams[i].handle)
+        {
+            if ((result = EAS_CloseFile(pEASData, &pEASData->streams[i])) != EAS_SUCCESS)
+                reportResult = result;
+        }
+    }
+
+    /* discard anything still queued for the render thread */
+    EAS_HWMemSet(&pEASData->queues, 0, sizeof(pEASData->queues));
+
+    /* voices, polyphony and sound libraries */
+    VMResetVoiceMgr(pEASData, (flags & EAS_RESET_KEEP_DLS) ? EAS_TRUE : EAS_FALSE);
+
+    /* effects go back to their default presets with empty delay lines */
+    for (i = 0; i < NUM_EFFECTS_MODULES; i++)
+    {
+        if (pEASData->effectsModules[i].effect && pEASData->effectsModules[i].effectData)
+            (*pEASData->effectsModules[i].effect->pfReset)(pEASData->effectsModules[i].effectData);
+    }
+
+    EAS_PEClear(pEASData);
+
+    /* the resampler keeps its rate but not the buffered input */
+    if (pEASData->pResampler)
+        EAS_ResamplerReset(pEASData->pResampler);
+
+    pEASData->pOutputAudioBuffer = NULL;
+    pEASData->renderTime = 0;
+    EAS_SetVolume(pEASData, NULL, DEFAULT_VOLUME);
+
+    return reportResult;
+}
+
 /*----------------------------------------------------------------------------
  * EAS_Shutdown()
  *----------------------------------------------------------------------------
@@ -525,6 +948,10 @@ EAS_PUBLIC EAS_RESULT EAS_Shutdown (EAS_DATA_HANDLE pEASData)
     /* shutdown the voice manager & synthesizer */
     VMShutdown(pEASData);
 
+    /* free the resampler */
+    if (pEASData->pResampler)
+        EAS_HWFree(hwInstData, pEASData->pResampler);
+
 #ifdef _METRICS_ENABLED
     /* shutdown the metrics module */
     if (pEASData->pMetricsModule != NULL)
@@ -683,48 +1110,271 @@ EAS_PUBLIC EAS_RESULT EAS_OpenFile (EAS_DATA_HANDLE pEASData, EAS_FILE_LOCATOR l
     return EAS_ERROR_UNRECOGNIZED_FORMAT;
 }
 
-#ifdef MMAPI_SUPPORT
 /*----------------------------------------------------------------------------
- * EAS_MMAPIToneControl()
+ * EAS_StreamBufferFill()
  *----------------------------------------------------------------------------
  * Purpose:
- * Opens a ToneControl file for audio playback.
- *
- * Inputs:
- * pEASData         - pointer to overall EAS data structure
- * pHandle          - pointer to file handle
- *
- * Outputs:
- *
- *
- * Side Effects:
- *
+ * Reads from the sequential source until the buffer holds at least
+ * numBytes bytes or the end of the source is reached.
  *----------------------------------------------------------------------------
 */
-EAS_PUBLIC EAS_RESULT EAS_MMAPIToneControl (EAS_DATA_HANDLE pEASData, EAS_FILE_LOCATOR locator, EAS_HANDLE *ppStream)
+static void EAS_StreamBufferFill (S_EAS_STREAM_BUFFER *pBuf, EAS_I32 numBytes)
 {
-    EAS_RESULT result;
-    EAS_FILE_HANDLE fileHandle;
-    EAS_VOID_PTR streamHandle;
-    S_FILE_PARSER_INTERFACE *pParserModule;
-    EAS_INT streamNum;
+    EAS_U8 *pData;
+    EAS_I32 capacity;
+    int count;
 
-    /* check if the tone control parser is available */
-    *ppStream = NULL;
-    streamHandle = NULL;
-    pParserModule = EAS_CMEnumOptModules(EAS_MODULE_MMAPI_TONE_CONTROL);
-    if (pParserModule == NULL)
+    while (!pBuf->eof && (pBuf->length < numBytes))
     {
-        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "EAS_MMAPIToneControl: ToneControl parser not available\n"); */ }
-        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
-    }
-
-    /* open the file */
-    if ((result = EAS_HWOpenFile(pEASData->hwInstData, locator, &fileHandle, EAS_FILE_READ)) != EAS_SUCCESS)
-        return result;
-
-    /* allocate a stream */
-    if ((streamNum = EAS_AllocateStream(pEASData)) < 0)
+        /* grow the buffer */
+        if (pBuf->length == pBuf->capacity)
+        {
+            if (pBuf->capacity > (STREAM_BUFFER_SIZE_UNKNOWN >> 1))
+            {
+                pBuf->eof = EAS_TRUE;
+                break;
+            }
+            capacity = pBuf->capacity ? (pBuf->capacity << 1) : STREAM_BUFFER_MIN_SIZE;
+            if ((pData = EAS_HWMalloc(pBuf->hwInstData, capacity)) == NULL)
+            {
+                pBuf->eof = EAS_TRUE;
+                break;
+            }
+            if (pBuf->pData)
+            {
+                EAS_HWMemCpy(pData, pBuf->pData, pBuf->length);
+                EAS_HWFree(pBuf->hwInstData, pBuf->pData);
+            }
+            pBuf->pData = pData;
+            pBuf->capacity = capacity;
+        }
+
+        /* take whatever the source has available */
+        count = pBuf->read(pBuf->handle, pBuf->pData + pBuf->length, (int) (pBuf->capacity - pBuf->length));
+        if (count <= 0)
+            pBuf->eof = EAS_TRUE;
+        else
+            pBuf->length += count;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_StreamBufferReadAt()
+ *----------------------------------------------------------------------------
+ * readAt callback of a stream locator
+ *----------------------------------------------------------------------------
+*/
+static int EAS_StreamBufferReadAt (void *handle, void *buf, int offset, int size)
+{
+    S_EAS_STREAM_BUFFER *pBuf = (S_EAS_STREAM_BUFFER*) handle;
+
+    if ((offset < 0) || (size <= 0))
+        return 0;
+
+    EAS_StreamBufferFill(pBuf, (EAS_I32) offset + size);
+    if (offset >= pBuf->length)
+        return 0;
+    if (size > pBuf->length - offset)
+        size = (int) (pBuf->length - offset);
+    EAS_HWMemCpy(buf, pBuf->pData + offset, size);
+    return size;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_StreamBufferSize()
+ *----------------------------------------------------------------------------
+ * size callback of a stream locator. The size is not known until the
+ * source has been read to the end.
+ *----------------------------------------------------------------------------
+*/
+static int EAS_StreamBufferSize (void *handle)
+{
+    S_EAS_STREAM_BUFFER *pBuf = (S_EAS_STREAM_BUFFER*) handle;
+
+    if (pBuf->eof)
+        return (int) pBuf->length;
+    return STREAM_BUFFER_SIZE_UNKNOWN;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_OpenStreamLocator()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Creates a file locator for a sequential, non-seekable source such as a
+ * pipe or a socket.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - source handle passed to the read function
+ * read             - read function
+ * pLocator         - pointer to variable to receive the locator
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_OpenStreamLocator (EAS_DATA_HANDLE pEASData, void *handle, int (*read)(void *handle, void *buf, int size), EAS_FILE_LOCATOR *pLocator)
+{
+    S_EAS_STREAM_BUFFER *pBuf;
+
+    *pLocator = NULL;
+    if (read == NULL)
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    if ((pBuf = EAS_HWMalloc(pEASData->hwInstData, sizeof(S_EAS_STREAM_BUFFER))) == NULL)
+        return EAS_ERROR_MALLOC_FAILED;
+    EAS_HWMemSet(pBuf, 0, sizeof(S_EAS_STREAM_BUFFER));
+
+    pBuf->hwInstData = pEASData->hwInstData;
+    pBuf->read = read;
+    pBuf->handle = handle;
+    pBuf->locator.handle = pBuf;
+    pBuf->locator.readAt = EAS_StreamBufferReadAt;
+    pBuf->locator.size = EAS_StreamBufferSize;
+
+    *pLocator = &pBuf->locator;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_CloseStreamLocator()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Frees a locator created by EAS_OpenStreamLocator and its buffered data.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * locator          - locator to free
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_CloseStreamLocator (EAS_DATA_HANDLE pEASData, EAS_FILE_LOCATOR locator)
+{
+    S_EAS_STREAM_BUFFER *pBuf;
+
+    if (locator == NULL)
+        return EAS_ERROR_INVALID_HANDLE;
+
+    pBuf = (S_EAS_STREAM_BUFFER*) locator->handle;
+    if (pBuf->pData)
+        EAS_HWFree(pEASData->hwInstData, pBuf->pData);
+    EAS_HWFree(pEASData->hwInstData, pBuf);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_OpenMemoryLocator()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Creates a file locator for a file held in memory, such as a file mapped
+ * with mmap. Linear PCM in a WAVE file is read in place.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pData            - file data
+ * size             - size of the file data in bytes
+ * pLocator         - pointer to variable to receive the locator
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_OpenMemoryLocator (EAS_DATA_HANDLE pEASData, const void *pData, EAS_I32 size, EAS_FILE_LOCATOR *pLocator)
+{
+    EAS_HW_MEMORY_FILE *pMemFile;
+
+    *pLocator = NULL;
+    if ((pData == NULL) || (size <= 0))
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    if ((pMemFile = EAS_HWMalloc(pEASData->hwInstData, sizeof(EAS_HW_MEMORY_FILE))) == NULL)
+        return EAS_ERROR_MALLOC_FAILED;
+    EAS_HWInitMemoryFile(pMemFile, pData, size);
+
+    *pLocator = &pMemFile->locator;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_CloseMemoryLocator()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Frees a locator created by EAS_OpenMemoryLocator. The file data is not
+ * touched.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * locator          - locator to free
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_CloseMemoryLocator (EAS_DATA_HANDLE pEASData, EAS_FILE_LOCATOR locator)
+{
+    if (locator == NULL)
+        return EAS_ERROR_INVALID_HANDLE;
+
+    EAS_HWFree(pEASData->hwInstData, locator->handle);
+    return EAS_SUCCESS;
+}
+
+#ifdef MMAPI_SUPPORT
+/*----------------------------------------------------------------------------
+ * EAS_MMAPIToneControl()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Opens a ToneControl file for audio playback.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pHandle          - pointer to file handle
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_MMAPIToneControl (EAS_DATA_HANDLE pEASData, EAS_FILE_LOCATOR locator, EAS_HANDLE *ppStream)
+{
+    EAS_RESULT result;
+    EAS_FILE_HANDLE fileHandle;
+    EAS_VOID_PTR streamHandle;
+    S_FILE_PARSER_INTERFACE *pParserModule;
+    EAS_INT streamNum;
+
+    /* check if the tone control parser is available */
+    *ppStream = NULL;
+    streamHandle = NULL;
+    pParserModule = EAS_CMEnumOptModules(EAS_MODULE_MMAPI_TONE_CONTROL);
+    if (pParserModule == NULL)
+    {
+        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "EAS_MMAPIToneControl: ToneControl parser not available\n"); */ }
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+    }
+
+    /* open the file */
+    if ((result = EAS_HWOpenFile(pEASData->hwInstData, locator, &fileHandle, EAS_FILE_READ)) != EAS_SUCCESS)
+        return result;
+
+    /* allocate a stream */
+    if ((streamNum = EAS_AllocateStream(pEASData)) < 0)
         return EAS_ERROR_MAX_STREAMS_OPEN;
 
     /* see if ToneControl parser recognizes it */
@@ -763,7 +1413,7 @@ EAS_PUBLIC EAS_RESULT EAS_MMAPIToneControl (EAS_DATA_HANDLE pEASData, EAS_FILE_L
 EAS_PUBLIC EAS_RESULT EAS_GetWaveFmtChunk (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_VOID_PTR *ppFmtChunk)
 {
     EAS_RESULT result;
-    EAS_I32 value;
+    EAS_INTPTR value;
 
     if ((result = EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_FORMAT, &value)) != EAS_SUCCESS)
         return result;
@@ -784,9 +1434,15 @@ EAS_PUBLIC EAS_RESULT EAS_GetWaveFmtChunk (S_EAS_DATA *pEASData, EAS_HANDLE pStr
 */
 EAS_PUBLIC EAS_RESULT EAS_GetFileType (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_I32 *pFileType)
 {
+    EAS_RESULT result;
+    EAS_INTPTR value;
+
     if (!EAS_StreamReady (pEASData, pStream))
         return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
-    return EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_FILE_TYPE, pFileType);
+    if ((result = EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_FILE_TYPE, &value)) != EAS_SUCCESS)
+        return result;
+    *pFileType = (EAS_I32) value;
+    return EAS_SUCCESS;
 }
 
 /*----------------------------------------------------------------------------
@@ -830,6 +1486,10 @@ EAS_PUBLIC EAS_RESULT EAS_Prepare (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream)
             /* set volume */
             if (result == EAS_SUCCESS)
                 result = EAS_SetVolume(pEASData, pStream, pStream->volume);
+
+            /* offline, the silence before the first note is skipped */
+            if (result == EAS_SUCCESS)
+                pEASData->offlineLeading = pEASData->offlineMode;
         }
         else
             result = EAS_ERROR_NOT_VALID_IN_THIS_STATE;
@@ -840,10 +1500,159 @@ EAS_PUBLIC EAS_RESULT EAS_Prepare (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream)
 }
 
 /*----------------------------------------------------------------------------
- * EAS_Render()
+ * EAS_ProcessQueues()
  *----------------------------------------------------------------------------
  * Purpose:
- * Parse the Midi data and render PCM audio data.
+ * Applies the parameter changes and MIDI data queued by the control thread.
+ * Entries for streams that were closed after being queued are discarded,
+ * as are those for a stream closed and another opened in the same slot.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void EAS_ProcessQueues (S_EAS_DATA *pEASData)
+{
+    S_PARAM_QUEUE_EVENT paramEvent;
+    S_MIDI_QUEUE_EVENT midiEvent;
+
+    /* parameters first, so notes in this frame start with the new settings */
+    while (EAS_QueueGetParam(&pEASData->queues, &paramEvent) == EAS_SUCCESS)
+    {
+        if (paramEvent.type == PARAM_QUEUE_SET_VOLUME)
+        {
+            if ((paramEvent.pStream == NULL) ||
+                ((paramEvent.pStream->handle != NULL) && (paramEvent.generation == paramEvent.pStream->generation)))
+                (void) EAS_SetVolume(pEASData, paramEvent.pStream, paramEvent.value);
+        }
+        else
+            (void) EAS_SetParameter(pEASData, paramEvent.module, paramEvent.param, paramEvent.value);
+    }
+
+    while (EAS_QueueGetMIDI(&pEASData->queues, &midiEvent) == EAS_SUCCESS)
+    {
+        if ((midiEvent.pStream->handle != NULL) && (midiEvent.generation == midiEvent.pStream->generation))
+            (void) EAS_WriteMIDIStream(pEASData, midiEvent.pStream, midiEvent.data, midiEvent.count);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_OfflineSkipFrame()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * In offline mode, returns EAS_TRUE if the frame just parsed is part of the
+ * silence before the first note. The frame is not rendered and the parsers
+ * move on to the next one. The leading silence ends with the first voice
+ * or PCM stream that sounds.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL EAS_OfflineSkipFrame (S_EAS_DATA *pEASData)
+{
+    S_FILE_PARSER_INTERFACE *pParserModule;
+    S_PCM_STATE *pState;
+    EAS_STATE parserState;
+    EAS_BOOL parsing;
+    EAS_INT i;
+
+    if (!pEASData->offlineLeading)
+        return EAS_FALSE;
+
+    /* anything sounding ends the leading silence */
+    if (pEASData->pVoiceMgr->activeVoices != 0)
+    {
+        pEASData->offlineLeading = EAS_FALSE;
+        return EAS_FALSE;
+    }
+    if (pEASData->pPCMStreams != NULL)
+    {
+        for (i = 0, pState = pEASData->pPCMStreams; i < MAX_PCM_STREAMS; i++, pState++)
+        {
+            if ((pState->fileHandle) && (pState->state != EAS_STATE_STOPPED) && (pState->state != EAS_STATE_PAUSED))
+            {
+                pEASData->offlineLeading = EAS_FALSE;
+                return EAS_FALSE;
+            }
+        }
+    }
+
+    /* let the effect tails of an earlier stream play out */
+    for (i = 0; i < NUM_EFFECTS_MODULES; i++)
+    {
+        if (pEASData->effectsModules[i].effectData == NULL)
+            continue;
+        if ((pEASData->effectsModules[i].effect->pfIsSilent == NULL) ||
+            !(*pEASData->effectsModules[i].effect->pfIsSilent)(pEASData->effectsModules[i].effectData))
+            return EAS_FALSE;
+    }
+
+    /* only skip while a file parser has events ahead, live MIDI streams have no timeline */
+    parsing = EAS_FALSE;
+    for (i = 0; i < MAX_NUMBER_STREAMS; i++)
+    {
+        pParserModule = (S_FILE_PARSER_INTERFACE*) pEASData->streams[i].pParserModule;
+        if ((pParserModule == NULL) || (pParserModule->pfTime == NULL))
+            continue;
+        if ((*pParserModule->pfState)(pEASData, pEASData->streams[i].handle, &parserState) != EAS_SUCCESS)
+            return EAS_FALSE;
+        if ((parserState == EAS_STATE_READY) || (parserState == EAS_STATE_PLAY))
+            parsing = EAS_TRUE;
+    }
+    if (!parsing)
+        return EAS_FALSE;
+
+    /* the frame is skipped, parse the next one */
+    pEASData->renderTime += AUDIO_FRAME_LENGTH;
+    for (i = 0; i < MAX_NUMBER_STREAMS; i++)
+        if (pEASData->streams[i].pParserModule != NULL)
+            pEASData->streams[i].streamFlags &= ~STREAM_FLAGS_PARSED;
+    return EAS_TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_OfflineTrimTail()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * In offline mode, ends the release tails of a stream that has parsed all
+ * of its events once every voice has faded below the tail level.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pStream         - stream handle
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void EAS_OfflineTrimTail (S_EAS_DATA *pEASData, EAS_HANDLE pStream)
+{
+    S_FILE_PARSER_INTERFACE *pParserModule;
+    EAS_STATE parserState;
+    EAS_INTPTR synthHandle;
+
+    pParserModule = (S_FILE_PARSER_INTERFACE*) pStream->pParserModule;
+    if ((*pParserModule->pfState)(pEASData, pStream->handle, &parserState) != EAS_SUCCESS)
+        return;
+    if (parserState != EAS_STATE_STOPPING)
+        return;
+    if (EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_SYNTH_HANDLE, &synthHandle) != EAS_SUCCESS)
+        return;
+    VMMuteQuietVoices(pEASData->pVoiceMgr, (S_SYNTH*) synthHandle, pEASData->offlineTailGain);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderFrame()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Parse the Midi data and render PCM audio data at the compiled sample rate.
  *
  * Inputs:
  *  pEASData        - buffer for internal EAS data
@@ -856,7 +1665,7 @@ EAS_PUBLIC EAS_RESULT EAS_Prepare (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream)
  *
  *----------------------------------------------------------------------------
 */
-EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+static EAS_RESULT EAS_RenderFrame (S_EAS_DATA *pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
 {
     S_FILE_PARSER_INTERFACE *pParserModule;
     EAS_RESULT result;
@@ -866,6 +1675,7 @@ EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I
 
     /* assume no samples generated and reset workload */
     *pNumGenerated = 0;
+    pEASData->silentFrame = EAS_FALSE;
     VMInitWorkload(pEASData->pVoiceMgr);
 
     /* no support for other buffer sizes yet */
@@ -894,6 +1704,8 @@ EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I
     /* save the output buffer pointer */
     pEASData->pOutputAudioBuffer = pOut;
 
+    /* apply events queued from other threads */
+    EAS_ProcessQueues(pEASData);
 
 #ifdef _METRICS_ENABLED
         /* start performance counter */
@@ -903,84 +1715,91 @@ EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I
 
     /* if we haven't finished parsing from last time, do it now */
     /* need to parse another frame of events before we render again */
-    for (streamNum = 0; streamNum < MAX_NUMBER_STREAMS; streamNum++)
+    do
     {
-        /* clear the locate flag */
-        pEASData->streams[streamNum].streamFlags &= ~STREAM_FLAGS_LOCATE;
-
-        if (pEASData->streams[streamNum].pParserModule)
+        for (streamNum = 0; streamNum < MAX_NUMBER_STREAMS; streamNum++)
         {
+            /* clear the locate flag */
+            pEASData->streams[streamNum].streamFlags &= ~STREAM_FLAGS_LOCATE;
 
-            /* establish pointer to parser module */
-            pParserModule = pEASData->streams[streamNum].pParserModule;
+            if (pEASData->streams[streamNum].pParserModule)
+            {
+
+                /* establish pointer to parser module */
+                pParserModule = pEASData->streams[streamNum].pParserModule;
 
 #ifdef JET_INTERFACE
-            /* handle pause */
-            if (pEASData->streams[streamNum].streamFlags & STREAM_FLAGS_PAUSE)
-            {
-                if (pParserModule->pfPause)
-                    result = pParserModule->pfPause(pEASData, pEASData->streams[streamNum].handle);
-                pEASData->streams[streamNum].streamFlags &= ~STREAM_FLAGS_PAUSE;
-            }
+                /* handle pause */
+                if (pEASData->streams[streamNum].streamFlags & STREAM_FLAGS_PAUSE)
+                {
+                    if (pParserModule->pfPause)
+                        result = pParserModule->pfPause(pEASData, pEASData->streams[streamNum].handle);
+                    pEASData->streams[streamNum].streamFlags &= ~STREAM_FLAGS_PAUSE;
+                }
 #endif
 
-            /* get current state */
-            if ((result = (*pParserModule->pfState)(pEASData, pEASData->streams[streamNum].handle, &parserState)) != EAS_SUCCESS)
-                return result;
+                /* get current state */
+                if ((result = (*pParserModule->pfState)(pEASData, pEASData->streams[streamNum].handle, &parserState)) != EAS_SUCCESS)
+                    return result;
 
 #ifdef JET_INTERFACE
-            /* handle resume */
-            if (parserState == EAS_STATE_PAUSED)
-            {
-                if (pEASData->streams[streamNum].streamFlags & STREAM_FLAGS_RESUME)
+                /* handle resume */
+                if (parserState == EAS_STATE_PAUSED)
                 {
-                    if (pParserModule->pfResume)
-                        result = pParserModule->pfResume(pEASData, pEASData->streams[streamNum].handle);
-                    pEASData->streams[streamNum].streamFlags &= ~STREAM_FLAGS_RESUME;
+                    if (pEASData->streams[streamNum].streamFlags & STREAM_FLAGS_RESUME)
+                    {
+                        if (pParserModule->pfResume)
+                            result = pParserModule->pfResume(pEASData, pEASData->streams[streamNum].handle);
+                        pEASData->streams[streamNum].streamFlags &= ~STREAM_FLAGS_RESUME;
+                    }
                 }
-            }
 #endif
 
-            /* if necessary, parse stream */
-            if ((pEASData->streams[streamNum].streamFlags & STREAM_FLAGS_PARSED) == 0)
-                if ((result = EAS_ParseEvents(pEASData, &pEASData->streams[streamNum], pEASData->streams[streamNum].time + pEASData->streams[streamNum].frameLength, eParserModePlay)) != EAS_SUCCESS)
-                    return result;
+                /* if necessary, parse stream */
+                if ((pEASData->streams[streamNum].streamFlags & STREAM_FLAGS_PARSED) == 0)
+                    if ((result = EAS_ParseEvents(pEASData, &pEASData->streams[streamNum], pEASData->streams[streamNum].time + pEASData->streams[streamNum].frameLength, eParserModePlay)) != EAS_SUCCESS)
+                        return result;
 
-            /* check for an early abort */
-            if ((pEASData->streams[streamNum].streamFlags) == 0)
-            {
+                /* offline, end the release tails once they are inaudible */
+                if (pEASData->offlineMode)
+                    EAS_OfflineTrimTail(pEASData, &pEASData->streams[streamNum]);
+
+                /* check for an early abort */
+                if ((pEASData->streams[streamNum].streamFlags) == 0)
+                {
 
 #ifdef _METRICS_ENABLED
-                /* stop performance counter */
-                if (pEASData->pMetricsData)
-                    (*pEASData->pMetricsModule->pfStartTimer)(pEASData->pMetricsData, EAS_PM_TOTAL_TIME);
+                    /* stop performance counter */
+                    if (pEASData->pMetricsData)
+                        (*pEASData->pMetricsModule->pfStartTimer)(pEASData->pMetricsData, EAS_PM_TOTAL_TIME);
 #endif
 
-                return EAS_SUCCESS;
-            }
-
-            /* check for repeat */
-            if (pEASData->streams[streamNum].repeatCount)
-            {
+                    return EAS_SUCCESS;
+                }
 
-                /* check for stopped state */
-                if ((result = (*pParserModule->pfState)(pEASData, pEASData->streams[streamNum].handle, &parserState)) != EAS_SUCCESS)
-                    return result;
-                if (parserState == EAS_STATE_STOPPED)
+                /* check for repeat */
+                if (pEASData->streams[streamNum].repeatCount)
                 {
 
-                    /* decrement repeat count, unless it is negative */
-                    if (pEASData->streams[streamNum].repeatCount > 0)
-                        pEASData->streams[streamNum].repeatCount--;
-
-                    /* reset the parser */
-                    if ((result = (*pParserModule->pfReset)(pEASData, pEASData->streams[streamNum].handle)) != EAS_SUCCESS)
+                    /* check for stopped state */
+                    if ((result = (*pParserModule->pfState)(pEASData, pEASData->streams[streamNum].handle, &parserState)) != EAS_SUCCESS)
                         return result;
-                    pEASData->streams[streamNum].time = 0;
+                    if (parserState == EAS_STATE_STOPPED)
+                    {
+
+                        /* decrement repeat count, unless it is negative */
+                        if (pEASData->streams[streamNum].repeatCount > 0)
+                            pEASData->streams[streamNum].repeatCount--;
+
+                        /* reset the parser */
+                        if ((result = (*pParserModule->pfReset)(pEASData, pEASData->streams[streamNum].handle)) != EAS_SUCCESS)
+                            return result;
+                        pEASData->streams[streamNum].time = 0;
+                    }
                 }
             }
         }
-    }
+    } while (EAS_OfflineSkipFrame(pEASData));
 
 #ifdef _METRICS_ENABLED
     /* stop performance counter */
@@ -1030,74 +1849,517 @@ EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I
         return result;
     }
 
-#ifdef _METRICS_ENABLED
-    /* stop the stream timer */
-    if (pEASData->pMetricsData)
-        (void)(*pEASData->pMetricsModule->pfStopTimer)(pEASData->pMetricsData, EAS_PM_STREAM_TIME);
-#endif
+#ifdef _METRICS_ENABLED
+    /* stop the stream timer */
+    if (pEASData->pMetricsData)
+        (void)(*pEASData->pMetricsModule->pfStopTimer)(pEASData->pMetricsData, EAS_PM_STREAM_TIME);
+#endif
+
+#ifdef _METRICS_ENABLED
+    /* start the post timer */
+    if (pEASData->pMetricsData)
+        (*pEASData->pMetricsModule->pfStartTimer)(pEASData->pMetricsData, EAS_PM_POST_TIME);
+#endif
+
+    /* for split architecture, send DSP vectors.  Do post only if return is TRUE */
+#ifdef _SPLIT_ARCHITECTURE
+    if (VMEndFrame(pEASData))
+    {
+        /* now do post-processing */
+        EAS_MixEnginePost(pEASData, numRequested);
+        *pNumGenerated = numRequested;
+    }
+#else
+    /* now do post-processing */
+    EAS_MixEnginePost(pEASData, numRequested);
+    *pNumGenerated = numRequested;
+#endif
+
+    /* offline, follow the output level to find the end of the effect tails */
+    if (pEASData->offlineMode)
+    {
+        pEASData->offlinePeak = 0;
+        if (!pEASData->silentFrame)
+        {
+            EAS_I32 i;
+            for (i = 0; i < *pNumGenerated * NUM_OUTPUT_CHANNELS; i++)
+            {
+                if (pOut[i] > pEASData->offlinePeak)
+                    pEASData->offlinePeak = pOut[i];
+                else if (-pOut[i] > pEASData->offlinePeak)
+                    pEASData->offlinePeak = (EAS_I16) -pOut[i];
+            }
+        }
+    }
+
+#ifdef _METRICS_ENABLED
+    /* stop the post timer */
+    if (pEASData->pMetricsData)
+        (void)(*pEASData->pMetricsModule->pfStopTimer)(pEASData->pMetricsData, EAS_PM_POST_TIME);
+#endif
+
+    /* advance render time */
+    pEASData->renderTime += AUDIO_FRAME_LENGTH;
+
+#if 0
+    /* dump workload for debug */
+    if (pEASData->pVoiceMgr->workload)
+        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "Workload = %d\n", pEASData->pVoiceMgr->workload); */ }
+#endif
+
+#ifdef _METRICS_ENABLED
+    /* stop performance counter */
+    if (pEASData->pMetricsData)
+    {
+        PERF_TIMER temp;
+        temp = (*pEASData->pMetricsModule->pfStopTimer)(pEASData->pMetricsData, EAS_PM_TOTAL_TIME);
+
+        /* if max render time, record the number of voices and time */
+        if ((*pEASData->pMetricsModule->pfRecordMaxValue)
+            (pEASData->pMetricsData, EAS_PM_MAX_CYCLES, (EAS_U32) temp))
+        {
+            (*pEASData->pMetricsModule->pfRecordValue)(pEASData->pMetricsData, EAS_PM_MAX_CYCLES_VOICES, (EAS_U32) voicesRendered);
+            (*pEASData->pMetricsModule->pfRecordValue)(pEASData->pMetricsData, EAS_PM_MAX_CYCLES_TIME, (EAS_I32) (pEASData->renderTime >> 8));
+        }
+    }
+#endif
+
+#ifdef JET_INTERFACE
+    /* let JET to do its thing */
+    if (pEASData->jetHandle != NULL)
+    {
+        result = JET_Process(pEASData);
+        if (result != EAS_SUCCESS)
+            return result;
+    }
+#endif
+
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_Render()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Parse the Midi data and render PCM audio data.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pOut            - output buffer pointer
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ * Notes:
+ * With an output sample rate set, buffers are rendered at the compiled
+ * sample rate into the resampler until it has enough input for pOut. For
+ * the 32-bit formats and planar output they are also rendered as float
+ * into the resampler, and its float output is converted to the format.
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+{
+    float formatBuffer[BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS];
+    EAS_VOID_PTR pFormatOutput;
+    EAS_VOID_PTR pFormatRight;
+    EAS_PCM *pIn;
+    float *pFloatIn;
+    EAS_RESULT result;
+    EAS_BOOL silent;
+    EAS_I32 count;
+    EAS_U8 format;
+    EAS_BOOL8 mix;
+
+    if (pEASData->pResampler == NULL)
+        return EAS_RenderFrame(pEASData, pOut, numRequested, pNumGenerated);
+
+    *pNumGenerated = 0;
+    if (numRequested != BUFFER_SIZE_IN_MONO_SAMPLES)
+        return EAS_BUFFER_SIZE_MISMATCH;
+
+    /* the stems are written at the compiled sample rate */
+    if (pEASData->ppStemOutput)
+        return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
+
+    /* the caller's format output is written from the resampler output */
+    pFormatOutput = pEASData->pFormatOutput;
+    pFormatRight = pEASData->pFormatRight;
+    format = pEASData->outputFormat;
+    mix = pEASData->formatMix;
+
+    /* the output is silent if every buffer that went into it was */
+    silent = pEASData->silentFrame;
+    while ((pIn = EAS_ResamplerGetBuffer(pEASData->pResampler, numRequested, &pFloatIn)) != NULL)
+    {
+        if (pFormatOutput)
+        {
+            pEASData->pFormatOutput = pFloatIn;
+            pEASData->pFormatRight = NULL;
+            pEASData->outputFormat = EAS_FORMAT_FLOAT32;
+            pEASData->formatMix = EAS_FALSE;
+        }
+        result = EAS_RenderFrame(pEASData, pIn, BUFFER_SIZE_IN_MONO_SAMPLES, &count);
+        pEASData->pFormatOutput = pFormatOutput;
+        pEASData->pFormatRight = pFormatRight;
+        pEASData->outputFormat = format;
+        pEASData->formatMix = mix;
+        if (result != EAS_SUCCESS)
+            return result;
+        if (count == 0)
+            return EAS_SUCCESS;
+        EAS_ResamplerAddFrames(pEASData->pResampler, count, pFormatOutput != NULL);
+        silent = silent && pEASData->silentFrame;
+    }
+    silent = EAS_ResamplerProcess(pEASData->pResampler, pOut, pFormatOutput ? formatBuffer : NULL, numRequested) && silent;
+    pEASData->silentFrame = (EAS_BOOL8) silent;
+    if (pFormatOutput)
+        EAS_MixEngineResampled(pEASData, pOut, formatBuffer, numRequested);
+    *pNumGenerated = numRequested;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderEx()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Render a buffer and report whether it is silent.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pOut            - output buffer pointer
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *  pFlags          - receives the EAS_RENDER flags
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderEx (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated, EAS_U32 *pFlags)
+{
+    EAS_RESULT result;
+
+    *pFlags = 0;
+    if ((result = EAS_Render(pEASData, pOut, numRequested, pNumGenerated)) != EAS_SUCCESS)
+        return result;
+    if (pEASData->silentFrame && (*pNumGenerated > 0))
+        *pFlags |= EAS_RENDER_SILENT;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderFormatted()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Render a buffer in a 32-bit format or to planar buffers, either written
+ * to the buffers or, scaled by mixGain, added to them.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pOut            - output buffer pointer, or left channel if planar
+ *  pRight          - right channel output buffer pointer, NULL if interleaved
+ *  format          - EAS_FORMAT output format
+ *  mix             - EAS_TRUE to add to the buffer
+ *  mixGain         - gain applied when adding
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT EAS_RenderFormatted (S_EAS_DATA *pEASData, void *pOut, void *pRight, EAS_I32 format, EAS_BOOL mix, EAS_I32 mixGain, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+{
+    EAS_PCM fxBuffer[BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS];
+    EAS_RESULT result;
+
+    *pNumGenerated = 0;
+    if ((format < EAS_FORMAT_PCM16) || (format > (mix ? EAS_FORMAT_INT32_MIX : EAS_FORMAT_FLOAT32)))
+        return EAS_ERROR_PARAMETER_RANGE;
+
+#ifdef _WOW_ENABLED
+    /* WOW borrows the mix buffer */
+    if (pEASData->effectsModules[EAS_MODULE_WOW].effectData)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+#endif
+
+    /* the effects still work on a 16-bit buffer */
+    pEASData->pFormatOutput = pOut;
+    pEASData->pFormatRight = pRight;
+    pEASData->outputFormat = (EAS_U8) format;
+    pEASData->formatMix = (EAS_BOOL8) mix;
+    pEASData->formatMixGain = mixGain;
+    result = EAS_Render(pEASData, fxBuffer, numRequested, pNumGenerated);
+    pEASData->pFormatOutput = NULL;
+    pEASData->pFormatRight = NULL;
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderFormat()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Render a buffer in one of the EAS_FORMAT output formats.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pOut            - output buffer pointer
+ *  format          - EAS_FORMAT output format
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderFormat (EAS_DATA_HANDLE pEASData, void *pOut, EAS_I32 format, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+{
+    if (format == EAS_FORMAT_PCM16)
+        return EAS_Render(pEASData, (EAS_PCM*) pOut, numRequested, pNumGenerated);
+    return EAS_RenderFormatted(pEASData, pOut, NULL, format, EAS_FALSE, 0, numRequested, pNumGenerated);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderMix()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Render a buffer and add it, scaled by gain, to an accumulation buffer.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pMix            - accumulation buffer pointer
+ *  format          - EAS_FORMAT_INT32, EAS_FORMAT_INT32_MIX or EAS_FORMAT_FLOAT32
+ *  gain            - gain, EAS_MIX_UNITY_GAIN is unity
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderMix (EAS_DATA_HANDLE pEASData, void *pMix, EAS_I32 format, EAS_I32 gain, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+{
+    *pNumGenerated = 0;
+    if ((gain < 0) || (gain > EAS_MIX_MAX_GAIN) || (format == EAS_FORMAT_PCM16))
+        return EAS_ERROR_PARAMETER_RANGE;
+    return EAS_RenderFormatted(pEASData, pMix, NULL, format, EAS_TRUE, gain, numRequested, pNumGenerated);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderPlanar()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Render a buffer to separate left and right channel buffers.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pLeft           - left channel output buffer pointer
+ *  pRight          - right channel output buffer pointer
+ *  format          - EAS_FORMAT output format
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderPlanar (EAS_DATA_HANDLE pEASData, void *pLeft, void *pRight, EAS_I32 format, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+{
+#if (NUM_OUTPUT_CHANNELS == 2)
+    if ((pLeft == NULL) || (pRight == NULL))
+        return EAS_ERROR_INVALID_PARAMETER;
+    return EAS_RenderFormatted(pEASData, pLeft, pRight, format, EAS_FALSE, 0, numRequested, pNumGenerated);
+#else
+    *pNumGenerated = 0;
+    return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_SetStemBuses()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Enables or disables stem rendering.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  numBuses        - number of stem buses, 0 to disable
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetStemBuses (EAS_DATA_HANDLE pEASData, EAS_I32 numBuses)
+{
+    if ((numBuses < 0) || (numBuses > EAS_MAX_STEM_BUSES))
+        return EAS_ERROR_PARAMETER_RANGE;
+    if (pEASData->staticMemoryModel)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+    return VMSetStemBuses(pEASData, (EAS_INT) numBuses);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_SetChannelBus()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Routes a MIDI channel of a stream to a stem bus.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  pStream         - handle to a MIDI stream or file
+ *  channel         - MIDI channel
+ *  bus             - stem bus
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetChannelBus (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, EAS_I32 channel, EAS_I32 bus)
+{
+    S_SYNTH *pSynth;
+    EAS_INTPTR synthHandle;
+
+    if ((channel < 0) || (channel >= NUM_SYNTH_CHANNELS) || (bus < 0) || (bus > EAS_STEM_BUS_NONE))
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    if (!EAS_StreamReady(pEASData, pStream))
+        return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
+
+    if (EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_SYNTH_HANDLE, &synthHandle) != EAS_SUCCESS)
+        return EAS_ERROR_INVALID_PARAMETER;
+    pSynth = (S_SYNTH*) synthHandle;
+
+    if (pSynth == NULL)
+        return EAS_ERROR_INVALID_PARAMETER;
+
+    VMSetChannelBus(pSynth, (EAS_INT) channel, (EAS_INT) bus);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderStems()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Render a buffer of the mix and of each stem bus.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pOut            - output buffer pointer for the mix
+ *  ppStems         - output buffer pointers for the stem buses
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderStems (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_PCM * const *ppStems, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+{
+    EAS_RESULT result;
+
+    *pNumGenerated = 0;
+    if (pEASData->pVoiceMgr->numStemBuses == 0)
+        return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
 
-#ifdef _METRICS_ENABLED
-    /* start the post timer */
-    if (pEASData->pMetricsData)
-        (*pEASData->pMetricsModule->pfStartTimer)(pEASData->pMetricsData, EAS_PM_POST_TIME);
-#endif
+    pEASData->ppStemOutput = ppStems;
+    result = EAS_Render(pEASData, pOut, numRequested, pNumGenerated);
+    pEASData->ppStemOutput = NULL;
+    return result;
+}
 
-    /* for split architecture, send DSP vectors.  Do post only if return is TRUE */
-#ifdef _SPLIT_ARCHITECTURE
-    if (VMEndFrame(pEASData))
+/*----------------------------------------------------------------------------
+ * EAS_SetOutputSampleRate()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sets the sample rate EAS_Render writes.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  sampleRate      - output sample rate in Hz
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetOutputSampleRate (EAS_DATA_HANDLE pEASData, EAS_I32 sampleRate)
+{
+    /* the compiled sample rate needs no resampler */
+    if (sampleRate == _OUTPUT_SAMPLE_RATE)
     {
-        /* now do post-processing */
-        EAS_MixEnginePost(pEASData, numRequested);
-        *pNumGenerated = numRequested;
+        if (pEASData->pResampler)
+            EAS_HWFree(pEASData->hwInstData, pEASData->pResampler);
+        pEASData->pResampler = NULL;
+        return EAS_SUCCESS;
     }
-#else
-    /* now do post-processing */
-    EAS_MixEnginePost(pEASData, numRequested);
-    *pNumGenerated = numRequested;
-#endif
-
-#ifdef _METRICS_ENABLED
-    /* stop the post timer */
-    if (pEASData->pMetricsData)
-        (void)(*pEASData->pMetricsModule->pfStopTimer)(pEASData->pMetricsData, EAS_PM_POST_TIME);
-#endif
-
-    /* advance render time */
-    pEASData->renderTime += AUDIO_FRAME_LENGTH;
 
-#if 0
-    /* dump workload for debug */
-    if (pEASData->pVoiceMgr->workload)
-        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "Workload = %d\n", pEASData->pVoiceMgr->workload); */ }
-#endif
+    if ((sampleRate < _OUTPUT_SAMPLE_RATE) || (sampleRate > EAS_MAX_OUTPUT_SAMPLE_RATE))
+        return EAS_ERROR_PARAMETER_RANGE;
+    if (pEASData->staticMemoryModel)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
 
-#ifdef _METRICS_ENABLED
-    /* stop performance counter */
-    if (pEASData->pMetricsData)
+    if (pEASData->pResampler == NULL)
     {
-        PERF_TIMER temp;
-        temp = (*pEASData->pMetricsModule->pfStopTimer)(pEASData->pMetricsData, EAS_PM_TOTAL_TIME);
-
-        /* if max render time, record the number of voices and time */
-        if ((*pEASData->pMetricsModule->pfRecordMaxValue)
-            (pEASData->pMetricsData, EAS_PM_MAX_CYCLES, (EAS_U32) temp))
-        {
-            (*pEASData->pMetricsModule->pfRecordValue)(pEASData->pMetricsData, EAS_PM_MAX_CYCLES_VOICES, (EAS_U32) voicesRendered);
-            (*pEASData->pMetricsModule->pfRecordValue)(pEASData->pMetricsData, EAS_PM_MAX_CYCLES_TIME, (EAS_I32) (pEASData->renderTime >> 8));
-        }
+        if ((pEASData->pResampler = EAS_HWMalloc(pEASData->hwInstData, sizeof(S_RESAMPLER))) == NULL)
+            return EAS_ERROR_MALLOC_FAILED;
+        EAS_HWMemSet(pEASData->pResampler, 0, sizeof(S_RESAMPLER));
     }
-#endif
+    EAS_ResamplerInit(pEASData->pResampler, _OUTPUT_SAMPLE_RATE, sampleRate);
+    return EAS_SUCCESS;
+}
 
-#ifdef JET_INTERFACE
-    /* let JET to do its thing */
-    if (pEASData->jetHandle != NULL)
-    {
-        result = JET_Process(pEASData);
-        if (result != EAS_SUCCESS)
-            return result;
-    }
-#endif
+/*----------------------------------------------------------------------------
+ * EAS_GetOutputSampleRate()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the sample rate EAS_Render writes.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_I32 EAS_GetOutputSampleRate (EAS_DATA_HANDLE pEASData)
+{
+    if (pEASData->pResampler)
+        return pEASData->pResampler->outputRate;
+    return _OUTPUT_SAMPLE_RATE;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_SetOfflineMode()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Enables or disables the offline render mode.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  offline         - EAS_TRUE to trim the silence around a file
+ *  tailLevel       - level in dB below full scale at which tails end
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetOfflineMode (EAS_DATA_HANDLE pEASData, EAS_BOOL offline, EAS_I32 tailLevel)
+{
+    if ((tailLevel < EAS_OFFLINE_TAIL_LEVEL_MIN) || (tailLevel > EAS_OFFLINE_TAIL_LEVEL_MAX))
+        return EAS_ERROR_PARAMETER_RANGE;
 
+    pEASData->offlineMode = (EAS_BOOL8) offline;
+    pEASData->offlineTailGain = EAS_VolumeToGain(EAS_MAX_VOLUME - tailLevel);
+    pEASData->offlinePeak = 0;
+    if (!offline)
+        pEASData->offlineLeading = EAS_FALSE;
     return EAS_SUCCESS;
 }
 
@@ -1247,7 +2509,7 @@ static EAS_RESULT EAS_ParseEvents (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS
 {
     S_FILE_PARSER_INTERFACE *pParserModule;
     EAS_RESULT result;
-    EAS_I32 parserState;
+    EAS_STATE parserState;
     EAS_BOOL done;
     EAS_INT yieldCount = YIELD_EVENT_COUNT;
     EAS_U32 time = 0;
@@ -1456,7 +2718,7 @@ EAS_PUBLIC EAS_RESULT EAS_RegisterMetaDataCallback (
     metadata.buffer = metaDataBuffer;
     metadata.bufferSize = metaDataBufSize;
     metadata.pUserData = pUserData;
-    return EAS_SetStreamParameter(pEASData, pStream, PARSER_DATA_METADATA_CB, (EAS_I32) &metadata);
+    return EAS_SetStreamParameter(pEASData, pStream, PARSER_DATA_METADATA_CB, (EAS_INTPTR) &metadata);
 }
 
 /*----------------------------------------------------------------------------
@@ -1564,7 +2826,7 @@ EAS_PUBLIC EAS_RESULT EAS_OpenMIDIStream (EAS_DATA_HANDLE pEASData, EAS_HANDLE *
     /* use an existing synthesizer */
     else
     {
-        EAS_I32 value;
+        EAS_INTPTR value;
         result = EAS_GetStreamParameter(pEASData, streamHandle, PARSER_DATA_SYNTH_HANDLE, &value);
         pMIDIStream->pSynth = (S_SYNTH*) value;
         VMIncRefCount(pMIDIStream->pSynth);
@@ -1620,6 +2882,37 @@ EAS_PUBLIC EAS_RESULT EAS_WriteMIDIStream (EAS_DATA_HANDLE pEASData, EAS_HANDLE
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_WriteMIDIMessages()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Send complete channel messages to the MIDI stream device
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - stream handle
+ * pMessages        - pointer to packed messages
+ * count            - number of messages to write
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_WriteMIDIMessages (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, const uint32_t *pMessages, EAS_I32 count)
+{
+    S_INTERACTIVE_MIDI *pMIDIStream;
+
+    pMIDIStream = (S_INTERACTIVE_MIDI*) pStream->handle;
+
+    if (count <= 0)
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    return EAS_ParseMIDIMessages(pEASData, pMIDIStream->pSynth, &pMIDIStream->stream, pMessages, count, eParserModePlay);
+}
+
 /*----------------------------------------------------------------------------
  * EAS_CloseMIDIStream()
  *----------------------------------------------------------------------------
@@ -1658,6 +2951,35 @@ EAS_PUBLIC EAS_RESULT EAS_CloseMIDIStream (EAS_DATA_HANDLE pEASData, EAS_HANDLE
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_QueueMIDIStream()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Queue data for the MIDI stream device. The data is delivered to the
+ * stream at the start of the next call to EAS_Render.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - stream handle
+ * pBuffer          - pointer to buffer
+ * count            - number of bytes to write
+ *
+ * Outputs:
+ * EAS_ERROR_QUEUE_IS_FULL if the data does not fit in the queue
+ * EAS_ERROR_PARAMETER_RANGE if the data could never fit in the queue
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_QueueMIDIStream (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, EAS_U8 *pBuffer, EAS_I32 count)
+{
+    if ((pStream == NULL) || (pBuffer == NULL) || (count <= 0))
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    return EAS_QueuePutMIDI(&pEASData->queues, pStream, pStream->generation, pBuffer, count);
+}
+
 /*----------------------------------------------------------------------------
  * EAS_State()
  *----------------------------------------------------------------------------
@@ -1692,6 +3014,10 @@ EAS_PUBLIC EAS_RESULT EAS_State (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, E
     if (pStream->repeatCount && (*pState == EAS_STATE_STOPPED))
         *pState = EAS_STATE_PLAY;
 
+    /* offline, the stream stops once the effect tails are below the tail level as well */
+    if (pEASData->offlineMode && (*pState == EAS_STATE_STOPPED) && (pEASData->offlinePeak > pEASData->offlineTailGain))
+        *pState = EAS_STATE_STOPPING;
+
     /* if we're not paused or pausing, we don't need to hide state from host */
     if (*pState != EAS_STATE_PAUSED && *pState != EAS_STATE_PAUSING)
         return EAS_SUCCESS;
@@ -1888,7 +3214,7 @@ EAS_PUBLIC EAS_RESULT EAS_SetVolume (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStrea
     /* stream volume */
     if (pStream != NULL)
     {
-        EAS_I32 gainOffset;
+        EAS_INTPTR gainOffset;
         EAS_RESULT result;
 
         if (!EAS_StreamReady(pEASData, pStream))
@@ -1898,7 +3224,7 @@ EAS_PUBLIC EAS_RESULT EAS_SetVolume (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStrea
         pStream->volume = (EAS_U8) volume;
         result = EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_GAIN_OFFSET, &gainOffset);
         if (result == EAS_SUCCESS)
-            volume += gainOffset;
+            volume += (EAS_I32) gainOffset;
 
         /* set stream volume */
         gain = EAS_VolumeToGain(volume - STREAM_VOLUME_HEADROOM);
@@ -1975,6 +3301,32 @@ EAS_PUBLIC EAS_RESULT EAS_SetMaxLoad (EAS_DATA_HANDLE pEASData, EAS_I32 maxLoad)
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_SetVoiceCullLevel()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sets the level below which voices are not synthesized.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  cullLevel       - level in dB below full scale, 0 to disable
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetVoiceCullLevel (EAS_DATA_HANDLE pEASData, EAS_I32 cullLevel)
+{
+    if ((cullLevel < EAS_VOICE_CULL_LEVEL_OFF) || (cullLevel > EAS_VOICE_CULL_LEVEL_MAX))
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    if (cullLevel == EAS_VOICE_CULL_LEVEL_OFF)
+        VMSetCullGain(pEASData->pVoiceMgr, 0);
+    else
+        VMSetCullGain(pEASData->pVoiceMgr, EAS_VolumeToGain(EAS_MAX_VOLUME - cullLevel));
+    return EAS_SUCCESS;
+}
+
 /*----------------------------------------------------------------------------
  * EAS_SetMaxPCMStreams()
  *----------------------------------------------------------------------------
@@ -1994,6 +3346,61 @@ EAS_PUBLIC EAS_RESULT EAS_SetMaxPCMStreams (EAS_DATA_HANDLE pEASData, EAS_HANDLE
     return EAS_IntSetStrmParam(pEASData, pStream, PARSER_DATA_MAX_PCM_STREAMS, maxNumStreams);
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_SetPCMPrefetch()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Enables or disables read-ahead of PCM streams by an I/O thread.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * enable           - EAS_TRUE to read ahead
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetPCMPrefetch (EAS_DATA_HANDLE pEASData, EAS_BOOL enable)
+{
+    if (!pEASData)
+        return EAS_ERROR_HANDLE_INTEGRITY;
+    return EAS_PESetPrefetch(pEASData, enable);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_PrefetchPCMStreams()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reads the buffers requested by the PCM streams, called from the I/O thread.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pNumReads        - pointer to variable to receive the number of buffers read
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PrefetchPCMStreams (EAS_DATA_HANDLE pEASData, EAS_I32 *pNumReads)
+{
+    if (!pEASData || !pNumReads)
+        return EAS_ERROR_HANDLE_INTEGRITY;
+    return EAS_PEPrefetch(pEASData, pNumReads);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_GetPCMUnderruns()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the number of PCM stream underruns.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pUnderruns       - pointer to variable to receive the count
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_GetPCMUnderruns (EAS_DATA_HANDLE pEASData, EAS_U32 *pUnderruns)
+{
+    if (!pEASData || !pUnderruns)
+        return EAS_ERROR_HANDLE_INTEGRITY;
+    *pUnderruns = (EAS_U32) EAS_AtomicLoadAcquire(&pEASData->pcmUnderruns);
+    return EAS_SUCCESS;
+}
+
 /*----------------------------------------------------------------------------
  * EAS_Locate()
  *----------------------------------------------------------------------------
@@ -2309,6 +3716,78 @@ EAS_PUBLIC EAS_RESULT EAS_SetParameter (EAS_DATA_HANDLE pEASData, EAS_I32 module
         (pEASData->effectsModules[module].effectData, param, value);
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_QueueParameter()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Queue a parameter change for a module. The change is applied at the
+ * start of the next call to EAS_Render.
+ *
+ * Inputs:
+ * psEASData        - pointer to overall EAS data structure
+ * module           - enumerated module number
+ * param            - enumerated parameter number
+ * value            - new parameter value
+ *
+ * Outputs:
+ * EAS_ERROR_QUEUE_IS_FULL if the parameter queue is full
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_QueueParameter (EAS_DATA_HANDLE pEASData, EAS_I32 module, EAS_I32 param, EAS_I32 value)
+{
+    S_PARAM_QUEUE_EVENT event;
+
+    if ((module < 0) || (module >= NUM_EFFECTS_MODULES))
+        return EAS_ERROR_INVALID_MODULE;
+
+    event.pStream = NULL;
+    event.generation = 0;
+    event.type = PARAM_QUEUE_SET_PARAMETER;
+    event.module = module;
+    event.param = param;
+    event.value = value;
+    return EAS_QueuePutParam(&pEASData->queues, &event);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_QueueVolume()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Queue a master or stream volume change. The change is applied at the
+ * start of the next call to EAS_Render.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - file or stream handle, NULL for master volume
+ * volume           - the desired gain (100 is max)
+ *
+ * Outputs:
+ * EAS_ERROR_QUEUE_IS_FULL if the parameter queue is full
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_QueueVolume (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, EAS_I32 volume)
+{
+    S_PARAM_QUEUE_EVENT event;
+
+    /* check range */
+    if ((volume < 0) || (volume > EAS_MAX_VOLUME))
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    event.pStream = pStream;
+    event.generation = pStream ? pStream->generation : 0;
+    event.type = PARAM_QUEUE_SET_VOLUME;
+    event.module = 0;
+    event.param = 0;
+    event.value = volume;
+    return EAS_QueuePutParam(&pEASData->queues, &event);
+}
+
 #ifdef _METRICS_ENABLED
 /*----------------------------------------------------------------------------
  * EAS_MetricsReport()
@@ -2383,7 +3862,7 @@ EAS_PUBLIC EAS_RESULT EAS_SetSoundLibrary (EAS_DATA_HANDLE pEASData, EAS_HANDLE
     {
         if (!EAS_StreamReady(pEASData, pStream))
             return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
-        return EAS_IntSetStrmParam(pEASData, pStream, PARSER_DATA_EAS_LIBRARY, (EAS_I32) pSndLib);
+        return EAS_IntSetStrmParam(pEASData, pStream, PARSER_DATA_EAS_LIBRARY, (EAS_INTPTR) pSndLib);
     }
 
     return VMSetGlobalEASLib(pEASData->pVoiceMgr, pSndLib);
@@ -2464,8 +3943,11 @@ EAS_PUBLIC EAS_RESULT EAS_LoadDLSCollection (EAS_DATA_HANDLE pEASData, EAS_HANDL
     if ((result = EAS_HWOpenFile(pEASData->hwInstData, locator, &fileHandle, EAS_FILE_READ)) != EAS_SUCCESS)
         return result;
 
-    /* parse the file */
-    result = DLSParser(pEASData->hwInstData, fileHandle, 0, &pDLS);
+    /* parse the file, heap instances share collections through the cache */
+    if (EAS_HWArenaSize(pEASData->hwInstData) == 0)
+        result = DLSCacheLoad(pEASData->hwInstData, fileHandle, &pDLS);
+    else
+        result = DLSParser(pEASData->hwInstData, fileHandle, 0, &pDLS);
     EAS_HWCloseFile(pEASData->hwInstData, fileHandle);
 
     if (result == EAS_SUCCESS)
@@ -2473,7 +3955,7 @@ EAS_PUBLIC EAS_RESULT EAS_LoadDLSCollection (EAS_DATA_HANDLE pEASData, EAS_HANDL
 
         /* if a stream pStream is specified, point it to the DLS collection */
         if (pStream)
-            result = EAS_IntSetStrmParam(pEASData, pStream, PARSER_DATA_DLS_COLLECTION, (EAS_I32) pDLS);
+            result = EAS_IntSetStrmParam(pEASData, pStream, PARSER_DATA_DLS_COLLECTION, (EAS_INTPTR) pDLS);
 
         /* global DLS load */
         else
@@ -2511,12 +3993,14 @@ EAS_PUBLIC EAS_RESULT EAS_RegExtAudioCallback (EAS_DATA_HANDLE pEASData,
     EAS_EXT_EVENT_FUNC cbEventFunc)
 {
     S_SYNTH *pSynth;
+    EAS_INTPTR synthHandle;
 
     if (!EAS_StreamReady(pEASData, pStream))
         return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
 
-    if (EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_SYNTH_HANDLE, (EAS_I32*) &pSynth) != EAS_SUCCESS)
+    if (EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_SYNTH_HANDLE, &synthHandle) != EAS_SUCCESS)
         return EAS_ERROR_INVALID_PARAMETER;
+    pSynth = (S_SYNTH*) synthHandle;
 
     if (pSynth == NULL)
         return EAS_ERROR_INVALID_PARAMETER;
@@ -2546,12 +4030,14 @@ EAS_PUBLIC EAS_RESULT EAS_RegExtAudioCallback (EAS_DATA_HANDLE pEASData,
 EAS_PUBLIC EAS_RESULT EAS_GetMIDIControllers (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, EAS_U8 channel, S_MIDI_CONTROLLERS *pControl)
 {
     S_SYNTH *pSynth;
+    EAS_INTPTR synthHandle;
 
     if (!EAS_StreamReady(pEASData, pStream))
         return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
 
-    if (EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_SYNTH_HANDLE, (EAS_I32*) &pSynth) != EAS_SUCCESS)
+    if (EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_SYNTH_HANDLE, &synthHandle) != EAS_SUCCESS)
         return EAS_ERROR_INVALID_PARAMETER;
+    pSynth = (S_SYNTH*) synthHandle;
 
     if (pSynth == NULL)
         return EAS_ERROR_INVALID_PARAMETER;
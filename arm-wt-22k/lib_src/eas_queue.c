@@ -0,0 +1,128 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_queue.c
+ *
+ * Contents and purpose:
+ * Wait-free single-producer/single-consumer queues used to hand MIDI data
+ * and parameter changes from a control thread to the render thread.
+ *
+ * Copyright (c) 2024 Pedro López-Cabanillas
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include "eas_queue.h"
+#include "eas_host.h"
+
+/*----------------------------------------------------------------------------
+ * EAS_QueuePutMIDI()
+ *----------------------------------------------------------------------------
+ * Called from the producer thread only.
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_QueuePutMIDI (S_EAS_QUEUES *pQueues, EAS_HANDLE pStream, EAS_U32 generation, const EAS_U8 *pBuffer, EAS_I32 count)
+{
+    S_MIDI_QUEUE_EVENT *pEvent;
+    EAS_UINT writeIndex;
+    EAS_UINT readIndex;
+    EAS_UINT numEvents;
+    EAS_I32 numBytes;
+
+    /* more than the whole queue never fits, and would overflow the rounding below */
+    if (count > MIDI_QUEUE_SIZE * MIDI_QUEUE_EVENT_BYTES)
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    /* the consumer can only free space, so this check holds until we publish */
+    numEvents = (EAS_UINT) ((count + MIDI_QUEUE_EVENT_BYTES - 1) / MIDI_QUEUE_EVENT_BYTES);
+    writeIndex = pQueues->midiWriteIndex;
+    readIndex = EAS_AtomicLoadAcquire(&pQueues->midiReadIndex);
+    if (numEvents > MIDI_QUEUE_SIZE - (EAS_UINT) (writeIndex - readIndex))
+        return EAS_ERROR_QUEUE_IS_FULL;
+
+    while (count > 0)
+    {
+        numBytes = count < MIDI_QUEUE_EVENT_BYTES ? count : MIDI_QUEUE_EVENT_BYTES;
+        pEvent = &pQueues->midiEvents[writeIndex & (MIDI_QUEUE_SIZE - 1)];
+        pEvent->pStream = pStream;
+        pEvent->generation = generation;
+        pEvent->count = (EAS_U8) numBytes;
+        EAS_HWMemCpy(pEvent->data, pBuffer, numBytes);
+        pBuffer += numBytes;
+        count -= numBytes;
+        writeIndex++;
+    }
+
+    /* publish all entries at once */
+    EAS_AtomicStoreRelease(&pQueues->midiWriteIndex, writeIndex);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_QueueGetMIDI()
+ *----------------------------------------------------------------------------
+ * Called from the consumer (render) thread only.
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_QueueGetMIDI (S_EAS_QUEUES *pQueues, S_MIDI_QUEUE_EVENT *pEvent)
+{
+    EAS_UINT readIndex;
+
+    readIndex = pQueues->midiReadIndex;
+    if (readIndex == EAS_AtomicLoadAcquire(&pQueues->midiWriteIndex))
+        return EAS_ERROR_QUEUE_IS_EMPTY;
+
+    *pEvent = pQueues->midiEvents[readIndex & (MIDI_QUEUE_SIZE - 1)];
+    EAS_AtomicStoreRelease(&pQueues->midiReadIndex, readIndex + 1);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_QueuePutParam()
+ *----------------------------------------------------------------------------
+ * Called from the producer thread only.
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_QueuePutParam (S_EAS_QUEUES *pQueues, const S_PARAM_QUEUE_EVENT *pEvent)
+{
+    EAS_UINT writeIndex;
+
+    writeIndex = pQueues->paramWriteIndex;
+    if ((EAS_UINT) (writeIndex - EAS_AtomicLoadAcquire(&pQueues->paramReadIndex)) >= PARAM_QUEUE_SIZE)
+        return EAS_ERROR_QUEUE_IS_FULL;
+
+    pQueues->paramEvents[writeIndex & (PARAM_QUEUE_SIZE - 1)] = *pEvent;
+    EAS_AtomicStoreRelease(&pQueues->paramWriteIndex, writeIndex + 1);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_QueueGetParam()
+ *----------------------------------------------------------------------------
+ * Called from the consumer (render) thread only.
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_QueueGetParam (S_EAS_QUEUES *pQueues, S_PARAM_QUEUE_EVENT *pEvent)
+{
+    EAS_UINT readIndex;
+
+    readIndex = pQueues->paramReadIndex;
+    if (readIndex == EAS_AtomicLoadAcquire(&pQueues->paramWriteIndex))
+        return EAS_ERROR_QUEUE_IS_EMPTY;
+
+    *pEvent = pQueues->paramEvents[readIndex & (PARAM_QUEUE_SIZE - 1)];
+    EAS_AtomicStoreRelease(&pQueues->paramReadIndex, readIndex + 1);
+    return EAS_SUCCESS;
+}
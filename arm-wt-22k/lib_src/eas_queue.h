@@ -0,0 +1,170 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_queue.h
+ *
+ * Contents and purpose:
+ * Wait-free single-producer/single-consumer queues used to hand MIDI data
+ * and parameter changes from a control thread to the render thread.
+ *
+ * Copyright (c) 2024 Pedro López-Cabanillas
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#ifndef _EAS_QUEUE_H
+#define _EAS_QUEUE_H
+
+#include "eas_types.h"
+#include "eas.h"
+#include "eas_atomic.h"
+
+/* queue sizes, must be powers of 2 */
+#ifndef MIDI_QUEUE_SIZE
+#define MIDI_QUEUE_SIZE             256
+#endif
+
+#ifndef PARAM_QUEUE_SIZE
+#define PARAM_QUEUE_SIZE            32
+#endif
+
+/* MIDI bytes carried by a single queue entry, longer messages span several entries */
+#define MIDI_QUEUE_EVENT_BYTES      7
+
+/* parameter queue event types */
+#define PARAM_QUEUE_SET_PARAMETER   0
+#define PARAM_QUEUE_SET_VOLUME      1
+
+/*
+ * Queue indices are free-running counters: the producer is the only writer
+ * of writeIndex and the consumer the only writer of readIndex. Each side
+ * publishes its index with release semantics and reads the other side's
+ * index with acquire semantics, so no locks are needed.
+ */
+
+/* MIDI queue entry */
+typedef struct s_midi_queue_event_tag
+{
+    EAS_HANDLE                      pStream;
+    EAS_U32                         generation;
+    EAS_U8                          count;
+    EAS_U8                          data[MIDI_QUEUE_EVENT_BYTES];
+} S_MIDI_QUEUE_EVENT;
+
+/* parameter queue entry */
+typedef struct s_param_queue_event_tag
+{
+    EAS_HANDLE                      pStream;
+    EAS_U32                         generation;
+    EAS_I32                         type;
+    EAS_I32                         module;
+    EAS_I32                         param;
+    EAS_I32                         value;
+} S_PARAM_QUEUE_EVENT;
+
+/* queue pair owned by each EAS instance */
+typedef struct s_eas_queues_tag
+{
+    volatile EAS_UINT               midiWriteIndex;
+    volatile EAS_UINT               midiReadIndex;
+    volatile EAS_UINT               paramWriteIndex;
+    volatile EAS_UINT               paramReadIndex;
+    S_MIDI_QUEUE_EVENT              midiEvents[MIDI_QUEUE_SIZE];
+    S_PARAM_QUEUE_EVENT             paramEvents[PARAM_QUEUE_SIZE];
+} S_EAS_QUEUES;
+
+/*----------------------------------------------------------------------------
+ * EAS_QueuePutMIDI()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Appends a buffer of MIDI data for a stream to the MIDI queue. The data
+ * is split across as many entries as needed; either all of it is queued
+ * or none of it is.
+ *
+ * Inputs:
+ * pQueues          - pointer to the instance queues
+ * pStream          - MIDI stream handle
+ * generation       - generation of the stream when the data was queued
+ * pBuffer          - pointer to MIDI data
+ * count            - number of bytes
+ *
+ * Outputs:
+ * EAS_ERROR_QUEUE_IS_FULL if there is not enough room
+ * EAS_ERROR_PARAMETER_RANGE if the data is larger than the queue
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_QueuePutMIDI (S_EAS_QUEUES *pQueues, EAS_HANDLE pStream, EAS_U32 generation, const EAS_U8 *pBuffer, EAS_I32 count);
+
+/*----------------------------------------------------------------------------
+ * EAS_QueueGetMIDI()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Removes the oldest entry from the MIDI queue.
+ *
+ * Inputs:
+ * pQueues          - pointer to the instance queues
+ * pEvent           - pointer to entry to receive the data
+ *
+ * Outputs:
+ * EAS_ERROR_QUEUE_IS_EMPTY if there is nothing to remove
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_QueueGetMIDI (S_EAS_QUEUES *pQueues, S_MIDI_QUEUE_EVENT *pEvent);
+
+/*----------------------------------------------------------------------------
+ * EAS_QueuePutParam()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Appends a parameter change to the parameter queue.
+ *
+ * Inputs:
+ * pQueues          - pointer to the instance queues
+ * pEvent           - pointer to the parameter change
+ *
+ * Outputs:
+ * EAS_ERROR_QUEUE_IS_FULL if there is no room
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_QueuePutParam (S_EAS_QUEUES *pQueues, const S_PARAM_QUEUE_EVENT *pEvent);
+
+/*----------------------------------------------------------------------------
+ * EAS_QueueGetParam()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Removes the oldest entry from the parameter queue.
+ *
+ * Inputs:
+ * pQueues          - pointer to the instance queues
+ * pEvent           - pointer to entry to receive the data
+ *
+ * Outputs:
+ * EAS_ERROR_QUEUE_IS_EMPTY if there is nothing to remove
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_QueueGetParam (S_EAS_QUEUES *pQueues, S_PARAM_QUEUE_EVENT *pEvent);
+
+#endif /* #ifndef _EAS_QUEUE_H */
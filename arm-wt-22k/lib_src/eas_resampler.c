@@ -0,0 +1,221 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_resampler.c
+ *
+ * Contents and purpose:
+ * Polyphase resampler that converts the output of the synthesizer from the
+ * compiled sample rate to the sample rate of the audio device.
+ *
+ * Copyright (c) 2024 Pedro López-Cabanillas
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include "eas_resampler.h"
+#include "eas_host.h"
+#include "eas_math.h"
+
+/* lint is choking on the ARM math.h file, so we declare the functions here */
+extern double sin(double x);
+extern double cos(double x);
+
+#define RESAMPLER_PI                3.14159265358979323846
+
+/* cutoff of the filter as a fraction of the input Nyquist frequency */
+#define RESAMPLER_CUTOFF            0.9
+
+/* input frames ahead of the first tap, so the first output frame is centered on the first input frame */
+#define RESAMPLER_DELAY             (RESAMPLER_TAPS / 2 - 1)
+
+/*----------------------------------------------------------------------------
+ * EAS_ResamplerInit()
+ *----------------------------------------------------------------------------
+ * Each phase is a Blackman windowed sinc, normalized to unity gain at DC.
+ *----------------------------------------------------------------------------
+*/
+void EAS_ResamplerInit (S_RESAMPLER *pResampler, EAS_I32 inputRate, EAS_I32 outputRate)
+{
+    double taps[RESAMPLER_TAPS];
+    double sum;
+    double x;
+    EAS_INT phase;
+    EAS_INT k;
+
+    pResampler->inputRate = inputRate;
+    pResampler->outputRate = outputRate;
+
+    /* one phase more than RESAMPLER_PHASES, the interpolation reads one past the last */
+    for (phase = 0; phase <= RESAMPLER_PHASES; phase++)
+    {
+        sum = 0;
+        for (k = 0; k < RESAMPLER_TAPS; k++)
+        {
+            x = (double) (k - RESAMPLER_DELAY) - (double) phase / RESAMPLER_PHASES;
+            taps[k] = (x == 0) ? 1.0 : sin(RESAMPLER_PI * RESAMPLER_CUTOFF * x) / (RESAMPLER_PI * RESAMPLER_CUTOFF * x);
+            taps[k] *= 0.42 + 0.5 * cos(2 * RESAMPLER_PI * x / RESAMPLER_TAPS) + 0.08 * cos(4 * RESAMPLER_PI * x / RESAMPLER_TAPS);
+            sum += taps[k];
+        }
+        for (k = 0; k < RESAMPLER_TAPS; k++)
+        {
+            x = taps[k] * 32768.0 / sum;
+            pResampler->coefs[phase][k] = (EAS_I16) ((x < 0) ? x - 0.5 : x + 0.5);
+        }
+    }
+
+    EAS_ResamplerReset(pResampler);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_ResamplerReset()
+ *----------------------------------------------------------------------------
+*/
+void EAS_ResamplerReset (S_RESAMPLER *pResampler)
+{
+    /* start with silence ahead of the first input frame */
+    EAS_HWMemSet(pResampler->buffer, 0, RESAMPLER_DELAY * NUM_OUTPUT_CHANNELS * (EAS_I32) sizeof(EAS_PCM));
+    EAS_HWMemSet(pResampler->floatBuffer, 0, RESAMPLER_DELAY * NUM_OUTPUT_CHANNELS * (EAS_I32) sizeof(float));
+    pResampler->numFrames = RESAMPLER_DELAY;
+    pResampler->readPos = 0;
+    pResampler->phase = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_ResamplerGetBuffer()
+ *----------------------------------------------------------------------------
+*/
+EAS_PCM *EAS_ResamplerGetBuffer (S_RESAMPLER *pResampler, EAS_I32 numSamples, float **ppFloat)
+{
+    long long lastPos;
+    EAS_I32 i;
+
+    /* the last output frame reads RESAMPLER_TAPS frames from its position */
+    lastPos = pResampler->readPos + ((long long) pResampler->phase + (long long) (numSamples - 1) * pResampler->inputRate) / pResampler->outputRate;
+    if (lastPos + RESAMPLER_TAPS <= pResampler->numFrames)
+        return NULL;
+
+    /* move the frames still needed to the start of the buffer, they may overlap */
+    if (pResampler->numFrames + BUFFER_SIZE_IN_MONO_SAMPLES > RESAMPLER_BUFFER_FRAMES)
+    {
+        pResampler->numFrames -= pResampler->readPos;
+        for (i = 0; i < pResampler->numFrames * NUM_OUTPUT_CHANNELS; i++)
+        {
+            pResampler->buffer[i] = pResampler->buffer[i + pResampler->readPos * NUM_OUTPUT_CHANNELS];
+            pResampler->floatBuffer[i] = pResampler->floatBuffer[i + pResampler->readPos * NUM_OUTPUT_CHANNELS];
+        }
+        pResampler->readPos = 0;
+    }
+    *ppFloat = pResampler->floatBuffer + pResampler->numFrames * NUM_OUTPUT_CHANNELS;
+    return pResampler->buffer + pResampler->numFrames * NUM_OUTPUT_CHANNELS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_ResamplerAddFrames()
+ *----------------------------------------------------------------------------
+*/
+void EAS_ResamplerAddFrames (S_RESAMPLER *pResampler, EAS_I32 numFrames, EAS_BOOL haveFloat)
+{
+    EAS_I32 i;
+
+    if (!haveFloat)
+    {
+        for (i = pResampler->numFrames * NUM_OUTPUT_CHANNELS; i < (pResampler->numFrames + numFrames) * NUM_OUTPUT_CHANNELS; i++)
+            pResampler->floatBuffer[i] = (float) pResampler->buffer[i] * (1.0f / 32768.0f);
+    }
+    pResampler->numFrames += numFrames;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_ResamplerProcess()
+ *----------------------------------------------------------------------------
+ * The coefficients of each output frame are interpolated between the two
+ * nearest phases, then shared by the channels and by the float output.
+ *----------------------------------------------------------------------------
+*/
+EAS_BOOL EAS_ResamplerProcess (S_RESAMPLER *pResampler, EAS_PCM *pOut, float *pFloatOut, EAS_I32 numSamples)
+{
+    EAS_I32 coefs[RESAMPLER_TAPS];
+    float floatCoefs[RESAMPLER_TAPS];
+    const EAS_I16 *pCoefs;
+    const EAS_I16 *pNext;
+    const EAS_PCM *pIn;
+    const float *pFloatIn;
+    float floatAcc;
+    long long pos;
+    EAS_I32 phase;
+    EAS_I32 frac;
+    EAS_I32 acc;
+    EAS_I32 nonZero;
+    EAS_INT ch;
+    EAS_INT k;
+
+    nonZero = 0;
+    while (numSamples--)
+    {
+        /* phase index and the 1.15 fraction to the next phase */
+        pos = (long long) pResampler->phase * RESAMPLER_PHASES;
+        phase = (EAS_I32) (pos / pResampler->outputRate);
+        frac = (EAS_I32) (((pos % pResampler->outputRate) << 15) / pResampler->outputRate);
+        pCoefs = pResampler->coefs[phase];
+        pNext = pResampler->coefs[phase + 1];
+        for (k = 0; k < RESAMPLER_TAPS; k++)
+            /*lint -e{704} <avoid divide for performance>*/
+            coefs[k] = pCoefs[k] + (((pNext[k] - pCoefs[k]) * frac) >> 15);
+
+        for (ch = 0; ch < NUM_OUTPUT_CHANNELS; ch++)
+        {
+            pIn = pResampler->buffer + pResampler->readPos * NUM_OUTPUT_CHANNELS + ch;
+            acc = 0;
+            for (k = 0; k < RESAMPLER_TAPS; k++)
+            {
+                acc += coefs[k] * *pIn;
+                pIn += NUM_OUTPUT_CHANNELS;
+            }
+            /*lint -e{704} <avoid divide for performance>*/
+            acc = SATURATE((acc + 0x4000) >> 15);
+            nonZero |= acc;
+            *pOut++ = (EAS_PCM) acc;
+        }
+
+        /* the float output is not clipped */
+        if (pFloatOut)
+        {
+            for (k = 0; k < RESAMPLER_TAPS; k++)
+                floatCoefs[k] = (float) coefs[k] * (1.0f / 32768.0f);
+            for (ch = 0; ch < NUM_OUTPUT_CHANNELS; ch++)
+            {
+                pFloatIn = pResampler->floatBuffer + pResampler->readPos * NUM_OUTPUT_CHANNELS + ch;
+                floatAcc = 0;
+                for (k = 0; k < RESAMPLER_TAPS; k++)
+                {
+                    floatAcc += floatCoefs[k] * *pFloatIn;
+                    pFloatIn += NUM_OUTPUT_CHANNELS;
+                }
+                if (floatAcc != 0)
+                    nonZero = 1;
+                *pFloatOut++ = floatAcc;
+            }
+        }
+
+        /* step the position by inputRate / outputRate frames */
+        pResampler->phase += pResampler->inputRate;
+        while (pResampler->phase >= pResampler->outputRate)
+        {
+            pResampler->phase -= pResampler->outputRate;
+            pResampler->readPos++;
+        }
+    }
+    return (nonZero == 0);
+}
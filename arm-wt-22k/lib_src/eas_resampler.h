@@ -0,0 +1,168 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_resampler.h
+ *
+ * Contents and purpose:
+ * Polyphase resampler that converts the output of the synthesizer from the
+ * compiled sample rate to the sample rate of the audio device.
+ *
+ * Copyright (c) 2024 Pedro López-Cabanillas
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#ifndef _EAS_RESAMPLER_H
+#define _EAS_RESAMPLER_H
+
+#include "eas_types.h"
+#include "eas_audioconst.h"
+#include "eas_synth.h"
+
+/* filter taps per output sample, must be even */
+#define RESAMPLER_TAPS              16
+
+/* filter phases per input sample, the coefficients are interpolated in between */
+#define RESAMPLER_PHASES            64
+
+/* input frames buffered, enough for the filter and two rendered buffers */
+#define RESAMPLER_BUFFER_FRAMES     (2 * (BUFFER_SIZE_IN_MONO_SAMPLES + RESAMPLER_TAPS))
+
+/*
+ * The position of the next output sample is readPos plus phase / outputRate
+ * input frames. Stepping it by inputRate / outputRate as a whole number of
+ * frames and a remainder keeps the ratio exact, so the output does not drift.
+ */
+
+/*
+ * The input is kept twice, as 16-bit frames for EAS_Render and as float
+ * frames, full scale 1.0, for the 32-bit formats. Input rendered in one of
+ * them only is converted to the other, so the two stay in step.
+ */
+
+/* resampler state, allocated by EAS_ResamplerInit */
+typedef struct s_resampler_tag
+{
+    EAS_I16                         coefs[RESAMPLER_PHASES + 1][RESAMPLER_TAPS];
+    EAS_PCM                         buffer[RESAMPLER_BUFFER_FRAMES * NUM_OUTPUT_CHANNELS];
+    float                           floatBuffer[RESAMPLER_BUFFER_FRAMES * NUM_OUTPUT_CHANNELS];
+    EAS_I32                         inputRate;
+    EAS_I32                         outputRate;
+    EAS_I32                         readPos;
+    EAS_I32                         numFrames;
+    EAS_I32                         phase;
+} S_RESAMPLER;
+
+/*----------------------------------------------------------------------------
+ * EAS_ResamplerInit()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Computes the filter for a conversion from inputRate to outputRate and
+ * resets the resampler.
+ *
+ * Inputs:
+ * pResampler       - pointer to the resampler state
+ * inputRate        - sample rate of the synthesizer
+ * outputRate       - sample rate of the output, at least inputRate
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_ResamplerInit (S_RESAMPLER *pResampler, EAS_I32 inputRate, EAS_I32 outputRate);
+
+/*----------------------------------------------------------------------------
+ * EAS_ResamplerReset()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Discards the buffered input.
+ *
+ * Inputs:
+ * pResampler       - pointer to the resampler state
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_ResamplerReset (S_RESAMPLER *pResampler);
+
+/*----------------------------------------------------------------------------
+ * EAS_ResamplerGetBuffer()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns where the next BUFFER_SIZE_IN_MONO_SAMPLES input frames are to
+ * be rendered, or NULL if the buffered input is enough for numSamples
+ * output frames.
+ *
+ * Inputs:
+ * pResampler       - pointer to the resampler state
+ * numSamples       - number of output frames wanted
+ *
+ * Outputs:
+ * ppFloat          - receives where the same frames go as float
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PCM *EAS_ResamplerGetBuffer (S_RESAMPLER *pResampler, EAS_I32 numSamples, float **ppFloat);
+
+/*----------------------------------------------------------------------------
+ * EAS_ResamplerAddFrames()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Adds the frames rendered to the buffers from EAS_ResamplerGetBuffer to
+ * the input. Frames rendered in 16-bit only are converted to float.
+ *
+ * Inputs:
+ * pResampler       - pointer to the resampler state
+ * numFrames        - number of frames rendered
+ * haveFloat        - EAS_TRUE if the float frames were rendered too
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_ResamplerAddFrames (S_RESAMPLER *pResampler, EAS_I32 numFrames, EAS_BOOL haveFloat);
+
+/*----------------------------------------------------------------------------
+ * EAS_ResamplerProcess()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Writes numSamples output frames. EAS_ResamplerGetBuffer must have
+ * returned NULL for numSamples.
+ *
+ * Inputs:
+ * pResampler       - pointer to the resampler state
+ * pOut             - output buffer pointer
+ * pFloatOut        - float output buffer pointer, or NULL
+ * numSamples       - number of output frames
+ *
+ * Outputs:
+ * Returns EAS_TRUE if every output sample is zero
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_BOOL EAS_ResamplerProcess (S_RESAMPLER *pResampler, EAS_PCM *pOut, float *pFloatOut, EAS_I32 numSamples);
+
+#endif /* #ifndef _EAS_RESAMPLER_H */
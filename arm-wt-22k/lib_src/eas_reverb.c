@@ -48,6 +48,13 @@ static void ReverbProcess (EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst,
 static EAS_RESULT ReverbShutdown (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pInstData);
 static EAS_RESULT ReverbGetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue);
 static EAS_RESULT ReverbSetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value);
+static void ReverbReset (EAS_VOID_PTR pInstData);
+static EAS_RESULT ReverbClone (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pSrcData, EAS_VOID_PTR *pInstData);
+static EAS_BOOL ReverbIsSilent (EAS_VOID_PTR pInstData);
+
+#ifdef _STATIC_MEMORY
+extern EAS_PCM eas_ReverbDelayLine[];
+#endif
 
 /* common effects interface for configuration module */
 const S_EFFECTS_INTERFACE EAS_Reverb =
@@ -56,7 +63,12 @@ const S_EFFECTS_INTERFACE EAS_Reverb =
     ReverbProcess,
     ReverbShutdown,
     ReverbGetParam,
-    ReverbSetParam
+    ReverbSetParam,
+    ReverbReset,
+    ReverbClone,
+    ReverbIsSilent,
+    sizeof(S_REVERB_OBJECT),
+    REVERB_BUFFER_SIZE_IN_SAMPLES * sizeof(EAS_PCM)
 };
 
 
@@ -74,12 +86,7 @@ const S_EFFECTS_INTERFACE EAS_Reverb =
 */
 static EAS_RESULT ReverbInit(EAS_DATA_HANDLE pEASData, EAS_VOID_PTR *pInstData)
 {
-    EAS_I32 i;
-    EAS_U16 nOffset;
-    EAS_INT temp;
-
     S_REVERB_OBJECT *pReverbData;
-    S_REVERB_PRESET *pPreset;
 
     /* check Configuration Module for data allocation */
     if (pEASData->staticMemoryModel)
@@ -95,8 +102,64 @@ static EAS_RESULT ReverbInit(EAS_DATA_HANDLE pEASData, EAS_VOID_PTR *pInstData)
         return EAS_ERROR_MALLOC_FAILED;
     }
 
-    /* clear the structure */
+    /* the delay line is allocated when the reverb is first enabled */
+    pReverbData->m_pDelayLine = NULL;
+    pReverbData->m_hwInstData = pEASData->hwInstData;
+    pReverbData->m_bStaticDelayLine = EAS_FALSE;
+#ifdef _STATIC_MEMORY
+    if (pEASData->staticMemoryModel)
+    {
+        pReverbData->m_pDelayLine = eas_ReverbDelayLine;
+        pReverbData->m_bStaticDelayLine = EAS_TRUE;
+    }
+#endif
+
+    ReverbReset(pReverbData);
+
+    *pInstData = pReverbData;
+
+    return EAS_SUCCESS;
+
+}   /* end InitializeReverb */
+
+/*----------------------------------------------------------------------------
+ * ReverbReset()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restore the default preset and clear the delay lines
+ *
+ * Inputs:
+ * pInstData - reverb instance data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbReset (EAS_VOID_PTR pInstData)
+{
+    EAS_I32 i;
+    EAS_U16 nOffset;
+    EAS_PCM *pDelayLine;
+    EAS_HW_DATA_HANDLE hwInstData;
+    EAS_BOOL bStaticDelayLine;
+
+    S_REVERB_OBJECT *pReverbData;
+
+    pReverbData = (S_REVERB_OBJECT*) pInstData;
+
+    /* clear the structure, the delay line is kept */
+    pDelayLine = pReverbData->m_pDelayLine;
+    hwInstData = pReverbData->m_hwInstData;
+    bStaticDelayLine = pReverbData->m_bStaticDelayLine;
     EAS_HWMemSet(pReverbData, 0, sizeof(S_REVERB_OBJECT));
+    pReverbData->m_pDelayLine = pDelayLine;
+    pReverbData->m_hwInstData = hwInstData;
+    pReverbData->m_bStaticDelayLine = bStaticDelayLine;
+    pReverbData->m_nIdleTime = EAS_REVERB_IDLE_TIME_DEFAULT;
+    pReverbData->m_bQuiet = EAS_TRUE;
+    pReverbData->m_nQuietSamples = 0;
+    pReverbData->m_nQuietEnergy = 0;
+    pReverbData->m_nLastQuietEnergy = -1;
 
     ReverbReadInPresets(pReverbData);
 
@@ -196,18 +259,246 @@ static EAS_RESULT ReverbInit(EAS_DATA_HANDLE pEASData, EAS_VOID_PTR *pInstData)
     }
 
     // clear the reverb delay line
-    for (i=0; i < REVERB_BUFFER_SIZE_IN_SAMPLES; i++)
+    if (pReverbData->m_pDelayLine != NULL)
     {
-        pReverbData->m_nDelayLine[i] = 0;
+        for (i=0; i < REVERB_BUFFER_SIZE_IN_SAMPLES; i++)
+        {
+            pReverbData->m_pDelayLine[i] = 0;
+        }
     }
 
     ReverbUpdateRoom(pReverbData);
 
-    *pInstData = pReverbData;
+}   /* end ReverbReset */
 
+/*----------------------------------------------------------------------------
+ * ReverbAllocDelayLine()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Allocate and clear the delay line if the reverb does not have one
+ *
+ * Inputs:
+ * pReverbData - reverb instance data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT ReverbAllocDelayLine (S_REVERB_OBJECT *pReverbData)
+{
+    if (pReverbData->m_pDelayLine != NULL)
+        return EAS_SUCCESS;
+
+    pReverbData->m_pDelayLine = EAS_HWMalloc(pReverbData->m_hwInstData, REVERB_BUFFER_SIZE_IN_SAMPLES * (EAS_I32) sizeof(EAS_PCM));
+    if (pReverbData->m_pDelayLine == NULL)
+    {
+        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_FATAL, "Failed to allocate Reverb delay line\n"); */ }
+        return EAS_ERROR_MALLOC_FAILED;
+    }
+    EAS_HWMemSet(pReverbData->m_pDelayLine, 0, REVERB_BUFFER_SIZE_IN_SAMPLES * (EAS_I32) sizeof(EAS_PCM));
     return EAS_SUCCESS;
+}   /* end ReverbAllocDelayLine */
 
-}   /* end InitializeReverb */
+/*----------------------------------------------------------------------------
+ * ReverbIdle()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Count the samples processed while bypassed and free the delay line once
+ * the idle time has elapsed. The filter states go with it, so a reverb that
+ * is enabled again starts from silence.
+ *
+ * Inputs:
+ * pReverbData - reverb instance data
+ * numSamples - number of samples processed
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbIdle (S_REVERB_OBJECT *pReverbData, EAS_I32 numSamples)
+{
+    EAS_I32 idleSamples;
+
+    if ((pReverbData->m_pDelayLine == NULL) || pReverbData->m_bStaticDelayLine || (pReverbData->m_nIdleTime == 0))
+        return;
+
+    /* split the conversion so long idle times cannot overflow */
+    pReverbData->m_nIdleSamples += numSamples;
+    idleSamples = (pReverbData->m_nIdleTime / 1000) * _OUTPUT_SAMPLE_RATE +
+        ((pReverbData->m_nIdleTime % 1000) * _OUTPUT_SAMPLE_RATE) / 1000;
+    if (pReverbData->m_nIdleSamples < idleSamples)
+        return;
+
+    EAS_HWFree(pReverbData->m_hwInstData, pReverbData->m_pDelayLine);
+    pReverbData->m_pDelayLine = NULL;
+    pReverbData->m_nIdleSamples = 0;
+    pReverbData->m_nRevOutFbkR = 0;
+    pReverbData->m_nRevOutFbkL = 0;
+    pReverbData->m_zLpf0 = 0;
+    pReverbData->m_zLpf1 = 0;
+    pReverbData->m_sEarlyL.m_zLpf = 0;
+    pReverbData->m_sEarlyR.m_zLpf = 0;
+    pReverbData->m_bQuiet = EAS_TRUE;
+    pReverbData->m_nQuietSamples = 0;
+    pReverbData->m_nQuietEnergy = 0;
+    pReverbData->m_nLastQuietEnergy = -1;
+}   /* end ReverbIdle */
+
+/*----------------------------------------------------------------------------
+ * ReverbBufferSilent()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns EAS_TRUE if a buffer holds only zeros
+ *
+ * Inputs:
+ * pBuffer - buffer to check
+ * numSamples - number of samples in the buffer
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL ReverbBufferSilent (const EAS_PCM *pBuffer, EAS_I32 numSamples)
+{
+    while (numSamples--)
+        if (*pBuffer++ != 0)
+            return EAS_FALSE;
+    return EAS_TRUE;
+}   /* end ReverbBufferSilent */
+
+/*----------------------------------------------------------------------------
+ * ReverbStateSilent()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns EAS_TRUE once the tail has decayed below one LSB, that is when
+ * the delay line and all filter states are zero. Silent input then leaves
+ * them at zero and produces no output.
+ *
+ * Inputs:
+ * pReverbData - reverb instance data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL ReverbStateSilent (S_REVERB_OBJECT *pReverbData)
+{
+    if (pReverbData->m_nRevOutFbkR || pReverbData->m_nRevOutFbkL ||
+        pReverbData->m_zLpf0 || pReverbData->m_zLpf1 ||
+        pReverbData->m_sEarlyL.m_zLpf || pReverbData->m_sEarlyR.m_zLpf)
+        return EAS_FALSE;
+    return ReverbBufferSilent(pReverbData->m_pDelayLine, REVERB_BUFFER_SIZE_IN_SAMPLES);
+}   /* end ReverbStateSilent */
+
+/*----------------------------------------------------------------------------
+ * ReverbTailQuiet()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Follows the tail after the input has gone silent and clears the delay
+ * line and filter states once it has settled into its limit cycle. The
+ * tail has settled when the output stays within the noise floor and a
+ * window of REVERB_QUIET_SAMPLES holds no less energy than the one before.
+ *
+ * Inputs:
+ * pReverbData - reverb instance data
+ * pOutput - output of the last Reverb() call
+ * numSamples - number of samples in the output
+ *
+ * Outputs:
+ * returns EAS_TRUE if the tail is now silent
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL ReverbTailQuiet (S_REVERB_OBJECT *pReverbData, const EAS_PCM *pOutput, EAS_I32 numSamples)
+{
+    EAS_I32 energy;
+    EAS_BOOL settled;
+    EAS_I32 i;
+
+    if (ReverbStateSilent(pReverbData))
+        return EAS_TRUE;
+
+    energy = 0;
+    for (i = 0; i < numSamples * NUM_OUTPUT_CHANNELS; i++)
+    {
+        if ((pOutput[i] > REVERB_NOISE_FLOOR) || (pOutput[i] < -REVERB_NOISE_FLOOR))
+        {
+            pReverbData->m_nQuietSamples = 0;
+            pReverbData->m_nQuietEnergy = 0;
+            pReverbData->m_nLastQuietEnergy = -1;
+            return EAS_FALSE;
+        }
+        energy += pOutput[i] * pOutput[i];
+    }
+
+    pReverbData->m_nQuietSamples += numSamples;
+    pReverbData->m_nQuietEnergy += energy;
+    if (pReverbData->m_nQuietSamples < REVERB_QUIET_SAMPLES)
+        return EAS_FALSE;
+
+    /* a tail that is still decaying loses energy from one window to the next */
+    settled = (pReverbData->m_nLastQuietEnergy >= 0) && (pReverbData->m_nQuietEnergy >= pReverbData->m_nLastQuietEnergy);
+    pReverbData->m_nLastQuietEnergy = pReverbData->m_nQuietEnergy;
+    pReverbData->m_nQuietEnergy = 0;
+    pReverbData->m_nQuietSamples = 0;
+    if (!settled)
+        return EAS_FALSE;
+
+    pReverbData->m_nLastQuietEnergy = -1;
+    EAS_HWMemSet(pReverbData->m_pDelayLine, 0, REVERB_BUFFER_SIZE_IN_SAMPLES * (EAS_I32) sizeof(EAS_PCM));
+    pReverbData->m_nRevOutFbkR = 0;
+    pReverbData->m_nRevOutFbkL = 0;
+    pReverbData->m_zLpf0 = 0;
+    pReverbData->m_zLpf1 = 0;
+    pReverbData->m_sEarlyL.m_zLpf = 0;
+    pReverbData->m_sEarlyR.m_zLpf = 0;
+    return EAS_TRUE;
+}   /* end ReverbTailQuiet */
+
+/*----------------------------------------------------------------------------
+ * ReverbSkip()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Stands in for Reverb() while the state and the input are silent. Only
+ * the signal-independent state advances, exactly as Reverb() would
+ * advance it, so the output is unchanged when the signal returns.
+ *
+ * Inputs:
+ * pReverbData - reverb instance data
+ * numSamples - number of samples to skip
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbSkip (S_REVERB_OBJECT *pReverbData, EAS_I32 numSamples)
+{
+    pReverbData->m_nBaseIndex = (EAS_U16) (pReverbData->m_nBaseIndex - numSamples);
+    pReverbData->m_nSin = (EAS_I16) (pReverbData->m_nSin + pReverbData->m_nSinIncrement * numSamples);
+    pReverbData->m_nCos = (EAS_I16) (pReverbData->m_nCos + pReverbData->m_nCosIncrement * numSamples);
+}   /* end ReverbSkip */
+
+/*----------------------------------------------------------------------------
+ * ReverbIsSilent()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns EAS_TRUE if silent input to the next ReverbProcess() call
+ * produces silent output
+ *
+ * Inputs:
+ * pInstData - reverb instance data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL ReverbIsSilent (EAS_VOID_PTR pInstData)
+{
+    S_REVERB_OBJECT *pReverbData;
+
+    pReverbData = (S_REVERB_OBJECT*) pInstData;
+    return pReverbData->m_bBypass || (pReverbData->m_nWet == 0 && pReverbData->m_nDry == 32767) || pReverbData->m_bQuiet;
+}   /* end ReverbIsSilent */
 
 
 
@@ -240,8 +531,10 @@ static void ReverbProcess(EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst,
     if (pReverbData->m_bBypass ||
         (pReverbData->m_nWet == 0 && pReverbData->m_nDry == 32767))
     {
+        if (pReverbData->m_bBypass)
+            ReverbIdle(pReverbData, numSamples);
         if (pSrc != pDst)
-            EAS_HWMemCpy(pSrc, pDst, numSamples * NUM_OUTPUT_CHANNELS * (EAS_I32) sizeof(EAS_PCM));
+            EAS_HWMemCpy(pDst, pSrc, numSamples * NUM_OUTPUT_CHANNELS * (EAS_I32) sizeof(EAS_PCM));
         return;
     }
 
@@ -252,7 +545,29 @@ static void ReverbProcess(EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst,
 
     ReverbUpdateXfade(pReverbData, numSamples);
 
-    Reverb(pReverbData, numSamples, pDst, pSrc);
+    /* once the tail has decayed, silence passes through untouched */
+    if (ReverbBufferSilent(pSrc, numSamples * NUM_OUTPUT_CHANNELS))
+    {
+        if (pReverbData->m_bQuiet)
+        {
+            ReverbSkip(pReverbData, numSamples);
+            if (pSrc != pDst)
+                EAS_HWMemCpy(pDst, pSrc, numSamples * NUM_OUTPUT_CHANNELS * (EAS_I32) sizeof(EAS_PCM));
+        }
+        else
+        {
+            Reverb(pReverbData, numSamples, pDst, pSrc);
+            pReverbData->m_bQuiet = ReverbTailQuiet(pReverbData, pDst, numSamples);
+        }
+    }
+    else
+    {
+        pReverbData->m_bQuiet = EAS_FALSE;
+        pReverbData->m_nQuietSamples = 0;
+        pReverbData->m_nQuietEnergy = 0;
+        pReverbData->m_nLastQuietEnergy = -1;
+        Reverb(pReverbData, numSamples, pDst, pSrc);
+    }
 
     /* check if update counter needs to be reset */
     if (pReverbData->m_nUpdateCounter >= REVERB_MODULO_UPDATE_PERIOD_IN_SAMPLES)
@@ -512,7 +827,7 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
         // fetch allpass delay line out
         //nAddr = CIRCULAR(nBase, psAp0->m_zApOut, REVERB_BUFFER_MASK);
         nAddr = CIRCULAR(nBase, pReverbData->m_sAp0.m_zApOut, REVERB_BUFFER_MASK);
-        nDelayOut = pReverbData->m_nDelayLine[nAddr];
+        nDelayOut = pReverbData->m_pDelayLine[nAddr];
 
         // calculate allpass feedforward; subtract the feedforward result
         nTemp1 = MULT_EG1_EG1(nApIn, pReverbData->m_sAp0.m_nApGain);
@@ -524,11 +839,11 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
 
         // inject into allpass delay
         nAddr = CIRCULAR(nBase, pReverbData->m_sAp0.m_zApIn, REVERB_BUFFER_MASK);
-        pReverbData->m_nDelayLine[nAddr] = (EAS_PCM) nTemp1;
+        pReverbData->m_pDelayLine[nAddr] = (EAS_PCM) nTemp1;
 
         // inject allpass output into delay line
         nAddr = CIRCULAR(nBase, pReverbData->m_zD0In, REVERB_BUFFER_MASK);
-        pReverbData->m_nDelayLine[nAddr] = (EAS_PCM) nApOut;
+        pReverbData->m_pDelayLine[nAddr] = (EAS_PCM) nApOut;
 
         // ********** Left Allpass - end
 
@@ -540,7 +855,7 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
 
         // fetch allpass delay line out
         nAddr = CIRCULAR(nBase, pReverbData->m_sAp1.m_zApOut, REVERB_BUFFER_MASK);
-        nDelayOut = pReverbData->m_nDelayLine[nAddr];
+        nDelayOut = pReverbData->m_pDelayLine[nAddr];
 
         // calculate allpass feedforward; subtract the feedforward result
         nTemp1 = MULT_EG1_EG1(nApIn, pReverbData->m_sAp1.m_nApGain);
@@ -552,25 +867,25 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
 
         // inject into allpass delay
         nAddr = CIRCULAR(nBase, pReverbData->m_sAp1.m_zApIn, REVERB_BUFFER_MASK);
-        pReverbData->m_nDelayLine[nAddr] = (EAS_PCM) nTemp1;
+        pReverbData->m_pDelayLine[nAddr] = (EAS_PCM) nTemp1;
 
         // inject allpass output into delay line
         nAddr = CIRCULAR(nBase, pReverbData->m_zD1In, REVERB_BUFFER_MASK);
-        pReverbData->m_nDelayLine[nAddr] = (EAS_PCM) nApOut;
+        pReverbData->m_pDelayLine[nAddr] = (EAS_PCM) nApOut;
 
         // ********** Right Allpass - end
 
         // ********** D0 output - start
         // fetch delay line self out
         nAddr = CIRCULAR(nBase, pReverbData->m_zD0Self, REVERB_BUFFER_MASK);
-        nDelayOut = pReverbData->m_nDelayLine[nAddr];
+        nDelayOut = pReverbData->m_pDelayLine[nAddr];
 
         // calculate delay line self out
         nTemp1 = MULT_EG1_EG1(nDelayOut, pReverbData->m_nSin);
 
         // fetch delay line cross out
         nAddr = CIRCULAR(nBase, pReverbData->m_zD1Cross, REVERB_BUFFER_MASK);
-        nDelayOut = pReverbData->m_nDelayLine[nAddr];
+        nDelayOut = pReverbData->m_pDelayLine[nAddr];
 
         // calculate delay line self out
         nTemp2 = MULT_EG1_EG1(nDelayOut, pReverbData->m_nCos);
@@ -592,14 +907,14 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
         // ********** D1 output - start
         // fetch delay line self out
         nAddr = CIRCULAR(nBase, pReverbData->m_zD1Self, REVERB_BUFFER_MASK);
-        nDelayOut = pReverbData->m_nDelayLine[nAddr];
+        nDelayOut = pReverbData->m_pDelayLine[nAddr];
 
         // calculate delay line self out
         nTemp1 = MULT_EG1_EG1(nDelayOut, pReverbData->m_nSin);
 
         // fetch delay line cross out
         nAddr = CIRCULAR(nBase, pReverbData->m_zD0Cross, REVERB_BUFFER_MASK);
-        nDelayOut = pReverbData->m_nDelayLine[nAddr];
+        nDelayOut = pReverbData->m_pDelayLine[nAddr];
 
         // calculate delay line self out
         nTemp2 = MULT_EG1_EG1(nDelayOut, pReverbData->m_nCos);
@@ -641,7 +956,7 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
             //nAddr = CIRCULAR(nBase, psEarly->m_zDelay[j], REVERB_BUFFER_MASK);
             nAddr = CIRCULAR(nBase, pReverbData->m_sEarlyL.m_zDelay[j], REVERB_BUFFER_MASK);
 
-            nDelayOut = pReverbData->m_nDelayLine[nAddr];
+            nDelayOut = pReverbData->m_pDelayLine[nAddr];
 
             // calculate reflection
             //nTemp1 = MULT_EG1_EG1(nDelayOut, psEarly->m_nGain[j]);
@@ -686,7 +1001,7 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
         {
             // fetch delay line out
             nAddr = CIRCULAR(nBase, pReverbData->m_sEarlyR.m_zDelay[j], REVERB_BUFFER_MASK);
-            nDelayOut = pReverbData->m_nDelayLine[nAddr];
+            nDelayOut = pReverbData->m_pDelayLine[nAddr];
 
             // calculate reflection
             nTemp1 = MULT_EG1_EG1(nDelayOut, pReverbData->m_sEarlyR.m_nGain[j]);
@@ -750,12 +1065,63 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
 */
 static EAS_RESULT ReverbShutdown (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pInstData)
 {
+    S_REVERB_OBJECT *pReverbData;
+
+    pReverbData = (S_REVERB_OBJECT*) pInstData;
+
     /* check Configuration Module for static memory allocation */
     if (!pEASData->staticMemoryModel)
+    {
+        if ((pReverbData->m_pDelayLine != NULL) && !pReverbData->m_bStaticDelayLine)
+            EAS_HWFree(pEASData->hwInstData, pReverbData->m_pDelayLine);
         EAS_HWFree(pEASData->hwInstData, pInstData);
+    }
     return EAS_SUCCESS;
 } /* end ReverbShutdown */
 
+/*----------------------------------------------------------------------------
+ * ReverbClone()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Copy the reverb settings and delay line of another instance
+ *
+ * Inputs:
+ * pEASData         - instance that receives the copy
+ * pSrcData         - handle to the instance data being copied
+ * pInstData        - receives the handle to the new instance data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT ReverbClone (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pSrcData, EAS_VOID_PTR *pInstData)
+{
+    S_REVERB_OBJECT *pReverbData;
+    S_REVERB_OBJECT *pSrc;
+    EAS_RESULT result;
+
+    pSrc = (S_REVERB_OBJECT*) pSrcData;
+    if ((pReverbData = EAS_HWMalloc(pEASData->hwInstData, sizeof(S_REVERB_OBJECT))) == NULL)
+        return EAS_ERROR_MALLOC_FAILED;
+    EAS_HWMemCpy(pReverbData, pSrc, sizeof(S_REVERB_OBJECT));
+    pReverbData->m_pDelayLine = NULL;
+    pReverbData->m_hwInstData = pEASData->hwInstData;
+    pReverbData->m_bStaticDelayLine = EAS_FALSE;
+
+    if (pSrc->m_pDelayLine != NULL)
+    {
+        if ((result = ReverbAllocDelayLine(pReverbData)) != EAS_SUCCESS)
+        {
+            EAS_HWFree(pEASData->hwInstData, pReverbData);
+            return result;
+        }
+        EAS_HWMemCpy(pReverbData->m_pDelayLine, pSrc->m_pDelayLine, REVERB_BUFFER_SIZE_IN_SAMPLES * (EAS_I32) sizeof(EAS_PCM));
+    }
+
+    *pInstData = pReverbData;
+    return EAS_SUCCESS;
+} /* end ReverbClone */
+
 /*----------------------------------------------------------------------------
  * ReverbGetParam()
  *----------------------------------------------------------------------------
@@ -794,6 +1160,9 @@ static EAS_RESULT ReverbGetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32
         case EAS_PARAM_REVERB_DRY:
             *pValue = p->m_nDry;
             break;
+        case EAS_PARAM_REVERB_IDLE_TIME:
+            *pValue = p->m_nIdleTime;
+            break;
         default:
             return EAS_ERROR_INVALID_PARAMETER;
     }
@@ -822,13 +1191,18 @@ static EAS_RESULT ReverbGetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32
 static EAS_RESULT ReverbSetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value)
 {
     S_REVERB_OBJECT *p;
+    EAS_RESULT result;
 
     p = (S_REVERB_OBJECT*) pInstData;
 
     switch (param)
     {
         case EAS_PARAM_REVERB_BYPASS:
+            /* the delay line must exist before the reverb runs */
+            if (!value && ((result = ReverbAllocDelayLine(p)) != EAS_SUCCESS))
+                return result;
             p->m_bBypass = (EAS_BOOL) value;
+            p->m_nIdleSamples = 0;
             break;
         case EAS_PARAM_REVERB_PRESET:
             if(value!=EAS_PARAM_REVERB_LARGE_HALL && value!=EAS_PARAM_REVERB_HALL &&
@@ -847,6 +1221,11 @@ static EAS_RESULT ReverbSetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32
                 return EAS_ERROR_INVALID_PARAMETER;
             p->m_nDry = (EAS_I16)value;
             break;
+        case EAS_PARAM_REVERB_IDLE_TIME:
+            if(value>EAS_REVERB_IDLE_TIME_MAX || value<0)
+                return EAS_ERROR_INVALID_PARAMETER;
+            p->m_nIdleTime = value;
+            break;
         default:
             return EAS_ERROR_INVALID_PARAMETER;
     }
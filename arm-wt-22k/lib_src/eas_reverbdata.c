@@ -30,5 +30,8 @@
 
 #include "eas_reverbdata.h"
 
+/* the static memory model allocates its single instance here */
+#ifdef _STATIC_MEMORY
 S_REVERB_OBJECT eas_ReverbData;
-
+EAS_PCM eas_ReverbDelayLine[REVERB_BUFFER_SIZE_IN_SAMPLES];
+#endif
@@ -168,6 +168,16 @@ EAS_I32 nPanG1 = -1.0 for cos
 #define EAS_REVERB_DRY_MAX              32767
 #define EAS_REVERB_DRY_MIN              0
 
+#define EAS_REVERB_IDLE_TIME_DEFAULT    1000
+#define EAS_REVERB_IDLE_TIME_MAX        60000
+
+/* the fixed-point tail settles into a limit cycle instead of decaying to zero,
+ * up to about 90 LSB with the large hall, so a tail within the noise floor
+ * whose energy has stopped falling from one window to the next is cleared;
+ * the window spans the modulation, which swings the energy every 100 ms */
+#define REVERB_NOISE_FLOOR              96
+#define REVERB_QUIET_SAMPLES            (_OUTPUT_SAMPLE_RATE / 5)
+
 /* parameters for each allpass */
 typedef struct
 {
@@ -351,7 +361,24 @@ typedef struct
     S_EARLY_REFLECTION_OBJECT   m_sEarlyL;          // left channel early reflections
     S_EARLY_REFLECTION_OBJECT   m_sEarlyR;          // right channel early reflections
 
-    EAS_PCM             m_nDelayLine[REVERB_BUFFER_SIZE_IN_SAMPLES];    // one large delay line for all reverb elements
+    EAS_PCM             *m_pDelayLine;              // one large delay line for all reverb elements,
+                                                    // allocated when the bypass is first turned off
+
+    EAS_HW_DATA_HANDLE  m_hwInstData;               // owner of the delay line
+
+    EAS_BOOL            m_bStaticDelayLine;         // if EAS_TRUE, the delay line is never freed
+
+    EAS_I32             m_nIdleTime;                // free the delay line after this many ms bypassed
+
+    EAS_I32             m_nIdleSamples;             // samples processed since the bypass was turned on
+
+    EAS_BOOL            m_bQuiet;                   // if EAS_TRUE, the delay line and filter states are all zero
+
+    EAS_I32             m_nQuietSamples;            // samples in the window the tail has stayed within the noise floor
+
+    EAS_I32             m_nQuietEnergy;             // energy of the tail in the window so far
+
+    EAS_I32             m_nLastQuietEnergy;         // energy of the tail in the last window, -1 if none
 
     S_REVERB_PRESET     pPreset;
 
@@ -32,6 +32,8 @@
 #include "eas_miditypes.h"
 #include "eas_smfdata.h"
 
+/* the static memory model allocates its single instance here */
+#ifdef _STATIC_MEMORY
 /*----------------------------------------------------------------------------
  *
  * S_SMF_STREAM
@@ -63,4 +65,4 @@ S_SMF_DATA eas_SMFData =
     0,                  /* current state EAS_STATE_XXXX */
     0                   /* flags */
 };
-
+#endif
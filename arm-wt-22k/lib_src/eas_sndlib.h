@@ -341,8 +341,15 @@ typedef struct s_bank_tag
  * numDLSRegions        number of DLS regions
  * numDLSArticulations  number of DLS articulations
  * numDLSSamples        number of DLS samples
+ * programHash          program indices hashed by locale, built at load time
  *----------------------------------------------------------------------------
 */
+
+/* size of the program hash table, a power of 2 at least twice DLS_MAX_INST_COUNT */
+#define DLS_PROGRAM_HASH_SIZE       1024
+#define DLS_PROGRAM_HASH_EMPTY      0xffff
+#define DLS_PROGRAM_HASH(locale)    ((EAS_U16) ((((locale) * 0x9e3779b1U) & 0xffffffffU) >> 22))
+
 typedef struct s_eas_dls_tag
 {
     S_PROGRAM           *pDLSPrograms;
@@ -355,7 +362,9 @@ typedef struct s_eas_dls_tag
     EAS_U16             numDLSRegions;
     EAS_U16             numDLSArticulations;
     EAS_U16             numDLSSamples;
-    EAS_U8              refCount;
+    EAS_UINT            refCount;       /* shared by instances on different threads, see eas_atomic.h */
+    EAS_BOOL8           cached;         /* listed in the process-wide DLS cache */
+    EAS_U16             programHash[DLS_PROGRAM_HASH_SIZE];
 } S_DLS;
 #endif
 
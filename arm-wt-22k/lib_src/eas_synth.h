@@ -97,6 +97,12 @@
 #define UNASSIGNED_SYNTH_CHANNEL    NUM_SYNTH_CHANNELS
 #define UNASSIGNED_SYNTH_VOICE      MAX_SYNTH_VOICES
 
+/* key to region lookup, programs with more regions than KEY_REGION_MAX_OFFSET are searched */
+#define NUM_KEY_REGIONS             128
+#define KEY_REGION_MAX_OFFSET       0xfd
+#define KEY_REGION_SEARCH           0xfe
+#define KEY_REGION_NONE             0xff
+
 
 /* synth parameters are updated every SYNTH_UPDATE_PERIOD_IN_SAMPLES */
 #define SYNTH_UPDATE_PERIOD_IN_SAMPLES  (EAS_I32)(0x1L << SYNTH_UPDATE_PERIOD_IN_BITS)
@@ -236,6 +242,10 @@ typedef struct s_synth_channel_tag
 #ifdef  _CHORUS
     EAS_U8      chorusSend;         /* CC93 */
 #endif
+
+    /* offsets from regionIndex of the first and last region covering each key */
+    EAS_U8      firstKeyRegion[NUM_KEY_REGIONS];
+    EAS_U8      lastKeyRegion[NUM_KEY_REGIONS];
 } S_SYNTH_CHANNEL;
 
 /*------------------------------------
@@ -325,6 +335,7 @@ typedef struct s_synth_tag
     EAS_U8                  channelsByPriority[NUM_SYNTH_CHANNELS];
     EAS_U8                  poolCount[NUM_SYNTH_CHANNELS];
     EAS_U8                  poolAlloc[NUM_SYNTH_CHANNELS];
+    EAS_U8                  channelBus[NUM_SYNTH_CHANNELS];
     EAS_U8                  synthFlags;
     EAS_I8                  globalTranspose;
     EAS_U8                  vSynthNum;
@@ -332,6 +343,9 @@ typedef struct s_synth_tag
     EAS_U8                  priority;
 } S_SYNTH;
 
+/* size of one stem bus in samples */
+#define STEM_BUS_SIZE                       (BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS)
+
 /*------------------------------------
  * S_VOICE_MGR data structure
  *
@@ -379,6 +393,15 @@ typedef struct s_voice_mgr_tag
     EAS_I32                 workload;
     EAS_I32                 maxWorkLoad;
 
+    /* voices below this gain are not synthesized, 0 synthesizes all voices */
+    EAS_I32                 cullGain;
+
+    /* stem buses, voices on a channel routed to a bus are mixed there
+     * and the bus is added to the mix buffer after all voices */
+    EAS_I32                 *pStemBuffer;
+    EAS_U32                 stemBusActive;
+    EAS_INT                 numStemBuses;
+
     EAS_U16                 activeVoices;
     EAS_U16                 maxPolyphony;
 
@@ -32,6 +32,8 @@
 #include "eas_types.h"
 #include "eas_tcdata.h"
 
+/* the static memory model allocates its single instance here */
+#ifdef _STATIC_MEMORY
 /*----------------------------------------------------------------------------
  *
  * eas_iMelodyData
@@ -40,4 +42,4 @@
  *----------------------------------------------------------------------------
 */
 S_TC_DATA eas_TCData;
-
+#endif
@@ -48,6 +48,22 @@
 */
 EAS_RESULT VMInitialize (S_EAS_DATA *pEASData);
 
+/*----------------------------------------------------------------------------
+ * VMResetVoiceMgr()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the voice manager to the state set by VMInitialize
+ *
+ * Inputs:
+ * psEASData - pointer to overall EAS data structure
+ * keepDLS - EAS_TRUE to keep the global DLS collection
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void VMResetVoiceMgr (S_EAS_DATA *pEASData, EAS_BOOL keepDLS);
+
 /*----------------------------------------------------------------------------
  * VMInitMIDI()
  *----------------------------------------------------------------------------
@@ -636,6 +652,28 @@ void VMMuteAllVoices (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth);
 */
 void VMReleaseAllVoices (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth);
 
+/*----------------------------------------------------------------------------
+ * VMMuteQuietVoices()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Used by offline rendering at the end of a file. Once every voice of the
+ * synth has faded below the given gain, the remaining tails are muted so
+ * the stream stops instead of rendering inaudible samples.
+ *
+ * Inputs:
+ * pVoiceMgr - pointer to voice manager
+ * pSynth - pointer to synth
+ * gain - voices below this gain are inaudible
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * - forces all voices to update their envelope states to mute
+ *
+ *----------------------------------------------------------------------------
+*/
+void VMMuteQuietVoices (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_I32 gain);
+
 /*----------------------------------------------------------------------------
  * VMAllNotesOff()
  *----------------------------------------------------------------------------
@@ -959,6 +997,81 @@ void VMInitWorkload (S_VOICE_MGR *pVoiceMgr);
 */
 void VMSetWorkload (S_VOICE_MGR *pVoiceMgr, EAS_I32 maxWorkLoad);
 
+/*----------------------------------------------------------------------------
+ * VMSetCullGain()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sets the gain below which voices only advance their phase and envelopes
+ * instead of being synthesized and mixed.
+ *
+ * Inputs:
+ * pVoiceMgr            - pointer to instance data
+ * cullGain             - 1.15 gain threshold, 0 to synthesize every voice
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+void VMSetCullGain (S_VOICE_MGR *pVoiceMgr, EAS_I32 cullGain);
+
+/*----------------------------------------------------------------------------
+ * VMSetStemBuses()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Allocates the stem buses, or frees them if numBuses is zero.
+ *
+ * Inputs:
+ * pEASData             - pointer to overall EAS data structure
+ * numBuses             - number of stem buses
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMSetStemBuses (S_EAS_DATA *pEASData, EAS_INT numBuses);
+
+/*----------------------------------------------------------------------------
+ * VMGetStemBus()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the 32-bit mix of a stem bus for the last frame, or NULL if
+ * no voice was mixed into it.
+ *
+ * Inputs:
+ * pVoiceMgr            - pointer to instance data
+ * bus                  - stem bus number
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_I32 *VMGetStemBus (S_VOICE_MGR *pVoiceMgr, EAS_INT bus);
+
+/*----------------------------------------------------------------------------
+ * VMSetChannelBus()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Routes a MIDI channel of a virtual synth to a stem bus.
+ *
+ * Inputs:
+ * pSynth               - pointer to virtual synth
+ * channel              - MIDI channel
+ * bus                  - stem bus number
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+void VMSetChannelBus (S_SYNTH *pSynth, EAS_INT channel, EAS_INT bus);
+
 /*----------------------------------------------------------------------------
  * VMCheckWorkload()
  *----------------------------------------------------------------------------
@@ -51,19 +51,19 @@
 #define WORKLOAD_AMOUNT_POLY_LIMIT          10
 
 /* pointer to base sound library */
-extern S_EAS easSoundLib;
+extern const S_EAS easSoundLib;
 
 #ifdef TEST_HARNESS
-extern S_EAS easTestLib;
+extern const S_EAS easTestLib;
 EAS_SNDLIB_HANDLE VMGetLibHandle(EAS_INT libNum)
 {
     switch (libNum)
     {
         case 0:
-            return &easSoundLib;
+            return (EAS_SNDLIB_HANDLE) &easSoundLib;
 #ifdef _WT_SYNTH
         case 1:
-            return &easTestLib;
+            return (EAS_SNDLIB_HANDLE) &easTestLib;
 #endif
         default:
             return NULL;
@@ -253,32 +253,15 @@ static void DecVoicePoolCount (S_VOICE_MGR *pVoiceMgr, S_SYNTH_VOICE *pVoice)
 }
 
 /*----------------------------------------------------------------------------
- * VMInitialize()
+ * VMInitVoiceMgr()
  *----------------------------------------------------------------------------
- * Purpose:
- *
- * Inputs:
- * psEASData - pointer to overall EAS data structure
- *
- * Outputs:
- *
+ * Sets the voice manager to its initial state
  *----------------------------------------------------------------------------
 */
-EAS_RESULT VMInitialize (S_EAS_DATA *pEASData)
+static void VMInitVoiceMgr (S_VOICE_MGR *pVoiceMgr)
 {
-    S_VOICE_MGR *pVoiceMgr;
     EAS_INT i;
 
-    /* check Configuration Module for data allocation */
-    if (pEASData->staticMemoryModel)
-        pVoiceMgr = EAS_CMEnumData(EAS_CM_SYNTH_DATA);
-    else
-        pVoiceMgr = EAS_HWMalloc(pEASData->hwInstData, sizeof(S_VOICE_MGR));
-    if (!pVoiceMgr)
-    {
-        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "VMInitialize: Failed to allocate synthesizer memory\n"); */ }
-        return EAS_ERROR_MALLOC_FAILED;
-    }
     EAS_HWMemSet(pVoiceMgr, 0, sizeof(S_VOICE_MGR));
 
     /* initialize non-zero variables */
@@ -306,11 +289,94 @@ EAS_RESULT VMInitialize (S_EAS_DATA *pEASData)
     /*lint -e{522} return unused at this time */
     pSecondarySynth->pfInitialize(pVoiceMgr);
 #endif
+}
+
+/*----------------------------------------------------------------------------
+ * VMInitialize()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ *
+ * Inputs:
+ * psEASData - pointer to overall EAS data structure
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMInitialize (S_EAS_DATA *pEASData)
+{
+    S_VOICE_MGR *pVoiceMgr;
+
+    /* check Configuration Module for data allocation */
+    if (pEASData->staticMemoryModel)
+        pVoiceMgr = EAS_CMEnumData(EAS_CM_SYNTH_DATA);
+    else
+        pVoiceMgr = EAS_HWMalloc(pEASData->hwInstData, sizeof(S_VOICE_MGR));
+    if (!pVoiceMgr)
+    {
+        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "VMInitialize: Failed to allocate synthesizer memory\n"); */ }
+        return EAS_ERROR_MALLOC_FAILED;
+    }
+    VMInitVoiceMgr(pVoiceMgr);
 
     pEASData->pVoiceMgr = pVoiceMgr;
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * VMResetVoiceMgr()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the voice manager to the state set by VMInitialize without
+ * reallocating it. All virtual synthesizers must have been shut down.
+ *
+ * Inputs:
+ * psEASData - pointer to overall EAS data structure
+ * keepDLS - EAS_TRUE to keep the global DLS collection
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void VMResetVoiceMgr (S_EAS_DATA *pEASData, EAS_BOOL keepDLS)
+{
+    EAS_I32 *pStemBuffer;
+    EAS_INT numStemBuses;
+
+#ifdef DLS_SYNTHESIZER
+    S_DLS *pDLS;
+
+    pDLS = pEASData->pVoiceMgr->pGlobalDLS;
+    if (pDLS && !keepDLS)
+    {
+        DLSCleanup(pEASData->hwInstData, pDLS);
+        pDLS = NULL;
+    }
+#endif
+
+#ifdef _SPLIT_ARCHITECTURE
+    EAS_FRAME_BUFFER_HANDLE pFrameBuffer = pEASData->pVoiceMgr->pFrameBuffer;
+#endif
+
+    /* the stem buses are kept, with their last frame cleared */
+    pStemBuffer = pEASData->pVoiceMgr->pStemBuffer;
+    numStemBuses = pEASData->pVoiceMgr->numStemBuses;
+    if (pStemBuffer)
+        EAS_HWMemSet(pStemBuffer, 0, numStemBuses * STEM_BUS_SIZE * (EAS_I32) sizeof(EAS_I32));
+
+    VMInitVoiceMgr(pEASData->pVoiceMgr);
+
+#ifdef _SPLIT_ARCHITECTURE
+    pEASData->pVoiceMgr->pFrameBuffer = pFrameBuffer;
+#endif
+    pEASData->pVoiceMgr->pStemBuffer = pStemBuffer;
+    pEASData->pVoiceMgr->numStemBuses = numStemBuses;
+
+#ifdef DLS_SYNTHESIZER
+    pEASData->pVoiceMgr->pGlobalDLS = pDLS;
+#endif
+}
+
 /*----------------------------------------------------------------------------
  * VMInitMIDI()
  *----------------------------------------------------------------------------
@@ -328,6 +394,7 @@ EAS_RESULT VMInitMIDI (S_EAS_DATA *pEASData, S_SYNTH **ppSynth)
     EAS_RESULT result;
     S_SYNTH *pSynth;
     EAS_INT virtualSynthNum;
+    EAS_INT channel;
 
     *ppSynth = NULL;
 
@@ -390,6 +457,10 @@ EAS_RESULT VMInitMIDI (S_EAS_DATA *pEASData, S_SYNTH **ppSynth)
     pSynth->priority = DEFAULT_SYNTH_PRIORITY;
     pSynth->poolAlloc[0] = (EAS_U8) pEASData->pVoiceMgr->maxPolyphony;
 
+    /* each channel has a stem bus of its own, a MIDI reset keeps the routing */
+    for (channel = 0; channel < NUM_SYNTH_CHANNELS; channel++)
+        pSynth->channelBus[channel] = (EAS_U8) channel;
+
     VMInitializeAllChannels(pEASData->pVoiceMgr, pSynth);
 
     pSynth->vSynthNum = (EAS_U8) virtualSynthNum;
@@ -960,6 +1031,60 @@ void VMReleaseAllVoices (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth)
     }
 }
 
+/*----------------------------------------------------------------------------
+ * VMMuteQuietVoices()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Used by offline rendering at the end of a file. Once every voice of the
+ * synth has faded below the given gain, the remaining tails are muted so
+ * the stream stops instead of rendering inaudible samples.
+ *
+ * Inputs:
+ * pVoiceMgr - pointer to voice manager
+ * pSynth - pointer to synth
+ * gain - voices below this gain are inaudible
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * - forces all voices to update their envelope states to mute
+ *
+ *----------------------------------------------------------------------------
+*/
+void VMMuteQuietVoices (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_I32 gain)
+{
+    S_SYNTH_VOICE *pVoice;
+    EAS_INT i;
+
+    if (pSynth->numActiveVoices == 0)
+        return;
+
+    for (i = 0; i < MAX_SYNTH_VOICES; i++)
+    {
+        pVoice = &pVoiceMgr->voices[i];
+        if (pVoice->voiceState == eVoiceStateFree)
+            continue;
+
+        /* stolen voices are about to start a new note */
+        if (pVoice->voiceState == eVoiceStateStolen)
+        {
+            if (GET_VSYNTH(pVoice->nextChannel) == pSynth->vSynthNum)
+                return;
+            continue;
+        }
+        if (GET_VSYNTH(pVoice->channel) != pSynth->vSynthNum)
+            continue;
+
+        /* the gain is only known once the voice has been rendered */
+        if ((pVoice->voiceState == eVoiceStateStart) || (pVoice->voiceFlags & VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET))
+            return;
+        if ((pVoice->gain >= gain) || (pVoice->gain <= -gain))
+            return;
+    }
+
+    VMMuteAllVoices(pVoiceMgr, pSynth);
+}
+
 /*----------------------------------------------------------------------------
  * VMAllNotesOff()
  *----------------------------------------------------------------------------
@@ -1748,6 +1873,8 @@ void VMStartNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U
 {
     S_SYNTH_CHANNEL *pChannel;
     EAS_U16 regionIndex;
+    EAS_U16 lastRegionIndex;
+    EAS_U8 regionOffset;
     EAS_I16 adjustedNote;
 
     /* bump note count */
@@ -1793,6 +1920,18 @@ void VMStartNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U
         adjustedNote = 127;
     }
 
+    /* skip to the first region covering this key */
+    regionOffset = pChannel->firstKeyRegion[adjustedNote];
+    if (regionOffset == KEY_REGION_NONE)
+        return;
+    if (regionOffset == KEY_REGION_SEARCH)
+        lastRegionIndex = INVALID_REGION_INDEX;
+    else
+    {
+        lastRegionIndex = regionIndex + pChannel->lastKeyRegion[adjustedNote];
+        regionIndex += regionOffset;
+    }
+
 #if defined(DLS_SYNTHESIZER)
     if (regionIndex & FLAG_RGN_IDX_DLS_SYNTH)
     {
@@ -1809,8 +1948,8 @@ void VMStartNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U
                 VMStartVoice(pVoiceMgr, pSynth, channel, note, velocity, regionIndex);
             }
 
-            /* last region in program? */
-            if (pDLSRegion->wtRegion.region.keyGroupAndFlags & REGION_FLAG_LAST_REGION)
+            /* last region in program or covering this key? */
+            if ((pDLSRegion->wtRegion.region.keyGroupAndFlags & REGION_FLAG_LAST_REGION) || (regionIndex == lastRegionIndex))
                 break;
 
             /* advance to next region */
@@ -2563,6 +2702,67 @@ void VMUpdateStaticChannelParameters (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth)
     return;
 }
 
+/*----------------------------------------------------------------------------
+ * VMBuildKeyRegionMap()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Records, for each key, the first and last region of the channel's
+ * program whose key range covers it, so that VMStartNote() does not
+ * have to walk the region list on every note-on.
+ *
+ * Inputs:
+ * pSynth - pointer to virtual synth
+ * pChannel - pointer to channel whose program has changed
+ *
+ * Outputs:
+ *----------------------------------------------------------------------------
+*/
+static void VMBuildKeyRegionMap (S_SYNTH *pSynth, S_SYNTH_CHANNEL *pChannel)
+{
+    const S_REGION *pRegion;
+    EAS_U16 regionIndex;
+    EAS_INT offset;
+    EAS_INT key;
+
+    EAS_HWMemSet(pChannel->firstKeyRegion, KEY_REGION_NONE, sizeof(pChannel->firstKeyRegion));
+    EAS_HWMemSet(pChannel->lastKeyRegion, KEY_REGION_NONE, sizeof(pChannel->lastKeyRegion));
+
+    /* no sound library, nothing to play */
+    regionIndex = pChannel->regionIndex;
+#ifdef DLS_SYNTHESIZER
+    if (regionIndex & FLAG_RGN_IDX_DLS_SYNTH)
+    {
+        if (pSynth->pDLS == NULL)
+            return;
+    }
+    else
+#endif
+    if (pSynth->pEAS == NULL)
+        return;
+
+    for (offset = 0; ; offset++, regionIndex++)
+    {
+        /* too many regions in this program, fall back to searching */
+        if (offset > KEY_REGION_MAX_OFFSET)
+        {
+            EAS_HWMemSet(pChannel->firstKeyRegion, KEY_REGION_SEARCH, sizeof(pChannel->firstKeyRegion));
+            return;
+        }
+
+        pRegion = GetRegionPtr(pSynth, regionIndex);
+        for (key = pRegion->rangeLow; (key <= pRegion->rangeHigh) && (key < NUM_KEY_REGIONS); key++)
+        {
+            if (pChannel->firstKeyRegion[key] == KEY_REGION_NONE)
+                pChannel->firstKeyRegion[key] = (EAS_U8) offset;
+            pChannel->lastKeyRegion[key] = (EAS_U8) offset;
+        }
+
+        /* last region in program? */
+        if (pRegion->keyGroupAndFlags & REGION_FLAG_LAST_REGION)
+            break;
+    }
+}
+
 /*----------------------------------------------------------------------------
  * VMFindProgram()
  *----------------------------------------------------------------------------
@@ -2619,6 +2819,38 @@ static EAS_RESULT VMFindProgram (const S_EAS *pEAS, EAS_U32 bank, EAS_U8 program
 }
 
 #ifdef DLS_SYNTHESIZER
+/*----------------------------------------------------------------------------
+ * VMFindDLSLocale()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Look up a program by locale in the program hash table that was built
+ * when the DLS collection was loaded.
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT VMFindDLSLocale (const S_DLS *pDLS, EAS_U32 locale, EAS_U16 *pRegionIndex)
+{
+    EAS_U16 slot;
+    EAS_U16 index;
+
+    slot = DLS_PROGRAM_HASH(locale);
+    for (;;)
+    {
+        index = pDLS->programHash[slot];
+        if (index == DLS_PROGRAM_HASH_EMPTY)
+            return EAS_FAILURE;
+        if (pDLS->pDLSPrograms[index].locale == locale)
+        {
+            *pRegionIndex = pDLS->pDLSPrograms[index].regionIndex;
+            return EAS_SUCCESS;
+        }
+        slot = (slot + 1) & (DLS_PROGRAM_HASH_SIZE - 1);
+    }
+}
+
 /*----------------------------------------------------------------------------
  * VMFindDLSProgram()
  *----------------------------------------------------------------------------
@@ -2635,8 +2867,6 @@ static EAS_RESULT VMFindProgram (const S_EAS *pEAS, EAS_U32 bank, EAS_U8 program
 static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 programNum, EAS_U16 *pRegionIndex)
 {
     EAS_U32 locale;
-    const S_PROGRAM *p;
-    EAS_U16 i;
 
     /* make sure we have a valid sound library */
     if (pDLS == NULL)
@@ -2646,14 +2876,8 @@ static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 prog
     locale = (bank << 8) | programNum;
 
     /* search for program */
-    for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
-    {
-        if (p->locale == locale)
-        {
-            *pRegionIndex = p->regionIndex;
-            return EAS_SUCCESS;
-        }
-    }
+    if (VMFindDLSLocale(pDLS, locale, pRegionIndex) == EAS_SUCCESS)
+        return EAS_SUCCESS;
 
     /* also search bank 0 when default bank (MSB) is used */
     if (((bank & 0xFF00) == DEFAULT_MELODY_BANK_NUMBER) || ((bank & 0xFF00) == DEFAULT_RHYTHM_BANK_NUMBER))
@@ -2662,14 +2886,8 @@ static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 prog
         locale = ((bank & 0x100FF) << 8) | programNum;
 
         /* search for program */
-        for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
-        {
-            if (p->locale == locale)
-            {
-                *pRegionIndex = p->regionIndex;
-                return EAS_SUCCESS;
-            }
-        }
+        if (VMFindDLSLocale(pDLS, locale, pRegionIndex) == EAS_SUCCESS)
+            return EAS_SUCCESS;
     }
 
     /* fall back to default bank */
@@ -2686,14 +2904,8 @@ static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 prog
         }
 
         /* search for program */
-        for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
-        {
-            if (p->locale == locale)
-            {
-                *pRegionIndex = p->regionIndex;
-                return EAS_SUCCESS;
-            }
-        }
+        if (VMFindDLSLocale(pDLS, locale, pRegionIndex) == EAS_SUCCESS)
+            return EAS_SUCCESS;
 
         /* also search bank 0 */
 
@@ -2701,14 +2913,8 @@ static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 prog
         locale = ((bank & 0x10000) << 8) | programNum;
 
         /* search for program */
-        for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
-        {
-            if (p->locale == locale)
-            {
-                *pRegionIndex = p->regionIndex;
-                return EAS_SUCCESS;
-            }
-        }
+        if (VMFindDLSLocale(pDLS, locale, pRegionIndex) == EAS_SUCCESS)
+            return EAS_SUCCESS;
     }
 
     /* switch to program 0 in the default bank, when searching for drum instrument */
@@ -2718,14 +2924,8 @@ static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 prog
         locale = ((0x10000 | DEFAULT_RHYTHM_BANK_NUMBER) << 8);
 
         /* search for program */
-        for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
-        {
-            if (p->locale == locale)
-            {
-                *pRegionIndex = p->regionIndex;
-                return EAS_SUCCESS;
-            }
-        }
+        if (VMFindDLSLocale(pDLS, locale, pRegionIndex) == EAS_SUCCESS)
+            return EAS_SUCCESS;
 
         /* also search bank 0 */
 
@@ -2733,14 +2933,8 @@ static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 prog
         locale = (0x10000 << 8);
 
         /* search for program */
-        for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
-        {
-            if (p->locale == locale)
-            {
-                *pRegionIndex = p->regionIndex;
-                return EAS_SUCCESS;
-            }
-        }
+        if (VMFindDLSLocale(pDLS, locale, pRegionIndex) == EAS_SUCCESS)
+            return EAS_SUCCESS;
     }
 
     return EAS_FAILURE;
@@ -2847,6 +3041,7 @@ void VMProgramChange (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, E
     /* we have our new program change for this channel */
     pChannel->programNum = program;
     pChannel->regionIndex = regionIndex;
+    VMBuildKeyRegionMap(pSynth, pChannel);
 
     /*
     set a channel flag to request parameter updates
@@ -2878,8 +3073,10 @@ void VMProgramChange (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, E
 EAS_I32 VMAddSamples (S_VOICE_MGR *pVoiceMgr, EAS_I32 *pMixBuffer, EAS_I32 numSamples)
 {
     S_SYNTH *pSynth;
+    EAS_I32 *pVoiceMix;
     EAS_INT voicesRendered;
     EAS_INT voiceNum;
+    EAS_INT bus;
     EAS_BOOL done;
 
 #ifdef  _REVERB
@@ -2890,6 +3087,10 @@ EAS_I32 VMAddSamples (S_VOICE_MGR *pVoiceMgr, EAS_I32 *pMixBuffer, EAS_I32 numSa
     EAS_PCM *pChorusSendBuffer;
 #endif  // ifdef    _CHORUS
 
+    /* stolen voices are still counted, so there is nothing to scan */
+    if (pVoiceMgr->activeVoices == 0)
+        return 0;
+
     voicesRendered = 0;
     for (voiceNum = 0; voiceNum < MAX_SYNTH_VOICES; voiceNum++)
     {
@@ -2904,7 +3105,19 @@ EAS_I32 VMAddSamples (S_VOICE_MGR *pVoiceMgr, EAS_I32 *pMixBuffer, EAS_I32 numSa
         /* synthesize active voices */
         if (pVoiceMgr->voices[voiceNum].voiceState != eVoiceStateFree)
         {
-            done = GetSynthPtr(voiceNum)->pfUpdateVoice(pVoiceMgr, pSynth, &pVoiceMgr->voices[voiceNum], GetAdjustedVoiceNum(voiceNum), pMixBuffer, numSamples);
+            /* mix into the stem bus of the voice's channel, if there is one */
+            pVoiceMix = pMixBuffer;
+            if (pVoiceMgr->pStemBuffer)
+            {
+                bus = pSynth->channelBus[GET_CHANNEL(pVoiceMgr->voices[voiceNum].channel)];
+                if (bus < pVoiceMgr->numStemBuses)
+                {
+                    pVoiceMix = pVoiceMgr->pStemBuffer + bus * STEM_BUS_SIZE;
+                    pVoiceMgr->stemBusActive |= 1U << bus;
+                }
+            }
+
+            done = GetSynthPtr(voiceNum)->pfUpdateVoice(pVoiceMgr, pSynth, &pVoiceMgr->voices[voiceNum], GetAdjustedVoiceNum(voiceNum), pVoiceMix, numSamples);
             voicesRendered++;
 
             /* voice is finished */
@@ -2954,6 +3167,8 @@ EAS_I32 VMAddSamples (S_VOICE_MGR *pVoiceMgr, EAS_I32 *pMixBuffer, EAS_I32 numSa
 EAS_RESULT VMRender (S_VOICE_MGR *pVoiceMgr, EAS_I32 numSamples, EAS_I32 *pMixBuffer, EAS_I32 *pVoicesRendered)
 {
     S_SYNTH *pSynth;
+    EAS_I32 *pBus;
+    EAS_I32 n;
     EAS_INT i;
     EAS_INT channel;
 
@@ -2969,9 +3184,26 @@ EAS_RESULT VMRender (S_VOICE_MGR *pVoiceMgr, EAS_I32 numSamples, EAS_I32 *pMixBu
             VMUpdateStaticChannelParameters(pVoiceMgr, pVoiceMgr->pSynth[i]);
     }
 
+    /* clear the stem buses that were mixed into last frame */
+    for (i = 0; i < pVoiceMgr->numStemBuses; i++)
+        if (pVoiceMgr->stemBusActive & (1U << i))
+            EAS_HWMemSet(pVoiceMgr->pStemBuffer + i * STEM_BUS_SIZE, 0, STEM_BUS_SIZE * (EAS_I32) sizeof(EAS_I32));
+    pVoiceMgr->stemBusActive = 0;
+
     /* synthesize a buffer of audio */
     *pVoicesRendered = VMAddSamples(pVoiceMgr, pMixBuffer, numSamples);
 
+    /* the mix is the sum of the stem buses and the voices on no bus */
+    for (i = 0; i < pVoiceMgr->numStemBuses; i++)
+    {
+        if (pVoiceMgr->stemBusActive & (1U << i))
+        {
+            pBus = pVoiceMgr->pStemBuffer + i * STEM_BUS_SIZE;
+            for (n = 0; n < numSamples * NUM_OUTPUT_CHANNELS; n++)
+                pMixBuffer[n] += pBus[n];
+        }
+    }
+
     /*
      * check for deferred note-off messages
      * If flag is set, that means one or more voices are expecting deferred
@@ -3061,6 +3293,121 @@ void VMSetWorkload (S_VOICE_MGR *pVoiceMgr, EAS_I32 maxWorkLoad)
     pVoiceMgr->maxWorkLoad = maxWorkLoad;
 }
 
+/*----------------------------------------------------------------------------
+ * VMSetCullGain()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sets the gain below which voices only advance their phase and envelopes
+ * instead of being synthesized and mixed.
+ *
+ * Inputs:
+ * pVoiceMgr            - pointer to instance data
+ * cullGain             - 1.15 gain threshold, 0 to synthesize every voice
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+void VMSetCullGain (S_VOICE_MGR *pVoiceMgr, EAS_I32 cullGain)
+{
+    pVoiceMgr->cullGain = cullGain;
+}
+
+/*----------------------------------------------------------------------------
+ * VMSetStemBuses()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Allocates the stem buses, or frees them if numBuses is zero.
+ *
+ * Inputs:
+ * pEASData             - pointer to overall EAS data structure
+ * numBuses             - number of stem buses
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * Voices playing on a channel routed to a bus move to the new buses
+ * on the next frame.
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMSetStemBuses (S_EAS_DATA *pEASData, EAS_INT numBuses)
+{
+    S_VOICE_MGR *pVoiceMgr;
+    EAS_I32 *pStemBuffer;
+    EAS_I32 size;
+
+    /* the old buses go first, so an arena only ever holds one set */
+    pVoiceMgr = pEASData->pVoiceMgr;
+    if (pVoiceMgr->pStemBuffer)
+        EAS_HWFree(pEASData->hwInstData, pVoiceMgr->pStemBuffer);
+    pVoiceMgr->pStemBuffer = NULL;
+    pVoiceMgr->numStemBuses = 0;
+    pVoiceMgr->stemBusActive = 0;
+
+    pStemBuffer = NULL;
+    if (numBuses)
+    {
+        size = numBuses * STEM_BUS_SIZE * (EAS_I32) sizeof(EAS_I32);
+        if ((pStemBuffer = EAS_HWMalloc(pEASData->hwInstData, size)) == NULL)
+            return EAS_ERROR_MALLOC_FAILED;
+        EAS_HWMemSet(pStemBuffer, 0, size);
+    }
+
+    pVoiceMgr->pStemBuffer = pStemBuffer;
+    pVoiceMgr->numStemBuses = numBuses;
+    pVoiceMgr->stemBusActive = 0;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * VMGetStemBus()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the 32-bit mix of a stem bus for the last frame, or NULL if
+ * no voice was mixed into it.
+ *
+ * Inputs:
+ * pVoiceMgr            - pointer to instance data
+ * bus                  - stem bus number
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_I32 *VMGetStemBus (S_VOICE_MGR *pVoiceMgr, EAS_INT bus)
+{
+    if ((bus >= pVoiceMgr->numStemBuses) || !(pVoiceMgr->stemBusActive & (1U << bus)))
+        return NULL;
+    return pVoiceMgr->pStemBuffer + bus * STEM_BUS_SIZE;
+}
+
+/*----------------------------------------------------------------------------
+ * VMSetChannelBus()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Routes a MIDI channel of a virtual synth to a stem bus.
+ *
+ * Inputs:
+ * pSynth               - pointer to virtual synth
+ * channel              - MIDI channel
+ * bus                  - stem bus number
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+void VMSetChannelBus (S_SYNTH *pSynth, EAS_INT channel, EAS_INT bus)
+{
+    pSynth->channelBus[channel] = (EAS_U8) bus;
+}
+
 /*----------------------------------------------------------------------------
  * VMCheckWorkload()
  *----------------------------------------------------------------------------
@@ -3639,12 +3986,17 @@ EAS_RESULT VMSetGlobalEASLib (S_VOICE_MGR *pVoiceMgr, EAS_SNDLIB_HANDLE pEAS)
 EAS_RESULT VMSetEASLib (S_SYNTH *pSynth, EAS_SNDLIB_HANDLE pEAS)
 {
     EAS_RESULT result;
+    EAS_INT i;
 
     result = VMValidateEASLib(pEAS);
     if (result != EAS_SUCCESS)
         return result;
 
     pSynth->pEAS = pEAS;
+
+    /* the key maps point into the library */
+    for (i = 0; i < NUM_SYNTH_CHANNELS; i++)
+        VMBuildKeyRegionMap(pSynth, &pSynth->channels[i]);
     return EAS_SUCCESS;
 }
 
@@ -3693,7 +4045,13 @@ EAS_RESULT VMSetGlobalDLSLib (EAS_DATA_HANDLE pEASData, EAS_DLSLIB_HANDLE pDLS)
 */
 EAS_RESULT VMSetDLSLib (S_SYNTH *pSynth, EAS_DLSLIB_HANDLE pDLS)
 {
+    EAS_INT i;
+
     pSynth->pDLS = pDLS;
+
+    /* the key maps point into the library */
+    for (i = 0; i < NUM_SYNTH_CHANNELS; i++)
+        VMBuildKeyRegionMap(pSynth, &pSynth->channels[i]);
     return EAS_SUCCESS;
 }
 #endif
@@ -3835,6 +4193,13 @@ void VMShutdown (S_EAS_DATA *pEASData)
     }
 #endif
 
+    /* free the stem buses */
+    if (pEASData->pVoiceMgr->pStemBuffer)
+    {
+        EAS_HWFree(pEASData->hwInstData, pEASData->pVoiceMgr->pStemBuffer);
+        pEASData->pVoiceMgr->pStemBuffer = NULL;
+    }
+
     /* check Configuration Module for static memory allocation */
     if (!pEASData->staticMemoryModel)
         EAS_HWFree(pEASData->hwInstData, pEASData->pVoiceMgr);
@@ -72,6 +72,12 @@ extern double log10(double x);
 /* file size for streamed file */
 #define FILE_SIZE_STREAMING         0x80000000
 
+/* the PCM engine keeps the sample rate in 16 bits */
+#define WAVE_MAX_SAMPLE_RATE        65535
+
+/* size of the PCM fields of a 'fmt ' chunk */
+#define WAVE_FMT_MIN_SIZE           16
+
 /*----------------------------------------------------------------------------
  * prototypes
  *----------------------------------------------------------------------------
@@ -84,8 +90,8 @@ static EAS_RESULT WaveReset (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData);
 static EAS_RESULT WaveLocate (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 time, EAS_BOOL *pParserLocate);
 static EAS_RESULT WavePause (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData);
 static EAS_RESULT WaveResume (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData);
-static EAS_RESULT WaveSetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value);
-static EAS_RESULT WaveGetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue);
+static EAS_RESULT WaveSetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_INTPTR value);
+static EAS_RESULT WaveGetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_INTPTR *pValue);
 static EAS_RESULT WaveParseHeader (S_EAS_DATA *pEASData, EAS_FILE_HANDLE fileHandle, S_WAVE_STATE *pWaveData);
 static EAS_RESULT WaveGetMetaData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 *pMediaLength);
 
@@ -423,7 +429,7 @@ static EAS_RESULT WaveResume (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData)
  *
  *----------------------------------------------------------------------------
 */
-static EAS_RESULT WaveSetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value)
+static EAS_RESULT WaveSetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_INTPTR value)
 {
     S_WAVE_STATE *pWaveData = (S_WAVE_STATE*) pInstData;
 
@@ -435,10 +441,14 @@ static EAS_RESULT WaveSetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS
             return EAS_SUCCESS;
 
         case PARSER_DATA_PLAYBACK_RATE:
+            if (pWaveData->streamHandle == NULL)
+                return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
             value = (EAS_I32) (PITCH_CENTS_CONVERSION * log10((double) value / (double) (1 << 28)));
             return EAS_PEUpdatePitch(pEASData, pWaveData->streamHandle, (EAS_I16) value);
 
         case PARSER_DATA_VOLUME:
+            if (pWaveData->streamHandle == NULL)
+                return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
             return EAS_PEUpdateVolume(pEASData, pWaveData->streamHandle, (EAS_I16) value);
 
         default:
@@ -463,7 +473,7 @@ static EAS_RESULT WaveSetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS
  *----------------------------------------------------------------------------
 */
 /*lint -esym(715, pEASData) reserved for future use */
-static EAS_RESULT WaveGetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue)
+static EAS_RESULT WaveGetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_INTPTR *pValue)
 {
     S_WAVE_STATE *pWaveData;
 
@@ -478,7 +488,7 @@ static EAS_RESULT WaveGetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS
 #ifdef MMAPI_SUPPORT
         /* return pointer to 'fmt' chunk */
         case PARSER_DATA_FORMAT:
-            *pValue = (EAS_I32) pWaveData->fmtChunk;
+            *pValue = (EAS_INTPTR) pWaveData->fmtChunk;
             break;
 #endif
 
@@ -522,6 +532,7 @@ static EAS_RESULT WaveParseHeader (S_EAS_DATA *pEASData, EAS_FILE_HANDLE fileHan
     EAS_U16 usTemp;
     EAS_BOOL parseDone;
     EAS_U32 avgBytesPerSec;
+    EAS_I32 length;
 
     /* init some data (and keep lint happy) */
     params.sampleRate = 0;
@@ -571,22 +582,34 @@ static EAS_RESULT WaveParseHeader (S_EAS_DATA *pEASData, EAS_FILE_HANDLE fileHan
     /* find out where we're at */
     if ((result = EAS_HWFilePos(pEASData->hwInstData, fileHandle, &pos)) != EAS_SUCCESS)
         return result;
+    if (fileSize < 12)
+        return EAS_ERROR_UNRECOGNIZED_FORMAT;
     fileSize -= 4;
 
     parseDone = EAS_FALSE;
     for (;;)
     {
-        /* get tag and size for next chunk */
+        /* get tag and size for next chunk, a truncated file ends where its data does */
         if ((result = EAS_HWGetDWord(pEASData->hwInstData, fileHandle, &tag, EAS_TRUE)) != EAS_FALSE)
+        {
+            if (result == EAS_EOF)
+                break;
             return result;
+        }
         if ((result = EAS_HWGetDWord(pEASData->hwInstData, fileHandle, &size, EAS_FALSE)) != EAS_FALSE)
+        {
+            if (result == EAS_EOF)
+                break;
             return result;
+        }
 
         /* process chunk */
         pos += 8;
         switch (tag)
         {
             case CHUNK_FMT:
+                if (size < WAVE_FMT_MIN_SIZE)
+                    return EAS_ERROR_UNRECOGNIZED_FORMAT;
 
 #ifdef MMAPI_SUPPORT
                 if ((result = SaveFmtChunk(pEASData, fileHandle, pWaveData, (EAS_I32) size)) != EAS_SUCCESS)
@@ -620,6 +643,8 @@ static EAS_RESULT WaveParseHeader (S_EAS_DATA *pEASData, EAS_FILE_HANDLE fileHan
                 /* get sample rate */
                 if ((result = EAS_HWGetDWord(pEASData->hwInstData, fileHandle, &params.sampleRate, EAS_FALSE)) != EAS_FALSE)
                     return result;
+                if (params.sampleRate > WAVE_MAX_SAMPLE_RATE)
+                    return EAS_ERROR_UNRECOGNIZED_FORMAT;
 
                 /* get stream rate */
                 if ((result = EAS_HWGetDWord(pEASData->hwInstData, fileHandle, &avgBytesPerSec, EAS_FALSE)) != EAS_FALSE)
@@ -643,10 +668,10 @@ static EAS_RESULT WaveParseHeader (S_EAS_DATA *pEASData, EAS_FILE_HANDLE fileHan
                         return EAS_ERROR_UNRECOGNIZED_FORMAT;
                 }
 
-                /* for IMA ADPCM, we only support mono 4-bit ADPCM */
+                /* for IMA ADPCM, we only support mono 4-bit ADPCM, and a block holds at least its header and one byte */
                 else
                 {
-                    if ((usTemp != 4) || (pWaveData->flags & PCM_FLAGS_STEREO))
+                    if ((usTemp != 4) || (pWaveData->flags & PCM_FLAGS_STEREO) || (params.blockSize <= 4))
                         return EAS_ERROR_UNRECOGNIZED_FORMAT;
                 }
 
@@ -661,13 +686,15 @@ static EAS_RESULT WaveParseHeader (S_EAS_DATA *pEASData, EAS_FILE_HANDLE fileHan
                 }
                 else
                 {
+                    /* a truncated file plays to its end */
+                    if ((result = EAS_HWFileLength(pEASData->hwInstData, fileHandle, &length)) != EAS_SUCCESS)
+                        return result;
+                    if (length < pos)
+                        length = pos;
+                    if (size > (EAS_U32) (length - pos))
+                        size = (EAS_U32) (length - pos);
                     params.size = (EAS_I32) size;
                     params.loopStart = size;
-                    /* use more accurate method if possible */
-                    if (size <= (0x7fffffff / 1000))
-                        pWaveData->mediaLength = (EAS_I32) ((size * 1000) / avgBytesPerSec);
-                    else
-                        pWaveData->mediaLength = (EAS_I32) (size / (avgBytesPerSec / 1000));
                 }
                 break;
 
@@ -675,7 +702,7 @@ static EAS_RESULT WaveParseHeader (S_EAS_DATA *pEASData, EAS_FILE_HANDLE fileHan
                 /* get the list type */
                 if ((result = EAS_HWGetDWord(pEASData->hwInstData, fileHandle, &tag, EAS_TRUE)) != EAS_FALSE)
                     return result;
-                if (tag == CHUNK_INFO)
+                if ((tag == CHUNK_INFO) && (size >= 12))
                 {
                     pWaveData->infoChunkPos = pos + 4;
                     pWaveData->infoChunkSize = (EAS_I32) size - 4;
@@ -692,6 +719,8 @@ static EAS_RESULT WaveParseHeader (S_EAS_DATA *pEASData, EAS_FILE_HANDLE fileHan
             break;
 
         /* subtract header size */
+        if (fileSize < 8)
+            break;
         fileSize -= 8;
 
         /* account for zero-padding on odd length chunks */
@@ -720,6 +749,15 @@ static EAS_RESULT WaveParseHeader (S_EAS_DATA *pEASData, EAS_FILE_HANDLE fileHan
     if ((params.sampleRate == 0) || (params.size == 0))
         return EAS_ERROR_UNRECOGNIZED_FORMAT;
 
+    /* the fmt chunk may follow the data chunk, use more accurate method if possible */
+    if (!(pWaveData->flags & PCM_FLAGS_STREAMING) && (avgBytesPerSec != 0))
+    {
+        if ((EAS_U32) params.size <= (0x7fffffff / 1000))
+            pWaveData->mediaLength = (EAS_I32) (((EAS_U32) params.size * 1000) / avgBytesPerSec);
+        else
+            pWaveData->mediaLength = (EAS_I32) (((EAS_U32) params.size / avgBytesPerSec) * 1000);
+    }
+
     /* save the pertinent information */
     pWaveData->audioOffset = audioOffset;
     params.flags = pWaveData->flags;
@@ -806,7 +844,7 @@ static EAS_RESULT WaveGetMetaData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData,
         }
 
         /* process known metadata */
-        if (metaType != EAS_METADATA_UNKNOWN)
+        if ((metaType != EAS_METADATA_UNKNOWN) && (pWaveData->metadata.callback != NULL) && (pWaveData->metadata.bufferSize > 0))
         {
             metaLen = pWaveData->metadata.bufferSize - 1;
             if (metaLen > (EAS_I32) size)
@@ -821,7 +859,7 @@ static EAS_RESULT WaveGetMetaData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData,
         if (size & 1)
             size++;
         infoSize -= (EAS_I32) size + 8;
-        if (infoSize == 0)
+        if (infoSize < 8)
             break;
         pos += (EAS_I32) size;
     }
@@ -100,7 +100,7 @@ void WT_VoiceGain (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
         android_errorWriteLog(0x534e4554, "26366256");
         return;
     } else if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
-        ALOGE("b/317780080 clip numSamples %ld -> %d", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
+        ALOGE("b/317780080 clip numSamples %ld -> %d", (long) numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
         android_errorWriteLog(0x534e4554, "317780080");
         numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
     }
@@ -201,7 +201,7 @@ void WT_Interpolate (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
         android_errorWriteLog(0x534e4554, "26366256");
         return;
     } else if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
-        ALOGE("b/317780080 clip numSamples %ld -> %d", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
+        ALOGE("b/317780080 clip numSamples %ld -> %d", (long) numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
         android_errorWriteLog(0x534e4554, "317780080");
         numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
     }
@@ -269,7 +269,7 @@ void WT_Interpolate (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
     }
 
     /* save pointer and phase */
-    pWTVoice->phaseAccum = (EAS_U32) pSamples;
+    pWTVoice->phaseAccum = (EAS_UINTPTR) pSamples;
     pWTVoice->phaseFrac = (EAS_U32) phaseFrac;
 }
 #endif
@@ -306,7 +306,7 @@ void WT_InterpolateNoLoop (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
         android_errorWriteLog(0x534e4554, "26366256");
         return;
     } else if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
-        ALOGE("b/317780080 clip numSamples %ld -> %d", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
+        ALOGE("b/317780080 clip numSamples %ld -> %d", (long) numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
         android_errorWriteLog(0x534e4554, "317780080");
         numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
     }
@@ -373,7 +373,7 @@ void WT_InterpolateNoLoop (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
     }
 
     /* save pointer and phase */
-    pWTVoice->phaseAccum = (EAS_U32) pSamples;
+    pWTVoice->phaseAccum = (EAS_UINTPTR) pSamples;
     pWTVoice->phaseFrac = (EAS_U32) phaseFrac;
 }
 #endif
@@ -410,7 +410,7 @@ void WT_VoiceFilter (S_FILTER_CONTROL *pFilter, S_WT_INT_FRAME *pWTIntFrame)
         android_errorWriteLog(0x534e4554, "26366256");
         return;
     } else if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
-        ALOGE("b/317780080 clip numSamples %ld -> %d", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
+        ALOGE("b/317780080 clip numSamples %ld -> %d", (long) numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
         android_errorWriteLog(0x534e4554, "317780080");
         numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
     }
@@ -482,7 +482,7 @@ void WT_VoiceFilter (S_FILTER_CONTROL *pFilter, S_WT_INT_FRAME *pWTIntFrame)
         android_errorWriteLog(0x534e4554, "26366256");
         return;
     } else if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
-        ALOGE("b/317780080 clip numSamples %ld -> %d", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
+        ALOGE("b/317780080 clip numSamples %ld -> %d", (long) numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
         android_errorWriteLog(0x534e4554, "317780080");
         numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
     }
@@ -491,9 +491,9 @@ void WT_VoiceFilter (S_FILTER_CONTROL *pFilter, S_WT_INT_FRAME *pWTIntFrame)
 
     /* get last two samples generated */
     /*lint -e{704} <avoid divide for performance>*/
-    tmp0 = (EAS_I32) (pWTVoice->phaseAccum) >> 18;
+    tmp0 = (EAS_I32) (EAS_U32) (pWTVoice->phaseAccum) >> 18;
     /*lint -e{704} <avoid divide for performance>*/
-    tmp1 = (EAS_I32) (pWTVoice->loopEnd) >> 18;
+    tmp1 = (EAS_I32) (EAS_U32) (pWTVoice->loopEnd) >> 18;
 
     /* generate a buffer of noise */
     while (numSamples--) {
@@ -506,8 +506,9 @@ void WT_VoiceFilter (S_FILTER_CONTROL *pFilter, S_WT_INT_FRAME *pWTIntFrame)
         if (GET_PHASE_INT_PART(pWTVoice->phaseFrac))    {
             tmp0 = tmp1;
             pWTVoice->phaseAccum = pWTVoice->loopEnd;
-            pWTVoice->loopEnd = (5 * pWTVoice->loopEnd + 1);
-            tmp1 = (EAS_I32) (pWTVoice->loopEnd) >> 18;
+            /* the PRNG state is 32 bits regardless of the width of the field */
+            pWTVoice->loopEnd = (EAS_U32) (5 * pWTVoice->loopEnd + 1);
+            tmp1 = (EAS_I32) (EAS_U32) (pWTVoice->loopEnd) >> 18;
             pWTVoice->phaseFrac = GET_PHASE_FRAC_PART(pWTVoice->phaseFrac);
         }
 
@@ -634,7 +635,7 @@ void WT_InterpolateMono (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
         android_errorWriteLog(0x534e4554, "26366256");
         return;
     } else if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
-        ALOGE("b/317780080 clip numSamples %ld -> %d", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
+        ALOGE("b/317780080 clip numSamples %ld -> %d", (long) numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
         android_errorWriteLog(0x534e4554, "317780080");
         numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
     }
@@ -728,3 +729,120 @@ void WT_ProcessVoice (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
 }
 #endif
 
+
+/*----------------------------------------------------------------------------
+ * WT_VoiceInaudible
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Checks whether a voice stays below the cull gain for the whole frame.
+ * The gain ramps linearly from prevGain to gainTarget, so the larger of
+ * the two, scaled by the louder pan gain, is the peak for the frame.
+ *
+ * Inputs:
+ * cullGain         - gain below which the voice is not synthesized,
+ *                    0 to synthesize every voice
+ *
+ * Outputs:
+ * EAS_TRUE if WT_SkipVoice can stand in for WT_ProcessVoice
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_BOOL WT_VoiceInaudible (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame, EAS_I32 cullGain)
+{
+    EAS_I32 gain;
+    EAS_I32 temp;
+
+    /* the noise generator keeps its state in the phase, leave it alone */
+    if ((cullGain == 0) || (pWTVoice->loopStart == WT_NOISE_GENERATOR))
+        return EAS_FALSE;
+
+    gain = pWTIntFrame->prevGain < 0 ? -pWTIntFrame->prevGain : pWTIntFrame->prevGain;
+    temp = pWTIntFrame->frame.gainTarget < 0 ? -pWTIntFrame->frame.gainTarget : pWTIntFrame->frame.gainTarget;
+    if (temp > gain)
+        gain = temp;
+
+#if (NUM_OUTPUT_CHANNELS == 2)
+    temp = pWTVoice->gainLeft > pWTVoice->gainRight ? pWTVoice->gainLeft : pWTVoice->gainRight;
+    gain = MULT_EG1_EG1(gain, temp);
+#endif
+
+    return (EAS_BOOL) (gain < cullGain);
+}
+
+/*----------------------------------------------------------------------------
+ * WT_SkipVoice
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Stands in for WT_ProcessVoice on voices that are too quiet to be heard.
+ * The phase is advanced exactly as the interpolators would advance it, so
+ * the voice picks up in the right place when it becomes audible again,
+ * but nothing is interpolated, filtered or mixed.
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void WT_SkipVoice (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
+{
+    const EAS_SAMPLE *pSamples;
+    const EAS_SAMPLE *loopEnd;
+    EAS_I32 phaseInc;
+    EAS_I32 phaseFrac;
+    EAS_I32 loopLength;
+    EAS_I32 numSamples;
+    EAS_I32 step;
+
+    numSamples = pWTIntFrame->numSamples;
+    if (numSamples <= 0)
+        return;
+    if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES)
+        numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
+
+    loopEnd = (const EAS_SAMPLE*) pWTVoice->loopEnd + 1;
+    pSamples = (const EAS_SAMPLE*) pWTVoice->phaseAccum;
+    /*lint -e{713} truncation is OK */
+    phaseFrac = pWTVoice->phaseFrac & PHASE_FRAC_MASK;
+    phaseInc = pWTIntFrame->frame.phaseIncrement;
+
+    /* looped waves, wrap the whole advance back into the loop at once */
+    if (pWTVoice->loopStart != pWTVoice->loopEnd)
+    {
+        phaseFrac += phaseInc * numSamples;
+        pSamples += phaseFrac >> NUM_PHASE_FRAC_BITS;
+        phaseFrac &= PHASE_FRAC_MASK;
+        if (&pSamples[1] >= loopEnd)
+        {
+            loopLength = (EAS_I32) (loopEnd - (const EAS_SAMPLE*) pWTVoice->loopStart);
+            pSamples -= ((EAS_I32) (&pSamples[1] - loopEnd) / loopLength + 1) * loopLength;
+        }
+    }
+
+    /* unlooped waves, stop short of the end as WT_InterpolateNoLoop does */
+    else if (&pSamples[((phaseFrac + phaseInc * numSamples) >> NUM_PHASE_FRAC_BITS) + 1] < loopEnd)
+    {
+        phaseFrac += phaseInc * numSamples;
+        pSamples += phaseFrac >> NUM_PHASE_FRAC_BITS;
+        phaseFrac &= PHASE_FRAC_MASK;
+    }
+    else
+    {
+        while (numSamples--)
+        {
+            phaseFrac += phaseInc;
+            step = phaseFrac >> NUM_PHASE_FRAC_BITS;
+            if (step > 0)
+            {
+                if (&pSamples[step + 1] >= loopEnd)
+                    break;
+                pSamples += step;
+                phaseFrac &= PHASE_FRAC_MASK;
+            }
+        }
+    }
+
+    /* save pointer and phase */
+    pWTVoice->phaseAccum = (EAS_UINTPTR) pSamples;
+    pWTVoice->phaseFrac = (EAS_U32) phaseFrac;
+}
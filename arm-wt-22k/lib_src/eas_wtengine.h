@@ -124,9 +124,9 @@ typedef enum {
 */
 typedef struct s_wt_voice_tag
 {
-    EAS_U32             loopEnd;                /* points to last PCM sample (not 1 beyond last) */
-    EAS_U32             loopStart;              /* points to first sample at start of loop */
-    EAS_U32             phaseAccum;             /* current sample, integer portion of phase */
+    EAS_UINTPTR         loopEnd;                /* points to last PCM sample (not 1 beyond last) */
+    EAS_UINTPTR         loopStart;              /* points to first sample at start of loop */
+    EAS_UINTPTR         phaseAccum;             /* current sample, integer portion of phase */
     EAS_U32             phaseFrac;              /* fractional portion of phase */
 
 #if (NUM_OUTPUT_CHANNELS == 2)
@@ -162,6 +162,8 @@ typedef struct s_wt_voice_tag
 */
 EAS_BOOL WT_CheckSampleEnd (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame, EAS_BOOL update);
 void WT_ProcessVoice (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
+EAS_BOOL WT_VoiceInaudible (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame, EAS_I32 cullGain);
+void WT_SkipVoice (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
 
 #ifdef EAS_SPLIT_WT_SYNTH
 void WTE_ConfigVoice (EAS_I32 voiceNum, S_WT_CONFIG *pWTConfig, EAS_FRAME_BUFFER_HANDLE pFrameBuffer);
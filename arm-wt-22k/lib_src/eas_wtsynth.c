@@ -396,11 +396,11 @@ static EAS_RESULT WT_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNT
 
 #ifdef EAS_SPLIT_WT_SYNTH
         if (voiceNum < NUM_PRIMARY_VOICES)
-            pWTVoice->phaseAccum = (EAS_U32) pSynth->pEAS->pSamples + pSynth->pEAS->pSampleOffsets[pRegion->waveIndex];
+            pWTVoice->phaseAccum = (EAS_UINTPTR) pSynth->pEAS->pSamples + pSynth->pEAS->pSampleOffsets[pRegion->waveIndex];
         else
             pWTVoice->phaseAccum = pSynth->pEAS->pSampleOffsets[pRegion->waveIndex];
 #else
-        pWTVoice->phaseAccum = (EAS_U32) pSynth->pEAS->pSamples + pSynth->pEAS->pSampleOffsets[pRegion->waveIndex];
+        pWTVoice->phaseAccum = (EAS_UINTPTR) pSynth->pEAS->pSamples + pSynth->pEAS->pSampleOffsets[pRegion->waveIndex];
 #endif
 
         if (pRegion->region.keyGroupAndFlags & REGION_FLAG_IS_LOOPED)
@@ -426,9 +426,9 @@ static EAS_RESULT WT_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNT
     /* configure off-chip voices */
     if (voiceNum >= NUM_PRIMARY_VOICES)
     {
-        wtConfig.phaseAccum = pWTVoice->phaseAccum;
-        wtConfig.loopStart = pWTVoice->loopStart;
-        wtConfig.loopEnd = pWTVoice->loopEnd;
+        wtConfig.phaseAccum = (EAS_U32) pWTVoice->phaseAccum;
+        wtConfig.loopStart = (EAS_U32) pWTVoice->loopStart;
+        wtConfig.loopEnd = (EAS_U32) pWTVoice->loopEnd;
         wtConfig.gain = pVoice->gain;
 
 #if (NUM_OUTPUT_CHANNELS == 2)
@@ -459,7 +459,7 @@ static EAS_RESULT WT_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNT
 */
 EAS_BOOL WT_CheckSampleEnd (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame, EAS_BOOL update)
 {
-    EAS_U32 endPhaseAccum;
+    EAS_UINTPTR endPhaseAccum;
     EAS_U32 endPhaseFrac;
     EAS_I32 numSamples;
     EAS_BOOL done = EAS_FALSE;
@@ -471,7 +471,7 @@ EAS_BOOL WT_CheckSampleEnd (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame, E
     endPhaseAccum = pWTVoice->phaseAccum + GET_PHASE_INT_PART(endPhaseFrac);
 #else //_16_BIT_SAMPLES
     // Multiply by 2 for 16 bit processing module implementation
-    endPhaseAccum = pWTVoice->phaseAccum + (EAS_U32)(endPhaseFrac >> 14);
+    endPhaseAccum = pWTVoice->phaseAccum + (EAS_UINTPTR)(endPhaseFrac >> 14);
 #endif
     if (endPhaseAccum >= pWTVoice->loopEnd)
     {
@@ -488,7 +488,7 @@ EAS_BOOL WT_CheckSampleEnd (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame, E
             pWTIntFrame->numSamples =
                 (numSamples + pWTIntFrame->frame.phaseIncrement - 1) / pWTIntFrame->frame.phaseIncrement;
             if (oldMethod != pWTIntFrame->numSamples) {
-                ALOGE("b/317780080 old %ld new %ld", oldMethod, pWTIntFrame->numSamples);
+                ALOGE("b/317780080 old %ld new %ld", (long) oldMethod, (long) pWTIntFrame->numSamples);
             }
         } else {
             pWTIntFrame->numSamples = numSamples;
@@ -499,7 +499,7 @@ EAS_BOOL WT_CheckSampleEnd (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame, E
             pWTIntFrame->numSamples = 0;
         } else if (pWTIntFrame->numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
             ALOGE("b/317780080 clip numSamples %ld -> %d",
-                  pWTIntFrame->numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
+                  (long) pWTIntFrame->numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
             android_errorWriteLog(0x534e4554, "317780080");
             pWTIntFrame->numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
         }
@@ -587,7 +587,7 @@ static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH
     if (pWTVoice->loopStart == WT_NOISE_GENERATOR) {
         temp = 0;
     } else {
-        temp = pWTVoice->loopEnd - pWTVoice->loopStart;
+        temp = (EAS_I32) (pWTVoice->loopEnd - pWTVoice->loopStart);
     }
 #ifdef _16_BIT_SAMPLES
     temp >>= 1;
@@ -626,7 +626,10 @@ static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH
     else
         WTE_ProcessVoice(voiceNum - NUM_PRIMARY_VOICES, &intFrame.frame, pVoiceMgr->pFrameBuffer);
 #else
-    WT_ProcessVoice(pWTVoice, &intFrame);
+    if (WT_VoiceInaudible(pWTVoice, &intFrame, pVoiceMgr->cullGain))
+        WT_SkipVoice(pWTVoice, &intFrame);
+    else
+        WT_ProcessVoice(pWTVoice, &intFrame);
 #endif
 
     /* clear flag */
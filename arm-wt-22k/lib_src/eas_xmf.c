@@ -64,11 +64,14 @@ static EAS_RESULT XMF_Close (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData);
 static EAS_RESULT XMF_Reset (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData);
 static EAS_RESULT XMF_Pause (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData);
 static EAS_RESULT XMF_Resume (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData);
-static EAS_RESULT XMF_SetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value);
-static EAS_RESULT XMF_GetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue);
+static EAS_RESULT XMF_SetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_INTPTR value);
+static EAS_RESULT XMF_GetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_INTPTR *pValue);
 static EAS_RESULT XMF_FindFileContents (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFData);
 static EAS_RESULT XMF_ReadNode (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFData, EAS_I32 nodeOffset, EAS_I32 endOffset, EAS_I32 *pLength, EAS_I32 depth);
-static EAS_RESULT XMF_ReadVLQ (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle, EAS_U32 *remainingBytes, EAS_I32 *value);
+static EAS_RESULT XMF_ReadVLQ (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFData, EAS_U32 *remainingBytes, EAS_I32 *value);
+static EAS_RESULT XMF_Seek (S_XMF_DATA *pXMFData, EAS_I32 position);
+static EAS_RESULT XMF_GetByte (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFData, EAS_U8 *pValue);
+static EAS_RESULT XMF_GetDWord (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFData, EAS_U32 *pValue);
 
 
 /*----------------------------------------------------------------------------
@@ -87,13 +90,8 @@ const S_FILE_PARSER_INTERFACE EAS_XMF_Parser =
     XMF_State,
     XMF_Close,
     XMF_Reset,
-#ifdef JET_INTERFACE
     XMF_Pause,
     XMF_Resume,
-#else
-    NULL,
-    NULL,
-#endif
     NULL,
     XMF_SetData,
     XMF_GetData,
@@ -199,6 +197,10 @@ static EAS_RESULT XMF_CheckFileType (S_EAS_DATA *pEASData, EAS_FILE_HANDLE fileH
         EAS_HWFree(pEASData->hwInstData, pXMFData);
         return result;
     }
+    if (pXMFData->pSMFData == NULL) {
+        EAS_HWFree(pEASData->hwInstData, pXMFData);
+        return EAS_ERROR_FILE_FORMAT;
+    }
     *ppHandle = pXMFData;
     return EAS_SUCCESS;
 }
@@ -318,7 +320,7 @@ static EAS_RESULT XMF_Event (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I
  *
  *----------------------------------------------------------------------------
 */
-static EAS_RESULT XMF_State (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 *pState)
+static EAS_RESULT XMF_State (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_STATE *pState)
 {
     return SMF_State(pEASData, ((S_XMF_DATA*) pInstData)->pSMFData, pState);
 }
@@ -386,7 +388,6 @@ static EAS_RESULT XMF_Reset (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData)
     return SMF_Reset(pEASData, ((S_XMF_DATA*) pInstData)->pSMFData);
 }
 
-#ifdef JET_INTERFACE
 /*----------------------------------------------------------------------------
  * XMF_Pause()
  *----------------------------------------------------------------------------
@@ -430,7 +431,6 @@ static EAS_RESULT XMF_Resume (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData)
 {
     return SMF_Resume(pEASData, ((S_XMF_DATA*) pInstData)->pSMFData);
 }
-#endif
 
 /*----------------------------------------------------------------------------
  * XMF_SetData()
@@ -450,7 +450,7 @@ static EAS_RESULT XMF_Resume (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData)
  *
  *----------------------------------------------------------------------------
 */
-static EAS_RESULT XMF_SetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value)
+static EAS_RESULT XMF_SetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_INTPTR value)
 {
     return SMF_SetData(pEASData, ((S_XMF_DATA*) pInstData)->pSMFData, param, value);
 }
@@ -473,7 +473,7 @@ static EAS_RESULT XMF_SetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS
  *
  *----------------------------------------------------------------------------
 */
-static EAS_RESULT XMF_GetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue)
+static EAS_RESULT XMF_GetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_INTPTR *pValue)
 {
     EAS_RESULT result;
 
@@ -527,6 +527,17 @@ static EAS_RESULT XMF_FindFileContents (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DAT
     /* initialize offsets */
     pXMFData->dlsOffset = pXMFData->midiOffset = 0;
 
+    /* walk the tree in place if the file is in memory, else read it through a small buffer */
+    if ((result = EAS_HWFilePos(hwInstData, pXMFData->fileHandle, &pXMFData->readPos)) != EAS_SUCCESS)
+        return result;
+    pXMFData->bufferCount = 0;
+    if (EAS_HWMapFile(hwInstData, pXMFData->fileHandle, &pXMFData->pFileData, &pXMFData->fileSize) != EAS_SUCCESS)
+    {
+        pXMFData->pFileData = NULL;
+        if ((result = EAS_HWFileLength(hwInstData, pXMFData->fileHandle, &pXMFData->fileSize)) != EAS_SUCCESS)
+            return result;
+    }
+
     /* read file length. We're arbitrarily limiting the size of this field to
      * 16 bytes, since we don't yet have an actual limit. Once the field is
      * read, we correct remainingBytes using the actual value that we had read.
@@ -538,7 +549,7 @@ static EAS_RESULT XMF_FindFileContents (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DAT
 
     remainingBytes = kInitialRemainingBytes;
     if ((result = XMF_ReadVLQ(hwInstData,
-                              pXMFData->fileHandle,
+                              pXMFData,
                               &remainingBytes,
                               &fileLength)) != EAS_SUCCESS)
         return result;
@@ -547,21 +558,21 @@ static EAS_RESULT XMF_FindFileContents (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DAT
     remainingBytes = fileLength + remainingBytes - kInitialRemainingBytes;
 
     /* read MetaDataTypesTable length and skip over it */
-    if ((result = XMF_ReadVLQ(hwInstData, pXMFData->fileHandle, &remainingBytes, &value)) != EAS_SUCCESS)
+    if ((result = XMF_ReadVLQ(hwInstData, pXMFData, &remainingBytes, &value)) != EAS_SUCCESS)
         return result;
-    if (value > remainingBytes)
+    if ((value < 0) || ((EAS_U32) value > remainingBytes))
         return EAS_ERROR_FILE_FORMAT;
-    if ((result = EAS_HWFileSeekOfs(hwInstData, pXMFData->fileHandle, value)) != EAS_SUCCESS)
+    if ((result = XMF_Seek(pXMFData, pXMFData->readPos + value)) != EAS_SUCCESS)
         return result;
     remainingBytes -= value;
 
     /* get TreeStart and TreeEnd offsets */
-    if ((result = XMF_ReadVLQ(hwInstData, pXMFData->fileHandle, &remainingBytes, &treeStart)) != EAS_SUCCESS)
+    if ((result = XMF_ReadVLQ(hwInstData, pXMFData, &remainingBytes, &treeStart)) != EAS_SUCCESS)
         return result;
     if (treeStart < 0)
         return EAS_ERROR_FILE_FORMAT;
 
-    if ((result = XMF_ReadVLQ(hwInstData, pXMFData->fileHandle, &remainingBytes, &treeEnd)) != EAS_SUCCESS)
+    if ((result = XMF_ReadVLQ(hwInstData, pXMFData, &remainingBytes, &treeEnd)) != EAS_SUCCESS)
         return result;
     if (treeEnd < treeStart || treeEnd >= fileLength)
         return EAS_ERROR_FILE_FORMAT;
@@ -617,11 +628,11 @@ static EAS_RESULT XMF_ReadNode (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFD
     remainingInlineBytes = endOffset - nodeOffset;
 
     /* seek to start of node */
-    if ((result = EAS_HWFileSeek(hwInstData, pXMFData->fileHandle, nodeOffset)) != EAS_SUCCESS)
+    if ((result = XMF_Seek(pXMFData, nodeOffset)) != EAS_SUCCESS)
         return result;
 
     /* get node length */
-    if ((result = XMF_ReadVLQ(hwInstData, pXMFData->fileHandle, &remainingInlineBytes, pLength)) != EAS_SUCCESS)
+    if ((result = XMF_ReadVLQ(hwInstData, pXMFData, &remainingInlineBytes, pLength)) != EAS_SUCCESS)
         return result;
     if ((*pLength < 0) || (*pLength > endOffset - nodeOffset))
         return EAS_ERROR_FILE_FORMAT;
@@ -635,43 +646,41 @@ static EAS_RESULT XMF_ReadNode (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFD
     endOffset = nodeOffset + *pLength;
 
     /* get number of contained items */
-    if ((result = XMF_ReadVLQ(hwInstData, pXMFData->fileHandle, &remainingInlineBytes, &numItems)) != EAS_SUCCESS)
+    if ((result = XMF_ReadVLQ(hwInstData, pXMFData, &remainingInlineBytes, &numItems)) != EAS_SUCCESS)
         return result;
     if (numItems < 0)
         return EAS_ERROR_FILE_FORMAT;
 
     /* get node header length */
-    if ((result = XMF_ReadVLQ(hwInstData, pXMFData->fileHandle, &remainingInlineBytes, &headerLength)) != EAS_SUCCESS)
+    if ((result = XMF_ReadVLQ(hwInstData, pXMFData, &remainingInlineBytes, &headerLength)) != EAS_SUCCESS)
         return result;
     if (headerLength < 0 || headerLength > *pLength)
         return EAS_ERROR_FILE_FORMAT;
 
     /* get metadata length */
-    if ((result = XMF_ReadVLQ(hwInstData, pXMFData->fileHandle, &remainingInlineBytes, &length)) != EAS_SUCCESS)
+    if ((result = XMF_ReadVLQ(hwInstData, pXMFData, &remainingInlineBytes, &length)) != EAS_SUCCESS)
         return result;
     if (length < 0)
         return EAS_ERROR_FILE_FORMAT;
 
     /* get the current location */
-    if ((result = EAS_HWFilePos(hwInstData, pXMFData->fileHandle, &offset)) != EAS_SUCCESS)
-        return result;
+    offset = pXMFData->readPos;
 
     /* check that we didn't go past the header. */
     if (offset - nodeOffset > headerLength)
         return EAS_FAILURE;
 
     /* skip to node contents */
-    if ((result = EAS_HWFileSeek(hwInstData, pXMFData->fileHandle, nodeOffset + headerLength)) != EAS_SUCCESS)
+    if ((result = XMF_Seek(pXMFData, nodeOffset + headerLength)) != EAS_SUCCESS)
         return result;
     remainingInlineBytes = endOffset - (nodeOffset + headerLength);
 
     /* get reference type */
-    if ((result = XMF_ReadVLQ(hwInstData, pXMFData->fileHandle, &remainingInlineBytes, &refType)) != EAS_SUCCESS)
+    if ((result = XMF_ReadVLQ(hwInstData, pXMFData, &remainingInlineBytes, &refType)) != EAS_SUCCESS)
         return result;
 
     /* get the current location */
-    if ((result = EAS_HWFilePos(hwInstData, pXMFData->fileHandle, &offset)) != EAS_SUCCESS)
-        return result;
+    offset = pXMFData->readPos;
 
     /* process file node */
     if (numItems == 0)
@@ -680,10 +689,10 @@ static EAS_RESULT XMF_ReadNode (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFD
         /* if in-file resource, find out where it is and jump to it */
         if (refType == 2)
         {
-            if ((result = XMF_ReadVLQ(hwInstData, pXMFData->fileHandle, &remainingInlineBytes, &offset)) != EAS_SUCCESS)
+            if ((result = XMF_ReadVLQ(hwInstData, pXMFData, &remainingInlineBytes, &offset)) != EAS_SUCCESS)
                 return result;
             offset += pXMFData->fileOffset;
-            if ((result = EAS_HWFileSeek(hwInstData, pXMFData->fileHandle, offset)) != EAS_SUCCESS)
+            if ((result = XMF_Seek(pXMFData, offset)) != EAS_SUCCESS)
                 return result;
         }
 
@@ -697,18 +706,18 @@ static EAS_RESULT XMF_ReadNode (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFD
         /* at this point we stop enforcing reading past the node. */
 
         /* get the chunk type */
-        if ((result = EAS_HWGetDWord(hwInstData, pXMFData->fileHandle, &chunkType, EAS_TRUE)) != EAS_SUCCESS)
+        if ((result = XMF_GetDWord(hwInstData, pXMFData, &chunkType)) != EAS_SUCCESS)
             return result;
 
         /* found a RIFF chunk, check for DLS type */
         if (chunkType == XMF_RIFF_CHUNK)
         {
             /* skip length */
-            if ((result = EAS_HWFileSeekOfs(hwInstData, pXMFData->fileHandle, 4)) != EAS_SUCCESS)
+            if ((result = XMF_Seek(pXMFData, pXMFData->readPos + 4)) != EAS_SUCCESS)
                 return result;
 
             /* get RIFF file type */
-            if ((result = EAS_HWGetDWord(hwInstData, pXMFData->fileHandle, &chunkType, EAS_TRUE)) != EAS_SUCCESS)
+            if ((result = XMF_GetDWord(hwInstData, pXMFData, &chunkType)) != EAS_SUCCESS)
                 return result;
             if (chunkType == XMF_RIFF_DLS)
                 pXMFData->dlsOffset = offset;
@@ -730,7 +739,7 @@ static EAS_RESULT XMF_ReadNode (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFD
 
             /* seek to start of next item */
             offset += length;
-            if ((result = EAS_HWFileSeek(hwInstData, pXMFData->fileHandle, offset)) != EAS_SUCCESS)
+            if ((result = XMF_Seek(pXMFData, offset)) != EAS_SUCCESS)
                 return result;
         }
     }
@@ -899,11 +908,12 @@ static EAS_RESULT XMF_FindFileContents(S_EAS_DATA *pEASData, S_XMF_DATA *pXMFDat
  * XMF_ReadVLQ()
  *----------------------------------------------------------------------------
  * Purpose:
- * Reads a VLQ encoded value from the file referenced by fileHandle
+ * Reads a VLQ encoded value from the XMF file
  *
  * Inputs:
- * pEASData         - pointer to overall EAS data structure
- * fileHandle       - pointer to file handle
+ * hwInstData       - HW instance data
+ * pXMFData         - pointer to XMF parser instance data
+ * remainingBytes   - number of bytes the value may occupy, updated on return
  *
  * Outputs:
  * value            - pointer to the value decoded from the VLQ data
@@ -913,7 +923,7 @@ static EAS_RESULT XMF_FindFileContents(S_EAS_DATA *pEASData, S_XMF_DATA *pXMFDat
  *
  *----------------------------------------------------------------------------
 */
-static EAS_RESULT XMF_ReadVLQ (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle, EAS_U32 *remainingBytes, EAS_I32 *value)
+static EAS_RESULT XMF_ReadVLQ (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFData, EAS_U32 *remainingBytes, EAS_I32 *value)
 {
     EAS_RESULT result;
     EAS_U8 c;
@@ -922,7 +932,7 @@ static EAS_RESULT XMF_ReadVLQ (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fi
     if ((*remainingBytes)-- == 0)
         return EAS_ERROR_FILE_FORMAT;
 
-    if ((result = EAS_HWGetByte(hwInstData, fileHandle, &c)) != EAS_SUCCESS)
+    if ((result = XMF_GetByte(hwInstData, pXMFData, &c)) != EAS_SUCCESS)
         return result;
 
     while (c > 0x7F)
@@ -933,7 +943,7 @@ static EAS_RESULT XMF_ReadVLQ (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fi
         if ((*remainingBytes)-- == 0)
             return EAS_ERROR_FILE_FORMAT;
 
-        if ((result = EAS_HWGetByte(hwInstData, fileHandle, &c)) != EAS_SUCCESS)
+        if ((result = XMF_GetByte(hwInstData, pXMFData, &c)) != EAS_SUCCESS)
             return result;
     }
 
@@ -943,3 +953,119 @@ static EAS_RESULT XMF_ReadVLQ (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fi
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * XMF_Seek()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Moves the read position of the tree walk. The file itself is not touched
+ * until the next read misses the buffer.
+ *
+ * Inputs:
+ * pXMFData         - pointer to XMF parser instance data
+ * position         - new read position
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT XMF_Seek (S_XMF_DATA *pXMFData, EAS_I32 position)
+{
+    if ((position < 0) || (position > pXMFData->fileSize))
+        return EAS_ERROR_FILE_SEEK;
+    pXMFData->readPos = position;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * XMF_GetByte()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reads a byte at the read position, straight from memory if the file is
+ * mapped, else from the read-ahead buffer, refilling it on a miss
+ *
+ * Inputs:
+ * hwInstData       - HW instance data
+ * pXMFData         - pointer to XMF parser instance data
+ *
+ * Outputs:
+ * pValue           - pointer to the byte read
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT XMF_GetByte (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFData, EAS_U8 *pValue)
+{
+    EAS_RESULT result;
+    EAS_I32 count;
+    EAS_I32 index;
+
+    if (pXMFData->readPos >= pXMFData->fileSize)
+        return EAS_EOF;
+
+    if (pXMFData->pFileData)
+    {
+        *pValue = pXMFData->pFileData[pXMFData->readPos++];
+        return EAS_SUCCESS;
+    }
+
+    /* refill the buffer if the read position is outside it */
+    index = pXMFData->readPos - pXMFData->bufferPos;
+    if ((index < 0) || (index >= pXMFData->bufferCount))
+    {
+        pXMFData->bufferCount = 0;
+        if ((result = EAS_HWFileSeek(hwInstData, pXMFData->fileHandle, pXMFData->readPos)) != EAS_SUCCESS)
+            return result;
+        count = pXMFData->fileSize - pXMFData->readPos;
+        if (count > XMF_READ_BUFFER_SIZE)
+            count = XMF_READ_BUFFER_SIZE;
+        if ((result = EAS_HWReadFile(hwInstData, pXMFData->fileHandle, pXMFData->readBuffer, count, &count)) != EAS_SUCCESS)
+            return result;
+        pXMFData->bufferPos = pXMFData->readPos;
+        pXMFData->bufferCount = count;
+        index = 0;
+    }
+
+    *pValue = pXMFData->readBuffer[index];
+    pXMFData->readPos++;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * XMF_GetDWord()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reads a big-endian 32-bit value at the read position
+ *
+ * Inputs:
+ * hwInstData       - HW instance data
+ * pXMFData         - pointer to XMF parser instance data
+ *
+ * Outputs:
+ * pValue           - pointer to the value read
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT XMF_GetDWord (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFData, EAS_U32 *pValue)
+{
+    EAS_RESULT result;
+    EAS_U8 c;
+    EAS_INT i;
+
+    *pValue = 0;
+    for (i = 0; i < 4; i++)
+    {
+        if ((result = XMF_GetByte(hwInstData, pXMFData, &c)) != EAS_SUCCESS)
+            return result;
+        *pValue = (*pValue << 8) | c;
+    }
+    return EAS_SUCCESS;
+}
+
@@ -34,6 +34,11 @@
 #define MAX_XMF_STREAMS             16
 #endif
 
+/* size of the read-ahead buffer used while walking the XMF tree */
+#ifndef XMF_READ_BUFFER_SIZE
+#define XMF_READ_BUFFER_SIZE        64
+#endif
+
 /* offsets in to the XMF file */
 #define XMF_OFS_HEADER_SIZE         4
 #define XMF_OFS_FILE_TYPE           8
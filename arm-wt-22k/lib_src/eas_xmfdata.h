@@ -32,6 +32,7 @@
 #define _EAS_XMFDATA_H
 
 #include "eas_data.h"
+#include "eas_xmf.h"
 
 /*----------------------------------------------------------------------------
  *
@@ -50,6 +51,14 @@ typedef struct
     EAS_I32             midiOffset;
     EAS_I32             dlsOffset;
     S_DLS               *pDLS;
+
+    /* file reader for the tree walk, reads in place if the file is mapped */
+    const EAS_U8        *pFileData;
+    EAS_I32             fileSize;
+    EAS_I32             readPos;
+    EAS_I32             bufferPos;
+    EAS_I32             bufferCount;
+    EAS_U8              readBuffer[XMF_READ_BUFFER_SIZE];
 } S_XMF_DATA;
 
 #endif
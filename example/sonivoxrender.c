@@ -33,6 +33,7 @@ EAS_I32 reverb_wet = 32767;
 EAS_I32 reverb_dry = 0;
 EAS_I32 chorus_type = 0;
 EAS_I32 chorus_level = 32767;
+EAS_I32 trim_level = 0;
 EAS_DATA_HANDLE mEASDataHandle = NULL;
 
 int Read(void *handle, void *buf, int offset, int size) {
@@ -53,6 +54,16 @@ int Size(void *handle) {
     return ftell((FILE *) handle);
 }
 
+int ReadStream(void *handle, void *buf, int size) {
+    int ret;
+
+    do {
+        ret = read(fileno((FILE *) handle), buf, size);
+    } while (ret < 0 && errno == EINTR);
+
+    return ret;
+}
+
 void shutdownLibrary(void)
 {
     if (mEASDataHandle) {
@@ -69,6 +80,7 @@ int initializeLibrary(void)
 
 #ifdef __WIN32__
 	setmode(fileno(stdout), O_BINARY);
+	setmode(fileno(stdin), O_BINARY);
 #endif
 
     EAS_RESULT result = EAS_Init(&mEASDataHandle);
@@ -173,6 +185,15 @@ int initializeLibrary(void)
         goto cleanup;
     }
 
+    if (trim_level > 0) {
+        result = EAS_SetOfflineMode(mEASDataHandle, EAS_TRUE, trim_level);
+        if (result != EAS_SUCCESS) {
+            fprintf(stderr, "Failed to set offline mode");
+            ok = EXIT_FAILURE;
+            goto cleanup;
+        }
+    }
+
     return ok;
 
 cleanup:
@@ -185,23 +206,39 @@ int renderFile(const char *fileName)
 {
     EAS_HANDLE mEASStreamHandle = NULL;
     EAS_FILE mEasFile;
+    EAS_FILE_LOCATOR mLocator = NULL;
+    EAS_FILE_LOCATOR mStreamLocator = NULL;
     EAS_PCM *mAudioBuffer = NULL;
     EAS_I32 mPCMBufferSize = 0;
     const S_EAS_LIB_CONFIG *mEASConfig;
+    EAS_RESULT result;
 
     int ok = EXIT_SUCCESS;
 
-    mEasFile.handle = fopen(fileName, "rb");
-    if (mEasFile.handle == NULL) {
-        fprintf(stderr, "Failed to open %s. error: %s\n", fileName, strerror(errno));
-        ok = EXIT_FAILURE;
-        return ok;
-    }
+    mEasFile.handle = NULL;
+    if (strcmp(fileName, "-") == 0) {
+        /* standard input may be a pipe, read it as it arrives */
+        result = EAS_OpenStreamLocator(mEASDataHandle, stdin, ReadStream, &mStreamLocator);
+        if (result != EAS_SUCCESS) {
+            fprintf(stderr, "Failed to open the standard input\n");
+            ok = EXIT_FAILURE;
+            return ok;
+        }
+        mLocator = mStreamLocator;
+    } else {
+        mEasFile.handle = fopen(fileName, "rb");
+        if (mEasFile.handle == NULL) {
+            fprintf(stderr, "Failed to open %s. error: %s\n", fileName, strerror(errno));
+            ok = EXIT_FAILURE;
+            return ok;
+        }
 
-    mEasFile.readAt = Read;
-    mEasFile.size = Size;
+        mEasFile.readAt = Read;
+        mEasFile.size = Size;
+        mLocator = &mEasFile;
+    }
 
-    EAS_RESULT result = EAS_OpenFile(mEASDataHandle, &mEasFile, &mEASStreamHandle);
+    result = EAS_OpenFile(mEASDataHandle, mLocator, &mEASStreamHandle);
     if (result != EAS_SUCCESS) {
         fprintf(stderr, "Failed to open file\n");
         ok = EXIT_FAILURE;
@@ -221,18 +258,21 @@ int renderFile(const char *fileName)
         goto cleanup;
     }
 
-	EAS_I32 playLength = 0;
-	result = EAS_ParseMetaData(mEASDataHandle, mEASStreamHandle, &playLength);
-	if (result != EAS_SUCCESS) {
-        fprintf(stderr, "Failed to parse MIDI file metadata\n");
-        ok = EXIT_FAILURE;
-        goto cleanup;
-    }
-
-	if (playLength == 0) {
-		fprintf(stderr, "MIDI file time length returned 0\n");
-        ok = EXIT_FAILURE;
-        goto cleanup;
+	/* parsing the metadata would wait for the whole stream to arrive */
+	if (mStreamLocator == NULL) {
+		EAS_I32 playLength = 0;
+		result = EAS_ParseMetaData(mEASDataHandle, mEASStreamHandle, &playLength);
+		if (result != EAS_SUCCESS) {
+			fprintf(stderr, "Failed to parse MIDI file metadata\n");
+			ok = EXIT_FAILURE;
+			goto cleanup;
+		}
+
+		if (playLength == 0) {
+			fprintf(stderr, "MIDI file time length returned 0\n");
+			ok = EXIT_FAILURE;
+			goto cleanup;
+		}
 	}
 
     mEASConfig = EAS_Config();
@@ -245,7 +285,7 @@ int renderFile(const char *fileName)
     mPCMBufferSize = sizeof(EAS_PCM) * mEASConfig->mixBufferSize * mEASConfig->numChannels;
     mAudioBuffer = alloca(mPCMBufferSize);
     if (mAudioBuffer == NULL) {
-        fprintf(stderr, "Failed to allocate memory of size: %ld", mPCMBufferSize);
+        fprintf(stderr, "Failed to allocate memory of size: %ld", (long) mPCMBufferSize);
         ok = EXIT_FAILURE;
         goto cleanup;
     }
@@ -273,7 +313,7 @@ int renderFile(const char *fileName)
         }
 
         if (count != mEASConfig->mixBufferSize) {
-            fprintf(stderr, "Only %ld out of %ld frames rendered\n", count, mEASConfig->mixBufferSize);
+            fprintf(stderr, "Only %ld out of %ld frames rendered\n", (long) count, (long) mEASConfig->mixBufferSize);
             ok = EXIT_FAILURE;
             break;
         }
@@ -294,6 +334,9 @@ cleanup:
     if (mEasFile.handle != NULL) {
         fclose(mEasFile.handle);
     }
+    if (mStreamLocator != NULL) {
+        EAS_CloseStreamLocator(mEASDataHandle, mStreamLocator);
+    }
     return ok;
 }
 
@@ -304,12 +347,12 @@ int main (int argc, char **argv)
 
     opterr = 0;
 
-    while ((c = getopt (argc, argv, "hd:r:w:n:c:l:v:")) != -1) {
+    while ((c = getopt (argc, argv, "hd:r:w:n:c:l:v:t:")) != -1) {
         switch (c)
         {
         case 'h':
-            fprintf (stderr, "Usage: %s [-h] [-d file.dls] [-r 0..4] [-w 0..32767] [-n 0..32767] [-c 0..4] [-l 0..32767] [-v 0..100] file.mid ...\n"\
-                        "Render standard MIDI files into raw PCM audio.\n"\
+            fprintf (stderr, "Usage: %s [-h] [-d file.dls] [-r 0..4] [-w 0..32767] [-n 0..32767] [-c 0..4] [-l 0..32767] [-v 0..100] [-t 0..96] file.mid ...\n"\
+                        "Render standard MIDI files into raw PCM audio. Use - as file name to read from the standard input.\n"\
                         "Options:\n"\
                         "\t-h\t\tthis help message.\n"\
                         "\t-d file.dls\tDLS soundfont.\n"\
@@ -319,6 +362,7 @@ int main (int argc, char **argv)
                         "\t-c n\t\tchorus preset: 0=no, 1..4=presets.\n"
                         "\t-l n\t\tchorus level: 0..32767.\n"
                         "\t-v n\t\tmaster volume: 0..100.\n"
+                        "\t-t n\t\ttrim leading silence and tails below -n dB: 0=no, 1..96.\n"
                         , argv[0]);
             return EXIT_FAILURE;
         case 'd':
@@ -327,42 +371,49 @@ int main (int argc, char **argv)
         case 'r':
             reverb_type = atoi(optarg);
             if (reverb_type < 0 || reverb_type > 4) {
-                fprintf (stderr, "invalid reverb preset: %ld\n", reverb_type);
+                fprintf (stderr, "invalid reverb preset: %ld\n", (long) reverb_type);
                 return EXIT_FAILURE;
             }
             break;
         case 'w':
             reverb_wet = atoi(optarg);
             if (reverb_wet < 0 || reverb_wet > 32767) {
-                fprintf (stderr, "invalid reverb wet: %ld\n", reverb_wet);
+                fprintf (stderr, "invalid reverb wet: %ld\n", (long) reverb_wet);
                 return EXIT_FAILURE;
             }
             break;
         case 'n':
             reverb_dry = atoi(optarg);
             if (reverb_dry < 0 || reverb_dry > 32767) {
-                fprintf (stderr, "invalid reverb dry: %ld\n", reverb_dry);
+                fprintf (stderr, "invalid reverb dry: %ld\n", (long) reverb_dry);
                 return EXIT_FAILURE;
             }
             break;
         case 'c':
             chorus_type = atoi(optarg);
             if (chorus_type < 0 || chorus_type > 4) {
-                fprintf (stderr, "invalid chorus preset: %ld\n", chorus_type);
+                fprintf (stderr, "invalid chorus preset: %ld\n", (long) chorus_type);
                 return EXIT_FAILURE;
             }
             break;
         case 'l':
             chorus_level = atoi(optarg);
             if (chorus_level < 0 || chorus_level > 32767) {
-                fprintf (stderr, "invalid chorus level: %ld\n", chorus_level);
+                fprintf (stderr, "invalid chorus level: %ld\n", (long) chorus_level);
                 return EXIT_FAILURE;
             }
             break;
         case 'v':
             playback_gain = atoi(optarg);
             if (playback_gain < 0 || playback_gain > 100) {
-                fprintf (stderr, "invalid playback gain: %ld\n", playback_gain);
+                fprintf (stderr, "invalid playback gain: %ld\n", (long) playback_gain);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 't':
+            trim_level = atoi(optarg);
+            if (trim_level < 0 || trim_level > EAS_OFFLINE_TAIL_LEVEL_MAX) {
+                fprintf (stderr, "invalid trim level: %ld\n", (long) trim_level);
                 return EXIT_FAILURE;
             }
             break;
@@ -20,9 +20,15 @@
 
 #include <fcntl.h>
 #include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <fstream>
+#include <functional>
+#include <thread>
 
 #include <libsonivox/eas.h>
+#include <libsonivox/eas_chorus.h>
 #include <libsonivox/eas_reverb.h>
 
 #include "SonivoxTestEnvironment.h"
@@ -31,6 +37,9 @@
 static constexpr uint32_t kNumBuffersToCombine = 4;
 static constexpr uint32_t kSeekBeyondPlayTimeOffsetMs = 10;
 
+// the Mobile XMF file of the library's test vectors, relative to the test resources
+static constexpr const char *kMobileXMFFile = "../../arm-wt-22k/vectors/Leadsol.mxmf";
+
 #ifdef _SAMPLE_RATE_44100
 static constexpr uint32_t sampleRate = 44100;
 #else
@@ -225,7 +234,7 @@ bool SonivoxTest::renderAudio() {
         return false;
     }
     if (count != mEASConfig->mixBufferSize) {
-        ALOGE("%ld of %ld bytes rendered", count, mEASConfig->mixBufferSize);
+        ALOGE("%ld of %ld bytes rendered", (long) count, (long) mEASConfig->mixBufferSize);
         return false;
     }
 
@@ -276,7 +285,7 @@ TEST_P(SonivoxTest, DecodeTest) {
         result = EAS_GetLocation(mEASDataHandle, mEASStreamHandle, &locationMs);
         ASSERT_EQ(result, EAS_SUCCESS) << "Failed to get the current location in ms";
 
-        if (locationMs >= mAudioplayTimeMs) {
+        if (locationMs >= (EAS_I32) mAudioplayTimeMs) {
             ASSERT_NE(state, EAS_STATE_STOPPED)
                     << "Invalid state reached when rendering is complete";
 
@@ -366,7 +375,1713 @@ INSTANTIATE_TEST_SUITE_P(SonivoxTestAll,
                                            make_tuple("midi_cs.mid", 2000, 2, sampleRate),
                                            make_tuple("midi_gs.mid", 2000, 2, sampleRate),
                                            make_tuple("ants.mid", 17233, 2, sampleRate)));
-                                        // make_tuple("testmxmf.mxmf", 29095, 2, sampleRate)));
+
+#ifdef _XMF_PARSER
+INSTANTIATE_TEST_SUITE_P(SonivoxTestXMF,
+                         SonivoxTest,
+                         ::testing::Values(make_tuple(kMobileXMFFile, 29095, 2, sampleRate)));
+#endif
+
+class SonivoxMIDIStreamTest : public ::testing::Test {
+  public:
+      SonivoxMIDIStreamTest()
+          : mEASDataHandle(nullptr)
+          , mMIDIStreamHandle(nullptr)
+          , mEASConfig(nullptr)
+      {}
+
+      virtual void SetUp() override
+      {
+          EAS_RESULT result = EAS_Init(&mEASDataHandle);
+          ASSERT_EQ(result, EAS_SUCCESS) << "Failed to initialize synthesizer library";
+
+          result = EAS_OpenMIDIStream(mEASDataHandle, &mMIDIStreamHandle, nullptr);
+          ASSERT_EQ(result, EAS_SUCCESS) << "Failed to open MIDI stream";
+
+          mEASConfig = EAS_Config();
+          ASSERT_NE(mEASConfig, nullptr) << "Failed to configure the library";
+
+          mAudioBuffer.resize(mEASConfig->mixBufferSize * mEASConfig->numChannels);
+      }
+
+      virtual void TearDown() override
+      {
+          EAS_RESULT result;
+          if (mEASDataHandle) {
+              if (mMIDIStreamHandle) {
+                  result = EAS_CloseMIDIStream(mEASDataHandle, mMIDIStreamHandle);
+                  ASSERT_EQ(result, EAS_SUCCESS) << "Failed to close MIDI stream";
+              }
+              result = EAS_Shutdown(mEASDataHandle);
+              ASSERT_EQ(result, EAS_SUCCESS)
+                  << "Failed to deallocate the resources for synthesizer library";
+          }
+      }
+
+    // renders the given number of buffers, returns the peak sample magnitude or -1 on failure
+    int renderPeak(int numBuffers);
+
+    EAS_DATA_HANDLE mEASDataHandle;
+    EAS_HANDLE mMIDIStreamHandle;
+    const S_EAS_LIB_CONFIG *mEASConfig;
+    vector<EAS_PCM> mAudioBuffer;
+};
+
+int SonivoxMIDIStreamTest::renderPeak(int numBuffers) {
+    int peak = 0;
+    for (int i = 0; i < numBuffers; i++) {
+        EAS_I32 count = -1;
+        EAS_RESULT result = EAS_Render(mEASDataHandle, mAudioBuffer.data(),
+                                       mEASConfig->mixBufferSize, &count);
+        if (result != EAS_SUCCESS || count != mEASConfig->mixBufferSize) return -1;
+        for (EAS_PCM sample : mAudioBuffer) peak = max(peak, abs((int)sample));
+    }
+    return peak;
+}
+
+TEST_F(SonivoxMIDIStreamTest, QueueMIDIStreamTest) {
+    EAS_U8 noteOn[] = {0x90, 60, 100};
+    EAS_U8 noteOff[] = {0x80, 60, 0};
+
+    ASSERT_EQ(renderPeak(4), 0) << "Expected silence before any MIDI data";
+
+    EAS_RESULT result = EAS_QueueVolume(mEASDataHandle, nullptr, 100);
+    ASSERT_EQ(result, EAS_SUCCESS) << "Failed to queue master volume";
+
+    result = EAS_QueueMIDIStream(mEASDataHandle, mMIDIStreamHandle, noteOn, sizeof(noteOn));
+    ASSERT_EQ(result, EAS_SUCCESS) << "Failed to queue note on";
+
+    ASSERT_GT(renderPeak(8), 0) << "Queued note on was not rendered";
+    ASSERT_EQ(EAS_GetVolume(mEASDataHandle, nullptr), 100) << "Queued volume was not applied";
+
+    result = EAS_QueueMIDIStream(mEASDataHandle, mMIDIStreamHandle, noteOff, sizeof(noteOff));
+    ASSERT_EQ(result, EAS_SUCCESS) << "Failed to queue note off";
+
+    // fill the queue, it must report full rather than drop data
+    int numQueued = 0;
+    while (EAS_QueueMIDIStream(mEASDataHandle, mMIDIStreamHandle, noteOff, sizeof(noteOff))
+           == EAS_SUCCESS)
+        numQueued++;
+    ASSERT_GT(numQueued, 0) << "MIDI queue has no capacity";
+    ASSERT_EQ(EAS_QueueMIDIStream(mEASDataHandle, mMIDIStreamHandle, noteOff, INT32_MAX), EAS_ERROR_PARAMETER_RANGE)
+            << "Data larger than the queue accepted";
+
+    // rendering drains the queue
+    ASSERT_GE(renderPeak(1), 0) << "Failed to render audio";
+    result = EAS_QueueMIDIStream(mEASDataHandle, mMIDIStreamHandle, noteOff, sizeof(noteOff));
+    ASSERT_EQ(result, EAS_SUCCESS) << "MIDI queue was not drained by EAS_Render";
+}
+
+TEST_F(SonivoxMIDIStreamTest, QueueForReopenedStreamTest) {
+    EAS_U8 noteOn[] = {0x90, 60, 100};
+
+    // the note was queued for the stream that is closed, not for the one that reuses its handle
+    EAS_HANDLE closed = mMIDIStreamHandle, stream = nullptr;
+    ASSERT_EQ(EAS_QueueMIDIStream(mEASDataHandle, mMIDIStreamHandle, noteOn, sizeof(noteOn)),
+              EAS_SUCCESS) << "Failed to queue note on";
+    ASSERT_EQ(EAS_CloseMIDIStream(mEASDataHandle, mMIDIStreamHandle), EAS_SUCCESS)
+            << "Failed to close MIDI stream";
+    mMIDIStreamHandle = nullptr;
+    ASSERT_EQ(EAS_OpenMIDIStream(mEASDataHandle, &stream, nullptr), EAS_SUCCESS)
+            << "Failed to open MIDI stream";
+    mMIDIStreamHandle = stream;
+    ASSERT_EQ(stream, closed) << "New stream did not reuse the handle";
+    ASSERT_EQ(renderPeak(8), 0) << "Note queued for the closed stream was rendered";
+
+    // the new stream still plays what is queued for it
+    ASSERT_EQ(EAS_QueueMIDIStream(mEASDataHandle, stream, noteOn, sizeof(noteOn)), EAS_SUCCESS)
+            << "Failed to queue note on";
+    ASSERT_GT(renderPeak(8), 0) << "Queued note on was not rendered";
+}
+
+TEST_F(SonivoxMIDIStreamTest, QueueFromControlThreadTest) {
+    static constexpr int kNumNotes = 2000;
+    std::atomic<int> numQueued(0);
+
+    std::thread producer([&]() {
+        for (int i = 0; i < kNumNotes; i++) {
+            EAS_U8 msgs[] = {0x90, (EAS_U8)(36 + i % 48), 100, 0x80, (EAS_U8)(36 + i % 48), 0};
+            while (EAS_QueueMIDIStream(mEASDataHandle, mMIDIStreamHandle, msgs, sizeof(msgs))
+                   == EAS_ERROR_QUEUE_IS_FULL)
+                std::this_thread::yield();
+            if (i % 100 == 0)
+                while (EAS_QueueParameter(mEASDataHandle, EAS_MODULE_REVERB,
+                                          EAS_PARAM_REVERB_BYPASS, i % 200 == 0)
+                       == EAS_ERROR_QUEUE_IS_FULL)
+                    std::this_thread::yield();
+            numQueued++;
+        }
+    });
+
+    // the render thread keeps going while the producer fills the queue
+    while (numQueued < kNumNotes)
+        ASSERT_GE(renderPeak(1), 0) << "Failed to render audio";
+    producer.join();
+    ASSERT_GE(renderPeak(1), 0) << "Failed to render audio";
+    ASSERT_EQ(numQueued, kNumNotes);
+}
+
+TEST_F(SonivoxMIDIStreamTest, WriteMIDIMessagesTest) {
+    // program change, controller, pitch bend, note on/off with the same content both ways
+    const EAS_U8 bytes[] = {0xC0, 19, 0xB0, 7, 90, 0xE0, 0, 72, 0x90, 60, 100, 64, 90, 67, 80};
+    const uint32_t msgs[] = {0x00C01300, 0x00B0075A, 0x00E00048,
+                             0x00903C64, 0x2090405A, 0x00904350};
+    const EAS_U8 noteOffBytes[] = {0x80, 60, 0, 64, 0, 67, 0};
+    const uint32_t noteOffMsgs[] = {0x00803C00, 0x00804000, 0x00804300};
+
+    EAS_DATA_HANDLE easData = nullptr;
+    EAS_HANDLE midiStream = nullptr;
+    ASSERT_EQ(EAS_Init(&easData), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    ASSERT_EQ(EAS_OpenMIDIStream(easData, &midiStream, nullptr), EAS_SUCCESS)
+            << "Failed to open MIDI stream";
+
+    EAS_RESULT result = EAS_WriteMIDIStream(mEASDataHandle, mMIDIStreamHandle,
+                                            (EAS_U8 *)bytes, sizeof(bytes));
+    ASSERT_EQ(result, EAS_SUCCESS) << "Failed to write MIDI bytes";
+    result = EAS_WriteMIDIMessages(easData, midiStream, msgs, sizeof(msgs) / sizeof(msgs[0]));
+    ASSERT_EQ(result, EAS_SUCCESS) << "Failed to write MIDI messages";
+
+    vector<EAS_PCM> audio(mAudioBuffer.size());
+    for (int i = 0; i < 64; i++) {
+        if (i == 32) {
+            result = EAS_WriteMIDIStream(mEASDataHandle, mMIDIStreamHandle,
+                                         (EAS_U8 *)noteOffBytes, sizeof(noteOffBytes));
+            ASSERT_EQ(result, EAS_SUCCESS) << "Failed to write MIDI bytes";
+            result = EAS_WriteMIDIMessages(easData, midiStream, noteOffMsgs,
+                                           sizeof(noteOffMsgs) / sizeof(noteOffMsgs[0]));
+            ASSERT_EQ(result, EAS_SUCCESS) << "Failed to write MIDI messages";
+        }
+        EAS_I32 count;
+        ASSERT_GE(renderPeak(1), 0) << "Failed to render audio";
+        result = EAS_Render(easData, audio.data(), mEASConfig->mixBufferSize, &count);
+        ASSERT_EQ(result, EAS_SUCCESS) << "Failed to render audio";
+        ASSERT_EQ(audio, mAudioBuffer) << "Packed messages rendered differently at buffer " << i;
+    }
+
+    EAS_CloseMIDIStream(easData, midiStream);
+    EAS_Shutdown(easData);
+}
+
+struct MemorySource {
+    vector<char> data;
+    size_t pos;
+};
+
+static int memReadAt(void *handle, void *buf, int offset, int size) {
+    MemorySource *src = (MemorySource *)handle;
+    if (offset >= (int)src->data.size()) return 0;
+    size = min(size, (int)src->data.size() - offset);
+    memcpy(buf, src->data.data() + offset, size);
+    return size;
+}
+
+static int memSize(void *handle) {
+    return ((MemorySource *)handle)->data.size();
+}
+
+// hands out a few bytes per call, like a pipe would
+static int memReadStream(void *handle, void *buf, int size) {
+    MemorySource *src = (MemorySource *)handle;
+    size = min(min(size, 13), (int)(src->data.size() - src->pos));
+    memcpy(buf, src->data.data() + src->pos, size);
+    src->pos += size;
+    return size;
+}
+
+// reads a file of the test resources into memory, returns false if it cannot be opened
+static bool loadSource(const string &name, MemorySource *source) {
+    ifstream file(gEnv->getRes() + name, ios::binary);
+    if (!file.is_open()) return false;
+    source->data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    source->pos = 0;
+    return true;
+}
+
+// renders one buffer of the stream being played
+typedef function<EAS_RESULT(EAS_DATA_HANDLE easData, EAS_HANDLE stream)> RenderCallback;
+
+// plays a whole file in an instance set up by the caller, calling render for
+// every buffer until the stream stops, returns the first error
+static EAS_RESULT renderStream(EAS_DATA_HANDLE easData, EAS_FILE_LOCATOR locator,
+                               const RenderCallback &render) {
+    EAS_HANDLE stream = nullptr;
+    EAS_RESULT result;
+
+    if ((result = EAS_OpenFile(easData, locator, &stream)) != EAS_SUCCESS)
+        return result;
+    if ((result = EAS_Prepare(easData, stream)) == EAS_SUCCESS) {
+        EAS_STATE state = EAS_STATE_READY;
+        while (result == EAS_SUCCESS && state != EAS_STATE_STOPPED) {
+            if ((result = render(easData, stream)) == EAS_SUCCESS
+                && (result = EAS_State(easData, stream, &state)) == EAS_SUCCESS
+                && state == EAS_STATE_ERROR)
+                result = EAS_FAILURE;
+        }
+    }
+    EAS_RESULT closeResult = EAS_CloseFile(easData, stream);
+    return (result != EAS_SUCCESS) ? result : closeResult;
+}
+
+static EAS_RESULT renderStream(EAS_DATA_HANDLE easData, MemorySource *source,
+                               const RenderCallback &render) {
+    EAS_FILE easFile{source, memReadAt, memSize};
+    return renderStream(easData, &easFile, render);
+}
+
+// renders one buffer with EAS_Render and appends it to the audio
+static RenderCallback appendRender(vector<EAS_PCM> *pAudio) {
+    return [pAudio](EAS_DATA_HANDLE easData, EAS_HANDLE) {
+        const S_EAS_LIB_CONFIG *config = EAS_Config();
+        const size_t size = pAudio->size();
+        EAS_I32 count = 0;
+        pAudio->resize(size + config->mixBufferSize * config->numChannels);
+        EAS_RESULT result = EAS_Render(easData, pAudio->data() + size, config->mixBufferSize, &count);
+        pAudio->resize(size + count * config->numChannels);
+        return result;
+    };
+}
+
+// renders one buffer with EAS_RenderFormat and appends it to the samples
+template <typename T>
+static RenderCallback appendFormat(vector<T> *pSamples, EAS_I32 format) {
+    return [pSamples, format](EAS_DATA_HANDLE easData, EAS_HANDLE) {
+        const S_EAS_LIB_CONFIG *config = EAS_Config();
+        const size_t size = pSamples->size();
+        EAS_I32 count = 0;
+        pSamples->resize(size + config->mixBufferSize * config->numChannels);
+        EAS_RESULT result = EAS_RenderFormat(easData, pSamples->data() + size, format,
+                                             config->mixBufferSize, &count);
+        pSamples->resize(size + count * config->numChannels);
+        return result;
+    };
+}
+
+// renders a whole file in a new instance, optionally loading a DLS collection
+// first, returns the first error
+static EAS_RESULT renderToBuffer(MemorySource *source, vector<EAS_PCM> *pAudio,
+                                 MemorySource *dlsSource = nullptr,
+                                 EAS_I32 cullLevel = EAS_VOICE_CULL_LEVEL_OFF) {
+    EAS_FILE dlsFile{dlsSource, memReadAt, memSize};
+    EAS_DATA_HANDLE easData = nullptr;
+    EAS_RESULT result;
+
+    if ((result = EAS_Init(&easData)) != EAS_SUCCESS)
+        return result;
+    if ((result = EAS_SetVoiceCullLevel(easData, cullLevel)) == EAS_SUCCESS
+        && (dlsSource == nullptr || (result = EAS_LoadDLSCollection(easData, nullptr, &dlsFile)) == EAS_SUCCESS))
+        result = renderStream(easData, source, appendRender(pAudio));
+    EAS_Shutdown(easData);
+    return result;
+}
+
+TEST(SonivoxStreamLocatorTest, RenderFromStreamTest) {
+    MemorySource fileSource;
+    ASSERT_TRUE(loadSource("midi8sec.mid", &fileSource)) << "Failed to read test file";
+    MemorySource pipeSource{fileSource.data, 0};
+    vector<EAS_PCM> expected;
+    ASSERT_EQ(renderToBuffer(&fileSource, &expected), EAS_SUCCESS) << "Failed to render file";
+
+    EAS_DATA_HANDLE easData = nullptr;
+    EAS_FILE_LOCATOR streamLocator = nullptr;
+    ASSERT_EQ(EAS_Init(&easData), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    ASSERT_EQ(EAS_OpenStreamLocator(easData, &pipeSource, memReadStream, &streamLocator),
+              EAS_SUCCESS) << "Failed to create stream locator";
+
+    // the stream is read as it plays, not all at once when it is opened
+    vector<EAS_PCM> audio;
+    size_t firstPos = 0;
+    ASSERT_EQ(renderStream(easData, streamLocator, [&](EAS_DATA_HANDLE handle, EAS_HANDLE stream) {
+        if (audio.empty()) firstPos = pipeSource.pos;
+        return appendRender(&audio)(handle, stream);
+    }), EAS_SUCCESS) << "Failed to render stream";
+    ASSERT_LT(firstPos, pipeSource.data.size()) << "Opening read the whole stream";
+    ASSERT_EQ(audio, expected) << "Stream rendered differently from file";
+
+    ASSERT_EQ(EAS_CloseStreamLocator(easData, streamLocator), EAS_SUCCESS)
+            << "Failed to free stream locator";
+    ASSERT_EQ(EAS_Shutdown(easData), EAS_SUCCESS) << "Failed to shut down";
+}
+
+TEST(SonivoxArenaTest, RenderFromArenaTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource("midi8sec.mid", &source)) << "Failed to read test file";
+
+    // instance 0 uses the heap, instance 1 the arena
+    EAS_DATA_HANDLE easData[2] = {nullptr, nullptr};
+    ASSERT_EQ(EAS_InitArena(&easData[1], 0x7fffffff), EAS_ERROR_PARAMETER_RANGE) << "Arena size overflowed";
+    ASSERT_EQ(easData[1], nullptr);
+    ASSERT_EQ(EAS_Init(&easData[0]), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    ASSERT_EQ(EAS_InitArena(&easData[1], 0), EAS_SUCCESS) << "Failed to initialize with arena";
+
+    // playing the file again must reuse the blocks freed by the previous close
+    for (int pass = 0; pass < 3; pass++) {
+        vector<EAS_PCM> audio[2];
+        for (int i = 0; i < 2; i++) {
+            ASSERT_EQ(renderStream(easData[i], &source, appendRender(&audio[i])), EAS_SUCCESS)
+                    << "Failed to render on pass " << pass;
+        }
+        ASSERT_EQ(audio[0], audio[1]) << "Arena instance rendered differently on pass " << pass;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(EAS_Shutdown(easData[i]), EAS_SUCCESS) << "Failed to shut down";
+    }
+}
+
+TEST(SonivoxArenaTest, OptionalFeaturesTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource("midi8sec.mid", &source)) << "Failed to read test file";
+
+    // the arena has room for the features a host enables, without any extra size
+    EAS_DATA_HANDLE easData = nullptr;
+    ASSERT_EQ(EAS_InitArena(&easData, 0), EAS_SUCCESS) << "Failed to initialize with arena";
+    ASSERT_EQ(EAS_SetPCMPrefetch(easData, EAS_TRUE), EAS_SUCCESS) << "No room for the prefetch buffers";
+    ASSERT_EQ(EAS_SetStemBuses(easData, EAS_MAX_STEM_BUSES), EAS_SUCCESS) << "No room for the stem buses";
+    ASSERT_EQ(EAS_SetOutputSampleRate(easData, EAS_MAX_OUTPUT_SAMPLE_RATE), EAS_SUCCESS) << "No room for the resampler";
+
+    vector<EAS_PCM> audio;
+    ASSERT_EQ(renderStream(easData, &source, appendRender(&audio)), EAS_SUCCESS) << "Failed to render";
+    ASSERT_EQ(EAS_Shutdown(easData), EAS_SUCCESS) << "Failed to shut down";
+}
+
+TEST(SonivoxCloneTest, RenderCloneTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource("midi8sec.mid", &source)) << "Failed to read test file";
+    EAS_FILE easFile{&source, memReadAt, memSize};
+
+    for (int useArena = 0; useArena < 2; useArena++) {
+        // instance 0 is configured by hand, instance 1 is cloned from a template
+        EAS_DATA_HANDLE easData[2] = {nullptr, nullptr};
+        EAS_DATA_HANDLE easTemplate = nullptr;
+        ASSERT_EQ(EAS_Init(&easData[0]), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+        if (useArena) {
+            ASSERT_EQ(EAS_InitArena(&easTemplate, 0), EAS_SUCCESS) << "Failed to initialize with arena";
+        } else {
+            ASSERT_EQ(EAS_Init(&easTemplate), EAS_SUCCESS) << "Failed to initialize template";
+        }
+        for (EAS_DATA_HANDLE handle : {easData[0], easTemplate}) {
+            ASSERT_EQ(EAS_SetVolume(handle, nullptr, 70), EAS_SUCCESS) << "Failed to set volume";
+            ASSERT_EQ(EAS_SetSynthPolyphony(handle, 0, 16), EAS_SUCCESS) << "Failed to set polyphony";
+            ASSERT_EQ(EAS_SetParameter(handle, EAS_MODULE_REVERB, EAS_PARAM_REVERB_PRESET,
+                                       EAS_PARAM_REVERB_CHAMBER), EAS_SUCCESS);
+            ASSERT_EQ(EAS_SetParameter(handle, EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS,
+                                       EAS_FALSE), EAS_SUCCESS);
+        }
+        ASSERT_EQ(EAS_Clone(easTemplate, &easData[1]), EAS_SUCCESS) << "Failed to clone";
+
+        // a template with a stream open cannot be cloned
+        EAS_HANDLE stream = nullptr;
+        EAS_DATA_HANDLE easClone = nullptr;
+        ASSERT_EQ(EAS_OpenFile(easTemplate, &easFile, &stream), EAS_SUCCESS) << "Failed to open file";
+        ASSERT_EQ(EAS_Clone(easTemplate, &easClone), EAS_ERROR_NOT_VALID_IN_THIS_STATE);
+        ASSERT_EQ(easClone, nullptr);
+        ASSERT_EQ(EAS_CloseFile(easTemplate, stream), EAS_SUCCESS) << "Failed to close";
+
+        EAS_I32 polyphony = 0;
+        EAS_I32 preset = 0;
+        ASSERT_EQ(EAS_GetVolume(easData[1], nullptr), 70) << "Volume was not cloned";
+        ASSERT_EQ(EAS_GetSynthPolyphony(easData[1], 0, &polyphony), EAS_SUCCESS);
+        ASSERT_EQ(polyphony, 16) << "Polyphony was not cloned";
+        ASSERT_EQ(EAS_GetParameter(easData[1], EAS_MODULE_REVERB, EAS_PARAM_REVERB_PRESET, &preset),
+                  EAS_SUCCESS);
+        ASSERT_EQ(preset, EAS_PARAM_REVERB_CHAMBER) << "Reverb preset was not cloned";
+
+        vector<EAS_PCM> audio[2];
+        for (int i = 0; i < 2; i++) {
+            ASSERT_EQ(renderStream(easData[i], &source, appendRender(&audio[i])), EAS_SUCCESS)
+                    << "Failed to render";
+            ASSERT_EQ(EAS_Shutdown(easData[i]), EAS_SUCCESS) << "Failed to shut down";
+        }
+        ASSERT_EQ(audio[0], audio[1]) << "Clone rendered differently";
+        ASSERT_EQ(EAS_Shutdown(easTemplate), EAS_SUCCESS) << "Failed to shut down template";
+    }
+}
+
+TEST(SonivoxResetTest, RenderAfterResetTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource("midi8sec.mid", &source)) << "Failed to read test file";
+    EAS_FILE easFile{&source, memReadAt, memSize};
+    vector<EAS_PCM> expected;
+    ASSERT_EQ(renderToBuffer(&source, &expected), EAS_SUCCESS) << "Failed to render";
+
+    // the instance is reset in the middle of a file
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    EAS_DATA_HANDLE easData = nullptr;
+    EAS_HANDLE stream = nullptr;
+    ASSERT_EQ(EAS_Init(&easData), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    EAS_I32 defaultVolume = EAS_GetVolume(easData, nullptr);
+    ASSERT_EQ(EAS_SetVolume(easData, nullptr, 70), EAS_SUCCESS) << "Failed to set volume";
+    ASSERT_EQ(EAS_SetSynthPolyphony(easData, 0, 16), EAS_SUCCESS) << "Failed to set polyphony";
+    ASSERT_EQ(EAS_SetParameter(easData, EAS_MODULE_REVERB, EAS_PARAM_REVERB_PRESET,
+                               EAS_PARAM_REVERB_CHAMBER), EAS_SUCCESS);
+    ASSERT_EQ(EAS_SetParameter(easData, EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_FALSE),
+              EAS_SUCCESS);
+    ASSERT_EQ(EAS_OpenFile(easData, &easFile, &stream), EAS_SUCCESS) << "Failed to open file";
+    ASSERT_EQ(EAS_Prepare(easData, stream), EAS_SUCCESS) << "Failed to prepare";
+    vector<EAS_PCM> buffer(config->mixBufferSize * config->numChannels);
+    for (int i = 0; i < 200; i++) {
+        EAS_I32 count;
+        ASSERT_EQ(EAS_Render(easData, buffer.data(), config->mixBufferSize, &count), EAS_SUCCESS)
+                << "Failed to render audio";
+    }
+
+    // the open stream is closed and the settings revert to their defaults
+    ASSERT_EQ(EAS_Reset(easData, 0), EAS_SUCCESS) << "Failed to reset";
+    EAS_I32 polyphony = 0;
+    EAS_I32 bypass = EAS_FALSE;
+    EAS_I32 time = -1;
+    ASSERT_EQ(EAS_GetVolume(easData, nullptr), defaultVolume) << "Volume was not reset";
+    ASSERT_EQ(EAS_GetSynthPolyphony(easData, 0, &polyphony), EAS_SUCCESS);
+    ASSERT_EQ(polyphony, config->maxVoices) << "Polyphony was not reset";
+    ASSERT_EQ(EAS_GetParameter(easData, EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, &bypass),
+              EAS_SUCCESS);
+    ASSERT_EQ(bypass, EAS_TRUE) << "Reverb was not reset";
+    ASSERT_EQ(EAS_GetRenderTime(easData, &time), EAS_SUCCESS);
+    ASSERT_EQ(time, 0) << "Render time was not reset";
+
+    vector<EAS_PCM> audio;
+    ASSERT_EQ(renderStream(easData, &source, appendRender(&audio)), EAS_SUCCESS) << "Failed to render";
+    ASSERT_EQ(audio, expected) << "Reset instance rendered differently";
+    ASSERT_EQ(EAS_Shutdown(easData), EAS_SUCCESS) << "Failed to shut down";
+}
+
+TEST(SonivoxEffectsTest, IdleDelayLinesTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource("midi8sec.mid", &source)) << "Failed to read test file";
+
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    EAS_DATA_HANDLE easData[2] = {nullptr, nullptr};
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(EAS_Init(&easData[i]), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    }
+
+    EAS_I32 value = 0;
+    ASSERT_EQ(EAS_GetParameter(easData[0], EAS_MODULE_REVERB, EAS_PARAM_REVERB_IDLE_TIME, &value),
+              EAS_SUCCESS);
+    ASSERT_GT(value, 0) << "Reverb delay line is never freed by default";
+    ASSERT_NE(EAS_SetParameter(easData[0], EAS_MODULE_REVERB, EAS_PARAM_REVERB_IDLE_TIME, -1),
+              EAS_SUCCESS) << "Negative idle time accepted";
+    ASSERT_NE(EAS_SetParameter(easData[0], EAS_MODULE_CHORUS, EAS_PARAM_CHORUS_IDLE_TIME, -1),
+              EAS_SUCCESS) << "Negative idle time accepted";
+
+    // instance 1 allocates its delay lines, then bypasses them long enough
+    // for them to be freed
+    ASSERT_EQ(EAS_SetParameter(easData[1], EAS_MODULE_REVERB, EAS_PARAM_REVERB_IDLE_TIME, 10), EAS_SUCCESS);
+    ASSERT_EQ(EAS_SetParameter(easData[1], EAS_MODULE_CHORUS, EAS_PARAM_CHORUS_IDLE_TIME, 10), EAS_SUCCESS);
+    for (EAS_I32 bypass : {EAS_FALSE, EAS_TRUE}) {
+        ASSERT_EQ(EAS_SetParameter(easData[1], EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, bypass), EAS_SUCCESS);
+        ASSERT_EQ(EAS_SetParameter(easData[1], EAS_MODULE_CHORUS, EAS_PARAM_CHORUS_BYPASS, bypass), EAS_SUCCESS);
+    }
+    vector<EAS_PCM> buffer(config->mixBufferSize * config->numChannels);
+    for (int n = 0; n < 20; n++) {
+        EAS_I32 count;
+        ASSERT_EQ(EAS_Render(easData[1], buffer.data(), config->mixBufferSize, &count), EAS_SUCCESS)
+                << "Failed to render audio";
+    }
+
+    // enabling the effects again must start from clear delay lines
+    vector<EAS_PCM> audio[2];
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(EAS_SetParameter(easData[i], EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_FALSE),
+                  EAS_SUCCESS) << "Failed to enable reverb";
+        ASSERT_EQ(EAS_SetParameter(easData[i], EAS_MODULE_CHORUS, EAS_PARAM_CHORUS_BYPASS, EAS_FALSE),
+                  EAS_SUCCESS) << "Failed to enable chorus";
+        ASSERT_EQ(renderStream(easData[i], &source, appendRender(&audio[i])), EAS_SUCCESS)
+                << "Failed to render";
+        ASSERT_EQ(EAS_Shutdown(easData[i]), EAS_SUCCESS) << "Failed to shut down";
+    }
+    ASSERT_EQ(audio[0], audio[1]) << "Reallocated effects rendered differently";
+}
+
+TEST(SonivoxEffectsTest, SilentFrameFlagTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource("midi_a.mid", &source)) << "Failed to read test file";
+
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    vector<EAS_PCM> audio(config->mixBufferSize * config->numChannels);
+    EAS_DATA_HANDLE easData = nullptr;
+    ASSERT_EQ(EAS_Init(&easData), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    ASSERT_EQ(EAS_SetParameter(easData, EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_FALSE),
+              EAS_SUCCESS) << "Failed to enable reverb";
+    ASSERT_EQ(EAS_SetParameter(easData, EAS_MODULE_CHORUS, EAS_PARAM_CHORUS_BYPASS, EAS_FALSE),
+              EAS_SUCCESS) << "Failed to enable chorus";
+
+    EAS_I32 count;
+    EAS_U32 flags;
+    ASSERT_EQ(EAS_RenderEx(easData, audio.data(), config->mixBufferSize, &count, &flags),
+              EAS_SUCCESS) << "Failed to render audio";
+    ASSERT_EQ(flags, (EAS_U32) EAS_RENDER_SILENT) << "Idle instance not reported silent";
+
+    int audible = 0;
+    ASSERT_EQ(renderStream(easData, &source, [&](EAS_DATA_HANDLE handle, EAS_HANDLE) {
+        EAS_RESULT result = EAS_RenderEx(handle, audio.data(), config->mixBufferSize, &count, &flags);
+        if (!(flags & EAS_RENDER_SILENT))
+            audible++;
+        return result;
+    }), EAS_SUCCESS) << "Failed to render";
+    ASSERT_GT(audible, 0) << "Playing file reported silent";
+
+    // the effect tails must die out, and once they have every frame is zero
+    bool silent = false;
+    for (int n = 0; n < 2000; n++) {
+        ASSERT_EQ(EAS_RenderEx(easData, audio.data(), config->mixBufferSize, &count, &flags),
+                  EAS_SUCCESS) << "Failed to render audio";
+        if (flags & EAS_RENDER_SILENT) {
+            silent = true;
+            ASSERT_EQ(audio, vector<EAS_PCM>(audio.size(), 0)) << "Silent frame holds audio";
+        } else {
+            ASSERT_FALSE(silent) << "Audio after the tail died out";
+        }
+    }
+    ASSERT_TRUE(silent) << "Effect tails never died out";
+    ASSERT_EQ(EAS_Shutdown(easData), EAS_SUCCESS) << "Failed to shut down";
+}
+
+TEST(SonivoxEffectsTest, ReverbTailTest) {
+    static constexpr EAS_I32 kPresets[] = {EAS_PARAM_REVERB_LARGE_HALL, EAS_PARAM_REVERB_HALL,
+                                           EAS_PARAM_REVERB_CHAMBER, EAS_PARAM_REVERB_ROOM};
+    EAS_U8 noteOn[] = {0x90, 60, 127, 0x91, 64, 127, 0x92, 67, 127};
+    EAS_U8 noteOff[] = {0x80, 60, 0, 0x81, 64, 0, 0x82, 67, 0};
+    // the largest limit cycle of the fixed-point tails, the large hall's, is about 90 LSB
+    static constexpr int kLimitCycle = 96;
+
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    const size_t window = config->sampleRate / 2 * config->numChannels;
+    vector<EAS_PCM> audio(config->mixBufferSize * config->numChannels);
+    for (EAS_I32 preset : kPresets) {
+        EAS_DATA_HANDLE easData = nullptr;
+        EAS_HANDLE stream = nullptr;
+        ASSERT_EQ(EAS_Init(&easData), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+        ASSERT_EQ(EAS_SetParameter(easData, EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_FALSE),
+                  EAS_SUCCESS) << "Failed to enable reverb";
+        ASSERT_EQ(EAS_SetParameter(easData, EAS_MODULE_REVERB, EAS_PARAM_REVERB_PRESET, preset),
+                  EAS_SUCCESS) << "Failed to set reverb preset";
+        ASSERT_EQ(EAS_OpenMIDIStream(easData, &stream, nullptr), EAS_SUCCESS) << "Failed to open MIDI stream";
+        ASSERT_EQ(EAS_WriteMIDIStream(easData, stream, noteOn, sizeof(noteOn)), EAS_SUCCESS)
+                << "Failed to write note on";
+
+        EAS_I32 count;
+        EAS_U32 flags;
+        for (EAS_I32 n = 0; n < config->sampleRate / 2; n += count) {
+            ASSERT_EQ(EAS_RenderEx(easData, audio.data(), config->mixBufferSize, &count, &flags),
+                      EAS_SUCCESS) << "Failed to render audio";
+        }
+        ASSERT_EQ(EAS_WriteMIDIStream(easData, stream, noteOff, sizeof(noteOff)), EAS_SUCCESS)
+                << "Failed to write note off";
+
+        // render the tail up to the frame where it is cleared
+        vector<EAS_PCM> tail;
+        do {
+            ASSERT_LT(tail.size(), (size_t) config->sampleRate * 20 * config->numChannels)
+                    << "Tail of reverb preset " << preset << " never died out";
+            ASSERT_EQ(EAS_RenderEx(easData, audio.data(), config->mixBufferSize, &count, &flags),
+                      EAS_SUCCESS) << "Failed to render audio";
+            if (!(flags & EAS_RENDER_SILENT))
+                tail.insert(tail.end(), audio.begin(), audio.begin() + count * config->numChannels);
+        } while (!(flags & EAS_RENDER_SILENT));
+        ASSERT_EQ(EAS_CloseMIDIStream(easData, stream), EAS_SUCCESS) << "Failed to close MIDI stream";
+        ASSERT_EQ(EAS_Shutdown(easData), EAS_SUCCESS) << "Failed to shut down";
+        ASSERT_GE(tail.size(), 2 * window) << "Tail of reverb preset " << preset << " cut short";
+
+        // the tail has stopped decaying when it is cleared, so the step is no larger than its limit cycle
+        double energy[2] = {0, 0};
+        int peak = 0;
+        for (size_t n = tail.size() - 2 * window; n < tail.size(); n++) {
+            energy[n >= tail.size() - window] += (double) tail[n] * tail[n];
+            peak = max(peak, abs(tail[n]));
+        }
+        ASSERT_GE(energy[1], 0.85 * energy[0]) << "Tail of reverb preset " << preset << " cleared while decaying";
+        ASSERT_LE(peak, kLimitCycle) << "Tail of reverb preset " << preset << " cleared above its limit cycle";
+    }
+}
+
+TEST(SonivoxOfflineTest, TrimSilenceTest) {
+    // one note after a second of silence, 96 ticks per quarter note at 120 bpm
+    static const char kMidiFile[] = {
+        'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96,
+        'M', 'T', 'r', 'k', 0, 0, 0, 13,
+        (char) 0x81, 0x40, (char) 0x90, 60, 100,
+        0x60, (char) 0x80, 60, 0,
+        0, (char) 0xff, 0x2f, 0};
+    MemorySource source{vector<char>(kMidiFile, kMidiFile + sizeof(kMidiFile)), 0};
+
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    vector<EAS_PCM> audio[2];
+    ASSERT_EQ(renderToBuffer(&source, &audio[0]), EAS_SUCCESS) << "Failed to render";
+    EAS_DATA_HANDLE easData = nullptr;
+    ASSERT_EQ(EAS_Init(&easData), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    ASSERT_NE(EAS_SetOfflineMode(easData, EAS_TRUE, 0), EAS_SUCCESS) << "Invalid tail level accepted";
+    ASSERT_EQ(EAS_SetOfflineMode(easData, EAS_TRUE, EAS_OFFLINE_TAIL_LEVEL_DEFAULT), EAS_SUCCESS)
+            << "Failed to set offline mode";
+    ASSERT_EQ(renderStream(easData, &source, appendRender(&audio[1])), EAS_SUCCESS) << "Failed to render";
+    ASSERT_EQ(EAS_Shutdown(easData), EAS_SUCCESS) << "Failed to shut down";
+
+    // the offline render starts with the first sounding frame and ends early,
+    // in between it matches the full render
+    size_t frameSize = config->mixBufferSize * config->numChannels;
+    size_t first = find_if(audio[0].begin(), audio[0].end(), [](EAS_PCM s) { return s != 0; }) - audio[0].begin();
+    size_t offset = first / frameSize * frameSize;
+    ASSERT_GT(offset, 0u) << "File does not start with silence";
+    ASSERT_NE(audio[1][0], 0) << "Leading silence not skipped";
+    ASSERT_LT(offset + audio[1].size(), audio[0].size()) << "Release tails not trimmed";
+    size_t common = audio[1].size() - 4 * frameSize;
+    ASSERT_TRUE(equal(audio[1].begin(), audio[1].begin() + common, audio[0].begin() + offset))
+            << "Offline render differs from the full render";
+}
+
+TEST(SonivoxThreadTest, RenderOnManyThreadsTest) {
+    static constexpr int kNumThreads = 16;
+    const char *fileNames[] = {"ants.mid", "midi8sec.mid", "midi_a.mid", "midi_cs.mid", "midi_gs.mid"};
+    constexpr int kNumFiles = sizeof(fileNames) / sizeof(fileNames[0]);
+
+    // single threaded reference renders, the sources are only read from here on
+    MemorySource sources[kNumFiles];
+    vector<EAS_PCM> expected[kNumFiles];
+    for (int i = 0; i < kNumFiles; i++) {
+        ASSERT_TRUE(loadSource(fileNames[i], &sources[i])) << "Failed to read " << fileNames[i];
+        ASSERT_EQ(renderToBuffer(&sources[i], &expected[i]), EAS_SUCCESS)
+                << "Failed to render " << fileNames[i];
+    }
+
+    // every thread has an instance of its own, built with ThreadSanitizer
+    // (SANITIZE_THREAD) any shared state shows up as a data race
+    vector<EAS_PCM> audio[kNumThreads];
+    EAS_RESULT results[kNumThreads];
+    vector<std::thread> threads;
+    for (int i = 0; i < kNumThreads; i++) {
+        threads.emplace_back([&, i]() {
+            results[i] = renderToBuffer(&sources[i % kNumFiles], &audio[i]);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (int i = 0; i < kNumThreads; i++) {
+        ASSERT_EQ(results[i], EAS_SUCCESS) << "Thread " << i << " failed to render";
+        ASSERT_EQ(audio[i], expected[i % kNumFiles])
+                << "Thread " << i << " rendered " << fileNames[i % kNumFiles] << " differently";
+    }
+}
+
+TEST(SonivoxDLSCacheTest, SharedCollectionTest) {
+    MemorySource source;
+    MemorySource dlsSource;
+    ASSERT_TRUE(loadSource("midi8sec.mid", &source)) << "Failed to read test file";
+    ASSERT_TRUE(loadSource("test.dls", &dlsSource)) << "Failed to read DLS collection";
+    EAS_FILE dlsFile{&dlsSource, memReadAt, memSize};
+
+    // instances 0 and 1 share the cached collection, instance 2 parses a
+    // private copy into its arena
+    EAS_DATA_HANDLE easData[3] = {nullptr, nullptr, nullptr};
+    ASSERT_EQ(EAS_Init(&easData[0]), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    ASSERT_EQ(EAS_Init(&easData[1]), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    ASSERT_EQ(EAS_InitArena(&easData[2], (EAS_I32) dlsSource.data.size() * 2), EAS_SUCCESS)
+            << "Failed to initialize with arena";
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(EAS_LoadDLSCollection(easData[i], nullptr, &dlsFile), EAS_SUCCESS)
+                << "Failed to load DLS collection";
+    }
+
+    // the instance that loaded the collection first goes away half way through
+    vector<EAS_PCM> audio[3];
+    int frames = 0;
+    ASSERT_EQ(renderStream(easData[1], &source, [&](EAS_DATA_HANDLE handle, EAS_HANDLE stream) {
+        if (++frames == 200) {
+            EXPECT_EQ(EAS_Shutdown(easData[0]), EAS_SUCCESS) << "Failed to shut down";
+            easData[0] = nullptr;
+        }
+        return appendRender(&audio[1])(handle, stream);
+    }), EAS_SUCCESS) << "Failed to render";
+    ASSERT_EQ(easData[0], nullptr) << "File ended before the first instance went away";
+    ASSERT_EQ(renderStream(easData[2], &source, appendRender(&audio[2])), EAS_SUCCESS)
+            << "Failed to render";
+    ASSERT_EQ(audio[1], audio[2]) << "Shared collection rendered differently";
+    for (int i = 1; i < 3; i++) {
+        ASSERT_EQ(EAS_Shutdown(easData[i]), EAS_SUCCESS) << "Failed to shut down";
+    }
+
+    // concurrent loads of the same collection attach to a single copy
+    static constexpr int kNumThreads = 8;
+    vector<EAS_PCM> expected;
+    ASSERT_EQ(renderToBuffer(&source, &expected, &dlsSource), EAS_SUCCESS) << "Failed to render";
+    vector<EAS_PCM> threadAudio[kNumThreads];
+    EAS_RESULT results[kNumThreads];
+    vector<std::thread> threads;
+    for (int i = 0; i < kNumThreads; i++) {
+        threads.emplace_back([&, i]() {
+            results[i] = renderToBuffer(&source, &threadAudio[i], &dlsSource);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (int i = 0; i < kNumThreads; i++) {
+        ASSERT_EQ(results[i], EAS_SUCCESS) << "Thread " << i << " failed to render";
+        ASSERT_EQ(threadAudio[i], expected) << "Thread " << i << " rendered differently";
+    }
+}
+
+TEST(SonivoxCullTest, InaudibleVoiceTest) {
+    static constexpr EAS_I32 kCullLevel = 60;
+    static constexpr int kMaxError = 328;  // -40 dB, room for several culled voices
+    MemorySource source;
+    MemorySource dlsSource;
+    ASSERT_TRUE(loadSource("midi8sec.mid", &source)) << "Failed to read test file";
+    ASSERT_TRUE(loadSource("test.dls", &dlsSource)) << "Failed to read DLS collection";
+
+    EAS_DATA_HANDLE easData = nullptr;
+    ASSERT_EQ(EAS_Init(&easData), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    ASSERT_NE(EAS_SetVoiceCullLevel(easData, -1), EAS_SUCCESS) << "Invalid cull level accepted";
+    ASSERT_NE(EAS_SetVoiceCullLevel(easData, EAS_VOICE_CULL_LEVEL_MAX + 1), EAS_SUCCESS)
+            << "Invalid cull level accepted";
+    ASSERT_EQ(EAS_Shutdown(easData), EAS_SUCCESS) << "Failed to shut down";
+
+    // both the EAS and the DLS synthesizer skip the quiet voices, which may
+    // only change the output by about the cull level
+    MemorySource *dlsSources[] = {nullptr, &dlsSource};
+    for (MemorySource *pDLS : dlsSources) {
+        vector<EAS_PCM> expected, audio;
+        ASSERT_EQ(renderToBuffer(&source, &expected, pDLS), EAS_SUCCESS) << "Failed to render";
+        ASSERT_EQ(renderToBuffer(&source, &audio, pDLS, kCullLevel), EAS_SUCCESS) << "Failed to render";
+        ASSERT_EQ(audio.size(), expected.size()) << "Culled render has a different length";
+        ASSERT_NE(audio, expected) << "No voices were culled";
+        int maxError = 0;
+        for (size_t i = 0; i < audio.size(); i++) {
+            maxError = max(maxError, abs(audio[i] - expected[i]));
+        }
+        ASSERT_LT(maxError, kMaxError) << "Culled render differs too much from the full render";
+    }
+}
+
+#ifdef _WAVE_PARSER
+// a WAVE file of the given format, the data chunk may claim more data than it holds,
+// an IMA ADPCM file has the samples per block in the fmt chunk
+static vector<char> makeWave(uint16_t format, uint16_t channels, uint32_t rate, uint16_t blockAlign,
+                             uint16_t bits, const vector<char> &data, uint32_t dataSize) {
+    const uint32_t fmtSize = (format == 0x11) ? 20 : 16;
+    const uint32_t frameSize = (format == 0x11) ? (blockAlign - 4 * channels) * 8 / bits + 1 : 1;
+    vector<char> wave;
+    auto put = [&wave](uint32_t value, int size) {
+        for (int i = 0; i < size; i++) wave.push_back((char)(value >> (i * 8)));
+    };
+    wave.insert(wave.end(), {'R', 'I', 'F', 'F'});
+    put(20 + fmtSize + dataSize, 4);
+    wave.insert(wave.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    put(fmtSize, 4);
+    put(format, 2);
+    put(channels, 2);
+    put(rate, 4);
+    put(rate * blockAlign / frameSize, 4);
+    put(blockAlign, 2);
+    put(bits, 2);
+    if (format == 0x11) {
+        put(2, 2);
+        put(frameSize, 2);
+    }
+    wave.insert(wave.end(), {'d', 'a', 't', 'a'});
+    put(dataSize, 4);
+    wave.insert(wave.end(), data.begin(), data.end());
+    return wave;
+}
+
+// a mono 16-bit WAVE file holding a sawtooth
+static vector<char> makeWave(uint32_t rate, uint32_t numFrames, uint32_t dataSize) {
+    vector<char> data;
+    for (uint32_t i = 0; i < numFrames; i++) {
+        uint16_t value = (uint16_t)(int16_t)((i * 1000) % 16000 - 8000);
+        data.insert(data.end(), {(char)value, (char)(value >> 8)});
+    }
+    return makeWave(1, 1, rate, 2, 16, data, dataSize);
+}
+
+TEST(SonivoxWaveTest, MemoryLocatorTest) {
+    MemorySource midiSource;
+    ASSERT_TRUE(loadSource("midi8sec.mid", &midiSource)) << "Failed to read test file";
+    MemorySource waveSource{makeWave(22050, 11025, 22050), 0};
+    EAS_FILE midiFile{&midiSource, memReadAt, memSize};
+    EAS_FILE waveFile{&waveSource, memReadAt, memSize};
+
+    // instance 0 reads the WAVE file through the locator callbacks, instance 1 in place,
+    // both mix it with the MIDI file until it ends
+    EAS_DATA_HANDLE easData[2] = {nullptr, nullptr};
+    EAS_HANDLE midiStream[2] = {nullptr, nullptr};
+    EAS_FILE_LOCATOR memLocator = nullptr;
+    vector<EAS_PCM> audio[2];
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(EAS_Init(&easData[i]), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    }
+    ASSERT_EQ(EAS_OpenMemoryLocator(easData[1], waveSource.data.data(), waveSource.data.size(),
+                                    &memLocator), EAS_SUCCESS) << "Failed to create memory locator";
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(EAS_OpenFile(easData[i], &midiFile, &midiStream[i]), EAS_SUCCESS)
+                << "Failed to open MIDI file";
+        ASSERT_EQ(EAS_Prepare(easData[i], midiStream[i]), EAS_SUCCESS) << "Failed to prepare";
+        ASSERT_EQ(renderStream(easData[i], i ? memLocator : &waveFile, appendRender(&audio[i])),
+                  EAS_SUCCESS) << "Failed to render WAVE file";
+        ASSERT_EQ(EAS_CloseFile(easData[i], midiStream[i]), EAS_SUCCESS) << "Failed to close";
+    }
+    ASSERT_EQ(audio[0], audio[1]) << "In place render differs";
+    ASSERT_TRUE(any_of(audio[0].begin(), audio[0].end(), [](EAS_PCM s) { return s != 0; }))
+            << "Rendered silence";
+
+    ASSERT_EQ(EAS_CloseMemoryLocator(easData[1], memLocator), EAS_SUCCESS)
+            << "Failed to free memory locator";
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(EAS_Shutdown(easData[i]), EAS_SUCCESS) << "Failed to shut down";
+    }
+}
+
+TEST(SonivoxWaveTest, DamagedHeaderTest) {
+    EAS_DATA_HANDLE easData = nullptr;
+    ASSERT_EQ(EAS_Init(&easData), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+
+    // a truncated file plays what it holds
+    MemorySource truncated{makeWave(22050, 4000, 1 << 24), 0};
+    EAS_FILE truncatedFile{&truncated, memReadAt, memSize};
+    EAS_HANDLE stream = nullptr;
+    EAS_I32 length = 0;
+    ASSERT_EQ(EAS_OpenFile(easData, &truncatedFile, &stream), EAS_SUCCESS) << "Failed to open";
+    ASSERT_EQ(EAS_Prepare(easData, stream), EAS_SUCCESS) << "Failed to prepare";
+    ASSERT_EQ(EAS_ParseMetaData(easData, stream, &length), EAS_SUCCESS) << "Failed to get length";
+    ASSERT_EQ(length, 4000 * 1000 / 22050) << "Length is not the length of the data present";
+    ASSERT_EQ(EAS_CloseFile(easData, stream), EAS_SUCCESS) << "Failed to close";
+    vector<EAS_PCM> audio;
+    ASSERT_EQ(renderStream(easData, &truncated, appendRender(&audio)), EAS_SUCCESS)
+            << "Failed to render truncated file";
+
+    // a short fmt chunk, a rate the engine cannot hold and no data are refused when the
+    // header is parsed, the file is recognized as WAVE before that
+    MemorySource damaged[3] = {{makeWave(22050, 100, 200), 0}, {makeWave(192000, 100, 200), 0},
+                               {makeWave(22050, 0, 0), 0}};
+    damaged[0].data[16] = 8;
+    for (MemorySource &source : damaged) {
+        EAS_FILE damagedFile{&source, memReadAt, memSize};
+        stream = nullptr;
+        ASSERT_EQ(EAS_OpenFile(easData, &damagedFile, &stream), EAS_SUCCESS) << "Failed to open";
+        ASSERT_EQ(EAS_Prepare(easData, stream), EAS_ERROR_UNRECOGNIZED_FORMAT)
+                << "Damaged file was not refused";
+        ASSERT_EQ(EAS_CloseFile(easData, stream), EAS_SUCCESS) << "Failed to close";
+    }
+    ASSERT_EQ(EAS_Shutdown(easData), EAS_SUCCESS) << "Failed to shut down";
+}
+// a source that counts the reads of its locator
+struct CountingSource {
+    MemorySource source;
+    int numReads;
+};
+
+static int countingReadAt(void *handle, void *buf, int offset, int size) {
+    CountingSource *counting = (CountingSource *)handle;
+    counting->numReads++;
+    return memReadAt(&counting->source, buf, offset, size);
+}
+
+static int countingSize(void *handle) {
+    return memSize(&((CountingSource *)handle)->source);
+}
+
+// linear PCM data of one or two channels, 16-bit or 8-bit unsigned from the high bytes
+static vector<char> pcmData(const vector<int16_t> &left, const vector<int16_t> *right, bool eightBit) {
+    vector<char> data;
+    for (size_t i = 0; i < left.size(); i++) {
+        for (int16_t value : {left[i], right ? (*right)[i] : left[i]}) {
+            if (eightBit)
+                data.push_back((char)((value >> 8) + 128));
+            else
+                data.insert(data.end(), {(char)value, (char)(value >> 8)});
+            if (!right) break;
+        }
+    }
+    return data;
+}
+
+// renders a whole file played repeat times more, returns the first error
+static EAS_RESULT renderRepeat(MemorySource *source, EAS_I32 repeat, vector<EAS_PCM> *pAudio) {
+    EAS_DATA_HANDLE easData = nullptr;
+    EAS_RESULT result;
+
+    if ((result = EAS_Init(&easData)) != EAS_SUCCESS)
+        return result;
+    bool first = true;
+    result = renderStream(easData, source, [&](EAS_DATA_HANDLE handle, EAS_HANDLE stream) {
+        EAS_RESULT setResult = first ? EAS_SetRepeat(handle, stream, repeat) : EAS_SUCCESS;
+        first = false;
+        return (setResult != EAS_SUCCESS) ? setResult : appendRender(pAudio)(handle, stream);
+    });
+    EAS_Shutdown(easData);
+    return result;
+}
+
+// renders a whole file, located to milliseconds first if not zero, returns the first error
+static EAS_RESULT renderLocated(CountingSource *counting, EAS_I32 milliseconds,
+                                vector<EAS_PCM> *pAudio) {
+    EAS_FILE easFile{counting, countingReadAt, countingSize};
+    EAS_DATA_HANDLE easData = nullptr;
+    EAS_RESULT result;
+
+    if ((result = EAS_Init(&easData)) != EAS_SUCCESS)
+        return result;
+    bool first = true;
+    result = renderStream(easData, &easFile, [&](EAS_DATA_HANDLE handle, EAS_HANDLE stream) {
+        EAS_RESULT locateResult = EAS_SUCCESS;
+        if (first && milliseconds)
+            locateResult = EAS_Locate(handle, stream, milliseconds, EAS_FALSE);
+        first = false;
+        return (locateResult != EAS_SUCCESS) ? locateResult : appendRender(pAudio)(handle, stream);
+    });
+    EAS_Shutdown(easData);
+    return result;
+}
+
+TEST(SonivoxWaveTest, LinearPCMTest) {
+    // two seconds of a sawtooth on the left and a slower one on the right, whose
+    // high bytes are what the 8-bit files hold
+    const uint32_t kRate = 22050;
+    vector<int16_t> left, right, left8, right8;
+    for (uint32_t i = 0; i < 2 * kRate; i++) {
+        left.push_back((int16_t)((i * 1000) % 16000 - 8000));
+        right.push_back((int16_t)((i * 37) % 20000 - 10000));
+        left8.push_back((int16_t)(left.back() & ~0xff));
+        right8.push_back((int16_t)(right.back() & ~0xff));
+    }
+
+    for (uint16_t channels : {1, 2}) {
+        const vector<int16_t> *pRight = (channels == 2) ? &right : nullptr;
+        const vector<int16_t> *pRight8 = (channels == 2) ? &right8 : nullptr;
+        const vector<char> data = pcmData(left, pRight, false);
+        CountingSource pcm16{{makeWave(1, channels, kRate, 2 * channels, 16, data, data.size()), 0}, 0};
+        CountingSource pcm8{{makeWave(1, channels, kRate, channels, 8, pcmData(left, pRight, true),
+                                      data.size() / 2), 0}, 0};
+        const vector<char> data8 = pcmData(left8, pRight8, false);
+        CountingSource pcm16From8{{makeWave(1, channels, kRate, 2 * channels, 16, data8, data8.size()), 0}, 0};
+
+        // the 8-bit file plays as the 16-bit file of its samples, and is read in blocks
+        vector<EAS_PCM> audio, expected;
+        ASSERT_EQ(renderLocated(&pcm8, 0, &audio), EAS_SUCCESS) << "Failed to render";
+        ASSERT_EQ(renderLocated(&pcm16From8, 0, &expected), EAS_SUCCESS) << "Failed to render";
+        ASSERT_TRUE(any_of(audio.begin(), audio.end(), [](EAS_PCM s) { return s != 0; }))
+                << "Rendered silence";
+        ASSERT_EQ(audio, expected) << channels << " channel 8-bit render differs";
+        ASSERT_LT(pcm8.numReads * 128, (int)data.size() / 2) << "Read in small pieces";
+        ASSERT_LT(pcm16From8.numReads * 128, (int)data.size()) << "Read in small pieces";
+
+        // the left and right channels play the data of each channel
+        audio.clear();
+        ASSERT_EQ(renderLocated(&pcm16, 0, &audio), EAS_SUCCESS) << "Failed to render";
+        vector<EAS_PCM> mono[2];
+        for (int channel = 0; channel < channels; channel++) {
+            const vector<char> monoData = pcmData(channel ? right : left, nullptr, false);
+            CountingSource monoSource{{makeWave(1, 1, kRate, 2, 16, monoData, monoData.size()), 0}, 0};
+            ASSERT_EQ(renderLocated(&monoSource, 0, &mono[channel]), EAS_SUCCESS) << "Failed to render";
+        }
+        ASSERT_EQ(audio.size(), mono[0].size()) << "Stereo file has the wrong length";
+        for (size_t i = 0; i < audio.size(); i++) {
+            ASSERT_EQ(audio[i], mono[(channels == 2) ? (i & 1) : 0][i])
+                    << channels << " channel render differs at " << i;
+        }
+
+        // a locate to one second skips the first second of data
+        const size_t skip = kRate * (2 * channels);
+        const vector<char> tail(data.begin() + skip, data.end());
+        CountingSource pcmTail{{makeWave(1, channels, kRate, 2 * channels, 16, tail, tail.size()), 0}, 0};
+        audio.clear();
+        expected.clear();
+        ASSERT_EQ(renderLocated(&pcm16, 1000, &audio), EAS_SUCCESS) << "Failed to render";
+        ASSERT_EQ(renderLocated(&pcmTail, 0, &expected), EAS_SUCCESS) << "Failed to render";
+        ASSERT_EQ(audio, expected) << channels << " channel render after a locate differs";
+
+        // every pass of a repeated file plays the same
+        MemorySource repeated{pcm16.source.data, 0};
+        audio.clear();
+        expected.clear();
+        ASSERT_EQ(renderRepeat(&repeated, 2, &audio), EAS_SUCCESS) << "Failed to render";
+        ASSERT_EQ(renderRepeat(&repeated, 0, &expected), EAS_SUCCESS) << "Failed to render";
+        ASSERT_EQ(audio.size(), 3 * expected.size()) << "Repeated file has the wrong length";
+        for (size_t pass = 0; pass < 3; pass++) {
+            ASSERT_TRUE(equal(expected.begin(), expected.end(), audio.begin() + pass * expected.size()))
+                    << "Pass " << pass << " differs";
+        }
+    }
+}
+
+// the reference IMA ADPCM decoder, one nibble at a time
+static int16_t imaDecodeNibble(int *pAcc, int *pIndex, int nibble) {
+    static const int16_t kSteps[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55,
+        60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+        337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411,
+        1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+        5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500,
+        20350, 22385, 24623, 27086, 29794, 32767};
+    static const int kIndexStep[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+    int step = kSteps[*pIndex];
+    int delta = step >> 3;
+    if (nibble & 4) delta += step;
+    if (nibble & 2) delta += step >> 1;
+    if (nibble & 1) delta += step >> 2;
+    *pAcc = min(max((nibble & 8) ? *pAcc - delta : *pAcc + delta, -32768), 32767);
+    *pIndex = min(max(*pIndex + kIndexStep[nibble & 7], 0), 88);
+    return (int16_t)*pAcc;
+}
+
+// a mono IMA ADPCM WAVE file of pseudo-random nibbles, and its decoded samples as 16-bit data
+static vector<char> makeIMAWave(uint32_t rate, uint16_t blockSize, int numBlocks,
+                                vector<char> *pDecoded) {
+    vector<char> data;
+    uint32_t seed = 1;
+    auto putSample = [pDecoded](int16_t value) {
+        pDecoded->insert(pDecoded->end(), {(char)value, (char)(value >> 8)});
+    };
+    for (int block = 0; block < numBlocks; block++) {
+        int acc = (block * 5000) % 30000 - 15000;
+        int index = (block * 23) % 89;
+        data.insert(data.end(), {(char)acc, (char)(acc >> 8), (char)index, 0});
+        putSample((int16_t)acc);
+        for (int i = 4; i < blockSize; i++) {
+            seed = seed * 1103515245 + 12345;
+            uint8_t byte = (uint8_t)(seed >> 16);
+            data.push_back((char)byte);
+            putSample(imaDecodeNibble(&acc, &index, byte & 0x0f));
+            putSample(imaDecodeNibble(&acc, &index, byte >> 4));
+        }
+    }
+    return makeWave(0x11, 1, rate, blockSize, 4, data, data.size());
+}
+
+TEST(SonivoxWaveTest, IMAADPCMTest) {
+    // blocks either side of the size the block cache holds, played once and looped
+    for (uint16_t blockSize : {256, 2048}) {
+        for (EAS_I32 repeat : {0, 2}) {
+            vector<char> decoded;
+            MemorySource ima{makeIMAWave(22050, blockSize, 3, &decoded), 0};
+            MemorySource pcm{makeWave(1, 1, 22050, 2, 16, decoded, decoded.size()), 0};
+            vector<EAS_PCM> audio, expected;
+            ASSERT_EQ(renderRepeat(&ima, repeat, &audio), EAS_SUCCESS) << "Failed to render";
+            ASSERT_EQ(renderRepeat(&pcm, repeat, &expected), EAS_SUCCESS) << "Failed to render";
+            ASSERT_EQ(audio.size(), expected.size()) << "Block size " << blockSize;
+            ASSERT_TRUE(any_of(audio.begin(), audio.end(), [](EAS_PCM s) { return s != 0; }))
+                    << "Rendered silence";
+
+            // after the data of each pass the IMA ADPCM stream holds its last frame
+            // where the linear PCM stream interpolates to silence
+            size_t held = 0;
+            for (size_t i = 0; i < audio.size(); i++) {
+                if (audio[i] == expected[i]) continue;
+                ASSERT_GE(i, 2u);
+                ASSERT_EQ(audio[i], audio[i - 2])
+                        << "Block size " << blockSize << " differs from the reference at " << i;
+                held++;
+            }
+            ASSERT_GT(held, 0u) << "Last frame was not held";
+        }
+    }
+}
+
+// a source whose reads from any other thread than the render thread wait to be released
+struct GatedSource {
+    MemorySource *source;
+    std::thread::id renderId;
+    std::atomic<bool> reading;
+    std::atomic<bool> release;
+};
+
+static int gatedReadAt(void *handle, void *buf, int offset, int size) {
+    GatedSource *gated = (GatedSource *)handle;
+    if (std::this_thread::get_id() != gated->renderId) {
+        gated->reading = true;
+        while (!gated->release) std::this_thread::yield();
+    }
+    return memReadAt(gated->source, buf, offset, size);
+}
+
+static int gatedSize(void *handle) {
+    return memSize(((GatedSource *)handle)->source);
+}
+
+TEST(SonivoxPrefetchTest, PrefetchThreadTest) {
+    MemorySource source{makeWave(22050, 44100, 88200), 0};
+    vector<EAS_PCM> expected;
+    ASSERT_EQ(renderToBuffer(&source, &expected), EAS_SUCCESS) << "Failed to render";
+
+    // instance 1 is a clone and reads ahead with buffers of its own
+    EAS_DATA_HANDLE easData[2] = {nullptr, nullptr};
+    EAS_I32 numReads = -1;
+    ASSERT_EQ(EAS_Init(&easData[0]), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    ASSERT_EQ(EAS_PrefetchPCMStreams(easData[0], &numReads), EAS_ERROR_FEATURE_NOT_AVAILABLE)
+            << "Prefetch ran before it was enabled";
+    ASSERT_EQ(EAS_SetPCMPrefetch(easData[0], EAS_TRUE), EAS_SUCCESS) << "Failed to enable prefetch";
+    ASSERT_EQ(EAS_Clone(easData[0], &easData[1]), EAS_SUCCESS) << "Failed to clone";
+
+    for (EAS_DATA_HANDLE handle : easData) {
+        // the I/O thread reads once before every render, so no buffer is late
+        std::atomic<bool> done(false);
+        std::atomic<int> requested(0), completed(0);
+        std::atomic<EAS_I32> totalReads(0);
+        std::thread io([&]() {
+            while (!done) {
+                if (completed == requested) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                EAS_I32 count = 0;
+                if (EAS_PrefetchPCMStreams(handle, &count) != EAS_SUCCESS)
+                    count = -1;
+                totalReads += count;
+                completed++;
+            }
+        });
+
+        vector<EAS_PCM> audio;
+        EAS_RESULT result = renderStream(handle, &source, [&](EAS_DATA_HANDLE easData, EAS_HANDLE stream) {
+            requested++;
+            while (completed != requested) std::this_thread::yield();
+            return appendRender(&audio)(easData, stream);
+        });
+        done = true;
+        io.join();
+        ASSERT_EQ(result, EAS_SUCCESS) << "Failed to render";
+
+        EAS_U32 underruns = 1;
+        ASSERT_GT(totalReads, 0) << "Prefetch failed or read nothing";
+        ASSERT_EQ(EAS_GetPCMUnderruns(handle, &underruns), EAS_SUCCESS);
+        ASSERT_EQ(underruns, 0u);
+        ASSERT_EQ(audio, expected) << "Render with prefetch differs";
+    }
+
+    // a render while the I/O thread is stuck in a read underruns, and the
+    // stream can be closed without waiting for the read
+    GatedSource gated{&source, std::this_thread::get_id(), {false}, {false}};
+    EAS_FILE gatedFile{&gated, gatedReadAt, gatedSize};
+    EAS_HANDLE stream = nullptr;
+    EAS_U32 underruns = 0;
+    ASSERT_EQ(EAS_OpenFile(easData[0], &gatedFile, &stream), EAS_SUCCESS) << "Failed to open";
+    ASSERT_EQ(EAS_Prepare(easData[0], stream), EAS_SUCCESS) << "Failed to prepare";
+    std::thread io([&]() {
+        EAS_I32 count = 0;
+        EAS_PrefetchPCMStreams(easData[0], &count);
+    });
+    while (!gated.reading) std::this_thread::yield();
+    vector<EAS_PCM> audio;
+    EAS_RESULT result = appendRender(&audio)(easData[0], stream);
+    EAS_RESULT closeResult = EAS_CloseFile(easData[0], stream);
+    gated.release = true;
+    io.join();
+    ASSERT_EQ(result, EAS_SUCCESS) << "Failed to render";
+    ASSERT_EQ(closeResult, EAS_SUCCESS) << "Failed to close";
+    ASSERT_EQ(EAS_GetPCMUnderruns(easData[0], &underruns), EAS_SUCCESS);
+    ASSERT_EQ(underruns, 1u) << "Late buffer was not counted";
+    ASSERT_TRUE(all_of(audio.begin(), audio.end(), [](EAS_PCM s) { return s == 0; }))
+            << "Played data that was not read";
+
+    ASSERT_EQ(EAS_SetPCMPrefetch(easData[0], EAS_FALSE), EAS_SUCCESS) << "Failed to disable prefetch";
+    ASSERT_EQ(EAS_PrefetchPCMStreams(easData[0], &numReads), EAS_ERROR_FEATURE_NOT_AVAILABLE)
+            << "Prefetch ran after it was disabled";
+    for (EAS_DATA_HANDLE handle : easData) {
+        ASSERT_EQ(EAS_Shutdown(handle), EAS_SUCCESS) << "Failed to shut down";
+    }
+}
+#endif
+
+#ifdef _XMF_PARSER
+TEST(SonivoxXMFTest, MemoryLocatorTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource(kMobileXMFFile, &source)) << "Failed to read test file";
+    vector<EAS_PCM> expected;
+    ASSERT_EQ(renderToBuffer(&source, &expected), EAS_SUCCESS) << "Failed to render";
+
+    // the embedded DLS collection and SMF play the same in place as through the callbacks
+    EAS_DATA_HANDLE easData = nullptr;
+    EAS_FILE_LOCATOR memLocator = nullptr;
+    ASSERT_EQ(EAS_Init(&easData), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    ASSERT_EQ(EAS_OpenMemoryLocator(easData, source.data.data(), source.data.size(), &memLocator),
+              EAS_SUCCESS) << "Failed to create memory locator";
+    vector<EAS_PCM> audio;
+    EAS_I32 fileType = EAS_FILE_UNKNOWN;
+    ASSERT_EQ(renderStream(easData, memLocator, [&](EAS_DATA_HANDLE handle, EAS_HANDLE stream) {
+        EAS_GetFileType(handle, stream, &fileType);
+        return appendRender(&audio)(handle, stream);
+    }), EAS_SUCCESS) << "Failed to render";
+    ASSERT_TRUE(fileType == EAS_FILE_XMF0 || fileType == EAS_FILE_XMF1) << "Not played as XMF";
+    ASSERT_TRUE(any_of(audio.begin(), audio.end(), [](EAS_PCM s) { return s != 0; }))
+            << "Rendered silence";
+    ASSERT_EQ(audio, expected) << "In place render differs";
+    ASSERT_EQ(EAS_CloseMemoryLocator(easData, memLocator), EAS_SUCCESS)
+            << "Failed to free memory locator";
+
+    // a file cut short in the tree runs out of data, one cut short after it cannot seek
+    // to the data the tree points to, either way it is refused when opened
+    const pair<size_t, EAS_RESULT> truncations[3] = {
+            {12, EAS_EOF}, {40, EAS_EOF}, {4096, EAS_ERROR_FILE_SEEK}};
+    for (const pair<size_t, EAS_RESULT> &truncation : truncations) {
+        MemorySource truncated{vector<char>(source.data.begin(),
+                                            source.data.begin() + truncation.first), 0};
+        EAS_FILE truncatedFile{&truncated, memReadAt, memSize};
+        EAS_HANDLE stream = nullptr;
+        ASSERT_EQ(EAS_OpenFile(easData, &truncatedFile, &stream), truncation.second)
+                << "File cut at " << truncation.first << " bytes";
+        ASSERT_EQ(stream, nullptr) << "Stream left open";
+    }
+    ASSERT_EQ(EAS_Shutdown(easData), EAS_SUCCESS) << "Failed to shut down";
+}
+#endif
+
+TEST(SonivoxStemTest, RenderStemsTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource("ants.mid", &source)) << "Failed to read test file";
+
+    // instance 0 renders the mix, instance 1 the mix and the stems, both dry
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    const size_t bufferSize = config->mixBufferSize * config->numChannels;
+    EAS_DATA_HANDLE easData[2] = {nullptr, nullptr};
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(EAS_Init(&easData[i]), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+        ASSERT_EQ(EAS_SetParameter(easData[i], EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_TRUE),
+                  EAS_SUCCESS);
+        ASSERT_EQ(EAS_SetParameter(easData[i], EAS_MODULE_CHORUS, EAS_PARAM_CHORUS_BYPASS, EAS_TRUE),
+                  EAS_SUCCESS);
+    }
+    vector<EAS_PCM> audio[2];
+    vector<vector<EAS_PCM>> stems(EAS_MAX_STEM_BUSES, vector<EAS_PCM>(bufferSize));
+    vector<EAS_PCM *> stemPtrs;
+    for (vector<EAS_PCM> &stem : stems) {
+        stemPtrs.push_back(stem.data());
+    }
+    vector<EAS_PCM> mix(bufferSize);
+
+    EAS_I32 count;
+    ASSERT_EQ(EAS_RenderStems(easData[1], mix.data(), stemPtrs.data(), config->mixBufferSize, &count),
+              EAS_ERROR_NOT_VALID_IN_THIS_STATE) << "Rendered stems without buses";
+    ASSERT_NE(EAS_SetStemBuses(easData[1], EAS_MAX_STEM_BUSES + 1), EAS_SUCCESS) << "Too many buses";
+    ASSERT_EQ(EAS_SetStemBuses(easData[1], EAS_MAX_STEM_BUSES), EAS_SUCCESS) << "Failed to set buses";
+
+
+    // channels 0 and 1 share bus 0
+    vector<vector<EAS_PCM>> stemAudio(EAS_MAX_STEM_BUSES);
+    ASSERT_EQ(renderStream(easData[0], &source, appendRender(&audio[0])), EAS_SUCCESS) << "Failed to render";
+    bool routed = false;
+    ASSERT_EQ(renderStream(easData[1], &source, [&](EAS_DATA_HANDLE handle, EAS_HANDLE stream) {
+        if (!routed) {
+            EXPECT_NE(EAS_SetChannelBus(handle, stream, 16, 0), EAS_SUCCESS) << "Invalid channel accepted";
+            EXPECT_NE(EAS_SetChannelBus(handle, stream, 0, EAS_STEM_BUS_NONE + 1), EAS_SUCCESS)
+                    << "Invalid bus accepted";
+            EXPECT_EQ(EAS_SetChannelBus(handle, stream, 1, 0), EAS_SUCCESS) << "Failed to route channel";
+            routed = true;
+        }
+        EAS_RESULT result = EAS_RenderStems(handle, mix.data(), stemPtrs.data(), config->mixBufferSize, &count);
+        audio[1].insert(audio[1].end(), mix.begin(), mix.end());
+        for (int bus = 0; bus < EAS_MAX_STEM_BUSES; bus++) {
+            stemAudio[bus].insert(stemAudio[bus].end(), stems[bus].begin(), stems[bus].end());
+        }
+        return result;
+    }), EAS_SUCCESS) << "Failed to render stems";
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(EAS_Shutdown(easData[i]), EAS_SUCCESS) << "Failed to shut down";
+    }
+
+    // the mix does not change and the stems add up to it, within rounding where nothing clips
+    ASSERT_EQ(audio[0], audio[1]) << "Stem rendering changed the mix";
+    vector<bool> heard(EAS_MAX_STEM_BUSES, false);
+    int maxError = 0;
+    auto saturated = [](EAS_PCM s) { return s == 32767 || s == -32768; };
+    for (size_t n = 0; n < audio[1].size(); n++) {
+        int sum = 0;
+        bool clipped = saturated(audio[1][n]);
+        for (int bus = 0; bus < EAS_MAX_STEM_BUSES; bus++) {
+            sum += stemAudio[bus][n];
+            heard[bus] = heard[bus] || (stemAudio[bus][n] != 0);
+            clipped = clipped || saturated(stemAudio[bus][n]);
+        }
+        if (!clipped) {
+            maxError = max(maxError, abs(sum - audio[1][n]));
+        }
+    }
+    ASSERT_TRUE(heard[0]) << "Stem 0 is silent";
+    ASSERT_FALSE(heard[1]) << "Channel 1 was not routed to bus 0";
+    ASSERT_GT(count_if(heard.begin(), heard.end(), [](bool h) { return h; }), 2) << "Too few stems";
+    ASSERT_LE(maxError, EAS_MAX_STEM_BUSES) << "Stems do not add up to the mix";
+}
+
+TEST(SonivoxStemTest, RenderStemsAfterResetTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource("ants.mid", &source)) << "Failed to read test file";
+    EAS_FILE easFile{&source, memReadAt, memSize};
+
+    // renders the stems one after the other into the audio
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    const size_t bufferSize = config->mixBufferSize * config->numChannels;
+    vector<vector<EAS_PCM>> stems(EAS_MAX_STEM_BUSES, vector<EAS_PCM>(bufferSize));
+    vector<EAS_PCM *> stemPtrs;
+    for (vector<EAS_PCM> &stem : stems) {
+        stemPtrs.push_back(stem.data());
+    }
+    vector<EAS_PCM> mix(bufferSize);
+    auto appendStems = [&](vector<EAS_PCM> *pAudio) -> RenderCallback {
+        return [&, pAudio](EAS_DATA_HANDLE handle, EAS_HANDLE) {
+            EAS_I32 count;
+            EAS_RESULT result = EAS_RenderStems(handle, mix.data(), stemPtrs.data(), config->mixBufferSize, &count);
+            for (vector<EAS_PCM> &stem : stems) {
+                pAudio->insert(pAudio->end(), stem.begin(), stem.end());
+            }
+            return result;
+        };
+    };
+
+    // instance 0 is new, instance 1 is reset in the middle of the file and keeps its buses
+    EAS_DATA_HANDLE easData[2] = {nullptr, nullptr};
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(EAS_Init(&easData[i]), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+        ASSERT_EQ(EAS_SetStemBuses(easData[i], EAS_MAX_STEM_BUSES), EAS_SUCCESS) << "Failed to set buses";
+    }
+    EAS_HANDLE stream = nullptr;
+    vector<EAS_PCM> audio[2];
+    ASSERT_EQ(EAS_OpenFile(easData[1], &easFile, &stream), EAS_SUCCESS) << "Failed to open file";
+    ASSERT_EQ(EAS_Prepare(easData[1], stream), EAS_SUCCESS) << "Failed to prepare";
+    ASSERT_EQ(EAS_SetChannelBus(easData[1], stream, 1, 0), EAS_SUCCESS) << "Failed to route channel";
+    RenderCallback render = appendStems(&audio[1]);
+    for (int n = 0; n < 100; n++) {
+        ASSERT_EQ(render(easData[1], stream), EAS_SUCCESS) << "Failed to render stems";
+    }
+    ASSERT_EQ(EAS_Reset(easData[1], 0), EAS_SUCCESS) << "Failed to reset";
+    audio[1].clear();
+
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(renderStream(easData[i], &source, appendStems(&audio[i])), EAS_SUCCESS)
+                << "Failed to render stems";
+        ASSERT_EQ(EAS_Shutdown(easData[i]), EAS_SUCCESS) << "Failed to shut down";
+    }
+    ASSERT_TRUE(any_of(audio[0].begin(), audio[0].end(), [](EAS_PCM s) { return s != 0; }))
+            << "Rendered silence";
+    ASSERT_EQ(audio[0], audio[1]) << "Stems rendered differently after reset";
+}
+
+TEST(SonivoxFormatTest, RenderFormatTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource("ants.mid", &source)) << "Failed to read test file";
+
+    // the same file rendered as 16-bit, 32-bit integer and float samples, with the effects on
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    EAS_DATA_HANDLE easData[3] = {nullptr, nullptr, nullptr};
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(EAS_Init(&easData[i]), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    }
+    vector<EAS_PCM> pcm;
+    vector<EAS_I32> int32;
+    vector<float> float32;
+
+    EAS_I32 count;
+    vector<EAS_I32> buffer(config->mixBufferSize * config->numChannels);
+    ASSERT_EQ(EAS_RenderFormat(easData[1], buffer.data(), EAS_FORMAT_FLOAT32 + 1, config->mixBufferSize,
+                               &count), EAS_ERROR_PARAMETER_RANGE) << "Invalid format accepted";
+    ASSERT_EQ(renderStream(easData[0], &source, appendFormat(&pcm, EAS_FORMAT_PCM16)), EAS_SUCCESS)
+            << "Failed to render audio";
+    ASSERT_EQ(renderStream(easData[1], &source, appendFormat(&int32, EAS_FORMAT_INT32)), EAS_SUCCESS)
+            << "Failed to render 32-bit integers";
+    ASSERT_EQ(renderStream(easData[2], &source, appendFormat(&float32, EAS_FORMAT_FLOAT32)), EAS_SUCCESS)
+            << "Failed to render floats";
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(EAS_Shutdown(easData[i]), EAS_SUCCESS) << "Failed to shut down";
+    }
+    ASSERT_EQ(int32.size(), pcm.size());
+    ASSERT_EQ(float32.size(), pcm.size());
+
+    // the 32-bit formats match the 16-bit output within rounding, keep the low order bits
+    // and, for floats, the peaks that are clipped at 16 bits
+    int maxError = 0;
+    bool lowBits = false;
+    bool clipped = false;
+    float peak = 0;
+    for (size_t n = 0; n < pcm.size(); n++) {
+        peak = max(peak, fabs(float32[n]));
+        if (pcm[n] == 32767 || pcm[n] == -32768) {
+            clipped = true;
+            continue;
+        }
+        lowBits = lowBits || ((int32[n] & 0xffff) != 0);
+        maxError = max(maxError, abs((int32[n] >> 16) - pcm[n]));
+        maxError = max(maxError, (int) fabs(float32[n] * 32768.0f - pcm[n]));
+    }
+    ASSERT_LE(maxError, 8) << "32-bit output does not match the 16-bit output";
+    ASSERT_TRUE(lowBits) << "32-bit output was truncated to 16 bits";
+    ASSERT_TRUE(clipped) << "16-bit output never clips";
+    ASSERT_GT(peak, 1.0f) << "Float output was clipped";
+}
+
+TEST(SonivoxFormatTest, RenderMixTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource("ants.mid", &source)) << "Failed to read test file";
+
+    // instances 0 and 3 render floats and integers, 1, 2 and 4 add the same file to accumulators
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    const size_t bufferSize = config->mixBufferSize * config->numChannels;
+    EAS_DATA_HANDLE easData[5] = {nullptr, nullptr, nullptr, nullptr, nullptr};
+    for (int i = 0; i < 5; i++) {
+        ASSERT_EQ(EAS_Init(&easData[i]), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    }
+    vector<float> audio;
+    vector<float> floatMix;
+    vector<EAS_I32> intMix;
+    vector<EAS_I32> int32;
+    vector<EAS_I32> int32Mix;
+
+    EAS_I32 count;
+    vector<float> buffer(bufferSize);
+    ASSERT_EQ(EAS_RenderMix(easData[1], buffer.data(), EAS_FORMAT_FLOAT32, -1, config->mixBufferSize,
+                            &count), EAS_ERROR_PARAMETER_RANGE) << "Negative gain accepted";
+    ASSERT_EQ(EAS_RenderMix(easData[1], buffer.data(), EAS_FORMAT_FLOAT32, EAS_MIX_MAX_GAIN + 1,
+                            config->mixBufferSize, &count), EAS_ERROR_PARAMETER_RANGE) << "Gain too high accepted";
+    ASSERT_EQ(EAS_RenderMix(easData[1], buffer.data(), EAS_FORMAT_PCM16, EAS_MIX_UNITY_GAIN,
+                            config->mixBufferSize, &count), EAS_ERROR_PARAMETER_RANGE)
+            << "16-bit accumulator accepted";
+    ASSERT_EQ(EAS_RenderFormat(easData[1], buffer.data(), EAS_FORMAT_INT32_MIX, config->mixBufferSize, &count),
+              EAS_ERROR_PARAMETER_RANGE) << "Accumulator format accepted for output";
+
+    // what is already in the accumulators is kept, the render is added with the gain
+    ASSERT_EQ(renderStream(easData[0], &source, appendFormat(&audio, EAS_FORMAT_FLOAT32)), EAS_SUCCESS)
+            << "Failed to render floats";
+    ASSERT_EQ(renderStream(easData[1], &source, [&](EAS_DATA_HANDLE handle, EAS_HANDLE) {
+        floatMix.resize(floatMix.size() + bufferSize, 0.25f);
+        return EAS_RenderMix(handle, floatMix.data() + floatMix.size() - bufferSize, EAS_FORMAT_FLOAT32,
+                             EAS_MIX_UNITY_GAIN / 2, config->mixBufferSize, &count);
+    }), EAS_SUCCESS) << "Failed to mix floats";
+    ASSERT_EQ(renderStream(easData[2], &source, [&](EAS_DATA_HANDLE handle, EAS_HANDLE) {
+        intMix.resize(intMix.size() + bufferSize, -1000);
+        return EAS_RenderMix(handle, intMix.data() + intMix.size() - bufferSize, EAS_FORMAT_INT32_MIX,
+                             EAS_MIX_UNITY_GAIN, config->mixBufferSize, &count);
+    }), EAS_SUCCESS) << "Failed to mix integers";
+
+    // EAS_FORMAT_INT32 accumulates at the scale of EAS_RenderFormat and saturates
+    ASSERT_EQ(renderStream(easData[3], &source, appendFormat(&int32, EAS_FORMAT_INT32)), EAS_SUCCESS)
+            << "Failed to render 32-bit integers";
+    ASSERT_EQ(renderStream(easData[4], &source, [&](EAS_DATA_HANDLE handle, EAS_HANDLE) {
+        int32Mix.resize(int32Mix.size() + bufferSize, 0x40000000);
+        return EAS_RenderMix(handle, int32Mix.data() + int32Mix.size() - bufferSize, EAS_FORMAT_INT32,
+                             EAS_MIX_UNITY_GAIN, config->mixBufferSize, &count);
+    }), EAS_SUCCESS) << "Failed to mix 32-bit integers";
+    for (int i = 0; i < 5; i++) {
+        ASSERT_EQ(EAS_Shutdown(easData[i]), EAS_SUCCESS) << "Failed to shut down";
+    }
+    ASSERT_EQ(floatMix.size(), audio.size());
+    ASSERT_EQ(intMix.size(), audio.size());
+    ASSERT_EQ(int32Mix.size(), int32.size());
+
+    float floatError = 0;
+    int intError = 0;
+    bool heard = false;
+    for (size_t n = 0; n < audio.size(); n++) {
+        heard = heard || (audio[n] != 0);
+        floatError = max(floatError, fabs(floatMix[n] - (0.25f + audio[n] / 2)));
+        intError = max(intError, (int) fabs(intMix[n] - (-1000 + audio[n] * (1 << 23))));
+    }
+    ASSERT_TRUE(heard) << "Nothing was rendered";
+    ASSERT_LE(floatError, 1e-5f) << "Float accumulator does not hold the scaled render";
+    ASSERT_LE(intError, 2) << "Integer accumulator does not hold the scaled render";
+
+    // the output saturated at 32 bits is only known to be the sum when it did not saturate
+    bool saturated = false;
+    for (size_t n = 0; n < int32.size(); n++) {
+        saturated = saturated || (int32Mix[n] == INT32_MAX);
+        if ((int32[n] != INT32_MAX) && (int32[n] != INT32_MIN)) {
+            ASSERT_EQ(int32Mix[n], (EAS_I32) min<long long>(0x40000000LL + int32[n], INT32_MAX))
+                    << "32-bit accumulator does not hold the render at " << n;
+        }
+    }
+    ASSERT_TRUE(saturated) << "32-bit accumulator never saturates";
+}
+
+TEST(SonivoxFormatTest, RenderPlanarTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource("ants.mid", &source)) << "Failed to read test file";
+
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    ASSERT_EQ(config->numChannels, 2);
+    const EAS_I32 formats[] = {EAS_FORMAT_PCM16, EAS_FORMAT_INT32, EAS_FORMAT_FLOAT32};
+    const size_t sampleSizes[] = {sizeof(EAS_PCM), sizeof(EAS_I32), sizeof(float)};
+
+    // planar output holds the same samples as the interleaved output, in every format
+    for (int f = 0; f < 3; f++) {
+        const size_t frameSize = 2 * sampleSizes[f];
+        const size_t bufferSize = config->mixBufferSize * frameSize;
+        EAS_DATA_HANDLE easData[2] = {nullptr, nullptr};
+        for (int i = 0; i < 2; i++) {
+            ASSERT_EQ(EAS_Init(&easData[i]), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+        }
+        vector<uint8_t> interleaved;
+        vector<uint8_t> planar[2];
+
+        EAS_I32 count;
+        vector<uint8_t> buffer(bufferSize);
+        ASSERT_EQ(EAS_RenderPlanar(easData[1], buffer.data(), nullptr, formats[f], config->mixBufferSize,
+                                   &count), EAS_ERROR_INVALID_PARAMETER) << "Missing channel accepted";
+        ASSERT_EQ(renderStream(easData[0], &source, [&](EAS_DATA_HANDLE handle, EAS_HANDLE) {
+            EAS_RESULT result = EAS_RenderFormat(handle, buffer.data(), formats[f], config->mixBufferSize, &count);
+            interleaved.insert(interleaved.end(), buffer.begin(), buffer.begin() + count * frameSize);
+            return result;
+        }), EAS_SUCCESS) << "Failed to render interleaved audio";
+        ASSERT_EQ(renderStream(easData[1], &source, [&](EAS_DATA_HANDLE handle, EAS_HANDLE) {
+            uint8_t *pRight = buffer.data() + bufferSize / 2;
+            EAS_RESULT result = EAS_RenderPlanar(handle, buffer.data(), pRight, formats[f],
+                                                 config->mixBufferSize, &count);
+            planar[0].insert(planar[0].end(), buffer.data(), buffer.data() + count * frameSize / 2);
+            planar[1].insert(planar[1].end(), pRight, pRight + count * frameSize / 2);
+            return result;
+        }), EAS_SUCCESS) << "Failed to render planar audio";
+        for (int i = 0; i < 2; i++) {
+            ASSERT_EQ(EAS_Shutdown(easData[i]), EAS_SUCCESS) << "Failed to shut down";
+        }
+
+        const size_t sampleSize = sampleSizes[f];
+        ASSERT_EQ(planar[0].size() * 2, interleaved.size());
+        ASSERT_EQ(planar[1].size() * 2, interleaved.size());
+        bool heard = false;
+        for (size_t n = 0; n < interleaved.size() / frameSize; n++) {
+            for (int c = 0; c < 2; c++) {
+                const uint8_t *sample = &interleaved[(n * 2 + c) * sampleSize];
+                ASSERT_EQ(memcmp(sample, &planar[c][n * sampleSize], sampleSize), 0)
+                        << "Format " << formats[f] << " channel " << c << " differs at sample " << n;
+                heard = heard || any_of(sample, sample + sampleSize, [](uint8_t b) { return b != 0; });
+            }
+        }
+        ASSERT_TRUE(heard) << "Nothing was rendered";
+    }
+}
+
+TEST(SonivoxResamplerTest, OutputSampleRateTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource("ants.mid", &source)) << "Failed to read test file";
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+
+    // renders the whole file at a sample rate
+    auto renderFile = [&](EAS_I32 sampleRate, vector<EAS_PCM> &audio) {
+        EAS_DATA_HANDLE easData = nullptr;
+        ASSERT_EQ(EAS_Init(&easData), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+        ASSERT_EQ(EAS_SetOutputSampleRate(easData, sampleRate), EAS_SUCCESS) << "Failed to set " << sampleRate;
+        ASSERT_EQ(EAS_GetOutputSampleRate(easData), sampleRate);
+        ASSERT_EQ(renderStream(easData, &source, appendRender(&audio)), EAS_SUCCESS)
+                << "Failed to render at " << sampleRate;
+        ASSERT_EQ(EAS_Shutdown(easData), EAS_SUCCESS) << "Failed to shut down";
+    };
+
+    EAS_DATA_HANDLE easData = nullptr;
+    ASSERT_EQ(EAS_Init(&easData), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    ASSERT_EQ(EAS_GetOutputSampleRate(easData), config->sampleRate);
+    ASSERT_EQ(EAS_SetOutputSampleRate(easData, config->sampleRate - 1), EAS_ERROR_PARAMETER_RANGE);
+    ASSERT_EQ(EAS_SetOutputSampleRate(easData, EAS_MAX_OUTPUT_SAMPLE_RATE + 1), EAS_ERROR_PARAMETER_RANGE);
+    ASSERT_EQ(EAS_Shutdown(easData), EAS_SUCCESS) << "Failed to shut down";
+
+    vector<EAS_PCM> reference;
+    renderFile(config->sampleRate, reference);
+    ASSERT_FALSE(HasFatalFailure());
+    const size_t referenceFrames = reference.size() / config->numChannels;
+    // the resampled file lasts as long, and follows the reference interpolated to the same instants
+    for (EAS_I32 sampleRate : {48000, 96000}) {
+        vector<EAS_PCM> audio;
+        renderFile(sampleRate, audio);
+        ASSERT_FALSE(HasFatalFailure());
+        const double ratio = (double) config->sampleRate / sampleRate;
+        const size_t frames = audio.size() / config->numChannels;
+        ASSERT_NEAR(frames * ratio, referenceFrames, 2 * config->mixBufferSize) << "Wrong length at " << sampleRate;
+
+        double signal = 0;
+        double error = 0;
+        for (size_t n = 0; n < frames; n++) {
+            const double pos = n * ratio;
+            const size_t i = (size_t) pos;
+            if (i + 1 >= referenceFrames) {
+                break;
+            }
+            for (int c = 0; c < config->numChannels; c++) {
+                const double a = reference[i * config->numChannels + c];
+                const double b = reference[(i + 1) * config->numChannels + c];
+                const double expected = a + (b - a) * (pos - i);
+                signal += expected * expected;
+                error += (audio[n * config->numChannels + c] - expected) * (audio[n * config->numChannels + c] - expected);
+            }
+        }
+        ASSERT_GT(signal, 0) << "Nothing was rendered";
+        ASSERT_LT(error / signal, 0.01) << "Resampled output does not follow the reference at " << sampleRate;
+    }
+}
+
+TEST(SonivoxResamplerTest, FormatTest) {
+    MemorySource source;
+    ASSERT_TRUE(loadSource("ants.mid", &source)) << "Failed to read test file";
+
+    // the same file resampled as 16-bit, float, 32-bit integer, accumulated and planar samples
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    const size_t bufferSize = config->mixBufferSize * config->numChannels;
+    EAS_DATA_HANDLE easData[5] = {nullptr, nullptr, nullptr, nullptr, nullptr};
+    for (int i = 0; i < 5; i++) {
+        ASSERT_EQ(EAS_Init(&easData[i]), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+        ASSERT_EQ(EAS_SetOutputSampleRate(easData[i], 48000), EAS_SUCCESS) << "Failed to set 48000";
+    }
+    vector<EAS_PCM> pcm;
+    vector<float> float32;
+    vector<EAS_I32> int32;
+    vector<EAS_I32> intMix;
+    vector<float> planar[2];
+
+    // the stems are still only written at the compiled rate
+    EAS_I32 count;
+    vector<EAS_PCM> buffer(bufferSize);
+    vector<EAS_PCM> stem(bufferSize);
+    EAS_PCM *stems[] = {stem.data()};
+    ASSERT_EQ(EAS_SetStemBuses(easData[0], 1), EAS_SUCCESS) << "Failed to set the stem buses";
+    ASSERT_EQ(EAS_RenderStems(easData[0], buffer.data(), stems, config->mixBufferSize, &count),
+              EAS_ERROR_NOT_VALID_IN_THIS_STATE) << "Stems accepted at 48000";
+    ASSERT_EQ(EAS_SetStemBuses(easData[0], 0), EAS_SUCCESS) << "Failed to disable the stem buses";
+
+    ASSERT_EQ(renderStream(easData[0], &source, appendRender(&pcm)), EAS_SUCCESS) << "Failed to render audio";
+    ASSERT_EQ(renderStream(easData[1], &source, appendFormat(&float32, EAS_FORMAT_FLOAT32)), EAS_SUCCESS)
+            << "Failed to render floats";
+    ASSERT_EQ(renderStream(easData[2], &source, appendFormat(&int32, EAS_FORMAT_INT32)), EAS_SUCCESS)
+            << "Failed to render 32-bit integers";
+    ASSERT_EQ(renderStream(easData[3], &source, [&](EAS_DATA_HANDLE handle, EAS_HANDLE) {
+        intMix.resize(intMix.size() + bufferSize, -1000);
+        return EAS_RenderMix(handle, intMix.data() + intMix.size() - bufferSize, EAS_FORMAT_INT32_MIX,
+                             EAS_MIX_UNITY_GAIN, config->mixBufferSize, &count);
+    }), EAS_SUCCESS) << "Failed to mix integers";
+    ASSERT_EQ(renderStream(easData[4], &source, [&](EAS_DATA_HANDLE handle, EAS_HANDLE) {
+        for (int c = 0; c < 2; c++) {
+            planar[c].resize(planar[c].size() + config->mixBufferSize);
+        }
+        return EAS_RenderPlanar(handle, planar[0].data() + planar[0].size() - config->mixBufferSize,
+                                planar[1].data() + planar[1].size() - config->mixBufferSize,
+                                EAS_FORMAT_FLOAT32, config->mixBufferSize, &count);
+    }), EAS_SUCCESS) << "Failed to render planar floats";
+    for (int i = 0; i < 5; i++) {
+        ASSERT_EQ(EAS_Shutdown(easData[i]), EAS_SUCCESS) << "Failed to shut down";
+    }
+    ASSERT_EQ(float32.size(), pcm.size());
+    ASSERT_EQ(int32.size(), pcm.size());
+    ASSERT_EQ(intMix.size(), pcm.size());
+    ASSERT_EQ(planar[0].size() * 2, pcm.size());
+
+    // the formats follow the 16-bit output within rounding, keep the low order bits
+    // and, for floats, the peaks that are clipped at 16 bits; the 16-bit output is
+    // resampled from clipped input, so it is only compared away from the peaks
+    const size_t window = 16 * config->numChannels;
+    int maxError = 0;
+    int mixError = 0;
+    bool lowBits = false;
+    float peak = 0;
+    for (size_t n = 0; n < pcm.size(); n++) {
+        ASSERT_EQ(planar[n % 2][n / 2], float32[n]) << "Planar output differs at sample " << n;
+        peak = max(peak, fabs(float32[n]));
+        mixError = max(mixError, (int) fabs(intMix[n] - (-1000 + float32[n] * (1 << 23))));
+        if (any_of(float32.begin() + (n > window ? n - window : 0), float32.begin() + min(n + window, pcm.size()),
+                   [](float v) { return fabs(v) >= 0.9f; })) {
+            continue;
+        }
+        lowBits = lowBits || ((int32[n] & 0xffff) != 0);
+        maxError = max(maxError, abs((int32[n] >> 16) - pcm[n]));
+        maxError = max(maxError, (int) fabs(float32[n] * 32768.0f - pcm[n]));
+    }
+    ASSERT_LE(maxError, 4) << "Resampled formats do not match the 16-bit output";
+    ASSERT_LE(mixError, 2) << "Integer accumulator does not hold the resampled render";
+    ASSERT_TRUE(lowBits) << "32-bit output was truncated to 16 bits";
+    ASSERT_GT(peak, 1.0f) << "Float output was clipped";
+}
 
 int main(int argc, char **argv) {
     gEnv = new SonivoxTestEnvironment();